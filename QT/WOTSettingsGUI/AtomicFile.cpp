@@ -0,0 +1,146 @@
+#include "main.h" // Головний заголовок (містить оголошення AtomicFile)
+#include "pugixml/pugixml.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+#ifdef _WIN32
+#include <io.h>     // Для _commit, _fileno
+#else
+#include <fcntl.h>  // Для open (fsync директорії)
+#include <unistd.h> // Для fsync, close
+#endif
+
+namespace {
+
+// Унікальне ім'я тимчасового файлу в тій самій директорії (rename атомарний лише в межах одного тому)
+fs::path makeTempPath(const fs::path& target) {
+    static std::atomic<unsigned long long> counter{0};
+    const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    fs::path name = target.filename();
+    name += ".tmp-" + std::to_string(stamp) + "-" + std::to_string(++counter);
+    return target.parent_path() / name;
+}
+
+std::FILE* openForWrite(const fs::path& path) {
+#ifdef _WIN32
+    return _wfopen(path.wstring().c_str(), L"wb");
+#else
+    return std::fopen(path.c_str(), "wb");
+#endif
+}
+
+std::FILE* openForRead(const fs::path& path) {
+#ifdef _WIN32
+    return _wfopen(path.wstring().c_str(), L"rb");
+#else
+    return std::fopen(path.c_str(), "rb");
+#endif
+}
+
+// Скидає буфери ОС на диск: після повернення вміст переживе аварійне вимкнення
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// На POSIX сам rename стає стійким лише після fsync директорії. Помилка тут не критична:
+// файл уже цілісний, у гіршому разі після збою лишиться попередня версія.
+void syncDirectory(const fs::path& directory) {
+#ifndef _WIN32
+    int fd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+#else
+    (void)directory;
+#endif
+}
+
+void removeQuietly(const fs::path& path) {
+    std::error_code ec;
+    fs::remove(path, ec);
+}
+
+}
+
+void AtomicFile::write(const fs::path& target, const std::function<bool(std::FILE*)>& writeContent) {
+    TraceScope trace("AtomicFile::write");
+    const fs::path tempPath = makeTempPath(target);
+
+    std::FILE* file = openForWrite(tempPath);
+    if (!file) {
+        throw std::runtime_error("Не вдалося створити тимчасовий файл: " + tempPath.string());
+    }
+
+    bool ok = false;
+    try {
+        ok = writeContent(file) && !std::ferror(file) && syncFile(file);
+    } catch (...) {
+        std::fclose(file);
+        removeQuietly(tempPath);
+        throw;
+    }
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        removeQuietly(tempPath);
+        throw std::runtime_error("Помилка запису тимчасового файлу (можливо, диск заповнений): " + tempPath.string());
+    }
+
+    std::error_code ec;
+    // Новий файл отримує права цільового (як fs::copy_file з overwrite_existing)
+    const fs::file_status targetStatus = fs::status(target, ec);
+    if (!ec && fs::exists(targetStatus)) {
+        fs::permissions(tempPath, targetStatus.permissions(), ec);
+    }
+
+    fs::rename(tempPath, target, ec);
+    if (ec) {
+        removeQuietly(tempPath);
+        throw std::runtime_error("Не вдалося замінити файл " + target.string() + ": " + ec.message());
+    }
+    syncDirectory(target.parent_path());
+}
+
+void AtomicFile::writeBuffer(const fs::path& target, const char* data, std::size_t size) {
+    write(target, [&](std::FILE* file) {
+        return size == 0 || std::fwrite(data, 1, size, file) == size;
+    });
+}
+
+void AtomicFile::saveDocument(const fs::path& target, const pugi::xml_document& doc) {
+    write(target, [&](std::FILE* file) {
+        pugi::xml_writer_file writer(file);
+        doc.save(writer);
+        return true;
+    });
+}
+
+void AtomicFile::copy(const fs::path& source, const fs::path& target) {
+    std::FILE* in = openForRead(source);
+    if (!in) {
+        throw std::runtime_error("Не вдалося відкрити файл для копіювання: " + source.string());
+    }
+    try {
+        write(target, [&](std::FILE* out) {
+            std::vector<char> buffer(64 * 1024);
+            for (;;) {
+                std::size_t got = std::fread(buffer.data(), 1, buffer.size(), in);
+                if (got > 0 && std::fwrite(buffer.data(), 1, got, out) != got) return false;
+                if (got < buffer.size()) return !std::ferror(in);
+            }
+        });
+    } catch (...) {
+        std::fclose(in);
+        throw;
+    }
+    std::fclose(in);
+}
@@ -0,0 +1,579 @@
+#include "main.h" // Головний заголовок (містить оголошення BackupArchive)
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream> // Для std::cerr
+#include <stdexcept>
+#include <system_error>
+#include <vector>
+#ifdef _WIN32
+#include <io.h>     // Для _commit, _fileno
+#define NOMINMAX
+#include <windows.h> // Для GetFileInformationByHandle
+#else
+#include <sys/stat.h> // Для stat
+#include <unistd.h>   // Для fsync
+#endif
+
+// Формат архіву (усі числа little-endian):
+//   "WOTPACK1"
+//   блоки:  "BLK1" flags:u8 hash:32 rawSize:u32 storedSize:u32 crc32:u32 дані[storedSize]
+//   індекс: "IDX1" count:u32 { hash:32 flags:u8 offset:u64 rawSize:u32 storedSize:u32 } * count
+//   кінець: "WOTPEND1" indexOffset:u64 indexCrc32:u32
+// Новий блок записується на місце старого індексу, за ним - новий індекс і кінцівка.
+// Блоки самоописні: якщо кінцівка пошкоджена (збій посеред дописування), індекс
+// відновлюється послідовним проходом по блоках.
+
+namespace {
+
+const char kFileMagic[8] = {'W', 'O', 'T', 'P', 'A', 'C', 'K', '1'};
+const char kBlockMagic[4] = {'B', 'L', 'K', '1'};
+const char kIndexMagic[4] = {'I', 'D', 'X', '1'};
+const char kFooterMagic[8] = {'W', 'O', 'T', 'P', 'E', 'N', 'D', '1'};
+const std::size_t kBlockHeaderSize = 4 + 1 + 32 + 4 + 4 + 4;
+const std::size_t kIndexRecordSize = 32 + 1 + 8 + 4 + 4;
+const std::size_t kFooterSize = 8 + 8 + 4;
+const std::uint8_t kFlagCompressed = 0x02;
+
+// --- Числа у файлі ---
+void putU32(std::string& out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+void putU64(std::string& out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+std::uint32_t getU32(const char* p) {
+    std::uint32_t value = 0;
+    for (int i = 3; i >= 0; --i) value = (value << 8) | static_cast<unsigned char>(p[i]);
+    return value;
+}
+std::uint64_t getU64(const char* p) {
+    std::uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) value = (value << 8) | static_cast<unsigned char>(p[i]);
+    return value;
+}
+
+std::uint32_t crc32(const char* data, std::size_t size) {
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i) crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Хеш у файлі зберігається 32 байтами замість 64 hex-символів
+bool hexToBinary(const std::string& hex, std::string& out) {
+    if (hex.size() != 64) return false;
+    auto nibble = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        return -1;
+    };
+    out.resize(32);
+    for (std::size_t i = 0; i < 32; ++i) {
+        const int hi = nibble(hex[2 * i]), lo = nibble(hex[2 * i + 1]);
+        if (hi < 0 || lo < 0) return false;
+        out[i] = static_cast<char>((hi << 4) | lo);
+    }
+    return true;
+}
+std::string binaryToHex(const char* data) {
+    static const char digits[] = "0123456789abcdef";
+    std::string hex(64, '0');
+    for (std::size_t i = 0; i < 32; ++i) {
+        const unsigned char b = static_cast<unsigned char>(data[i]);
+        hex[2 * i] = digits[b >> 4];
+        hex[2 * i + 1] = digits[b & 0x0F];
+    }
+    return hex;
+}
+
+// --- LZ77-стиснення блоків (послідовності у стилі LZ4) ---
+// Послідовність: токен (старші 4 біти - довжина літералів, молодші - довжина збігу - 4),
+// продовження довжин байтами 255, літерали, зміщення збігу u16. Остання послідовність - лише літерали.
+// XML-конфіги з повторюваними тегами стискаються в кілька разів; розпаковка - один прохід без таблиць.
+const std::size_t kMinMatch = 4;
+const std::size_t kMaxOffset = 65535;
+const int kHashBits = 14;
+
+void putLength(std::string& out, std::size_t length) {
+    while (length >= 255) {
+        out += static_cast<char>(255);
+        length -= 255;
+    }
+    out += static_cast<char>(length);
+}
+
+std::string compressBlock(std::string_view input) {
+    std::string out;
+    out.reserve(input.size() / 2 + 16);
+    std::vector<std::uint32_t> table(std::size_t(1) << kHashBits, 0); // Позиція + 1; 0 - порожньо
+    auto hashAt = [&](std::size_t pos) {
+        std::uint32_t v;
+        std::memcpy(&v, input.data() + pos, 4);
+        return (v * 2654435761u) >> (32 - kHashBits);
+    };
+    auto emit = [&](std::size_t literalStart, std::size_t literalLength, std::size_t offset, std::size_t matchLength) {
+        const std::size_t litToken = std::min<std::size_t>(literalLength, 15);
+        const std::size_t matchToken = matchLength ? std::min<std::size_t>(matchLength - kMinMatch, 15) : 0;
+        out += static_cast<char>((litToken << 4) | matchToken);
+        if (literalLength >= 15) putLength(out, literalLength - 15);
+        out.append(input.substr(literalStart, literalLength));
+        if (matchLength == 0) return;
+        out += static_cast<char>(offset & 0xFF);
+        out += static_cast<char>(offset >> 8);
+        if (matchLength - kMinMatch >= 15) putLength(out, matchLength - kMinMatch - 15);
+    };
+
+    std::size_t anchor = 0, pos = 0;
+    while (input.size() >= kMinMatch && pos + kMinMatch <= input.size()) {
+        const std::uint32_t h = hashAt(pos);
+        const std::size_t candidate = table[h];
+        table[h] = static_cast<std::uint32_t>(pos + 1);
+        if (candidate == 0 || pos - (candidate - 1) > kMaxOffset ||
+            std::memcmp(input.data() + candidate - 1, input.data() + pos, kMinMatch) != 0) {
+            ++pos;
+            continue;
+        }
+        const std::size_t matchStart = candidate - 1;
+        std::size_t length = kMinMatch;
+        while (pos + length < input.size() && input[matchStart + length] == input[pos + length]) ++length;
+        emit(anchor, pos - anchor, pos - matchStart, length);
+        pos += length;
+        anchor = pos;
+    }
+    emit(anchor, input.size() - anchor, 0, 0);
+    return out;
+}
+
+std::size_t readLength(std::string_view in, std::size_t& pos, std::size_t initial) {
+    std::size_t length = initial;
+    if (initial != 15) return length;
+    for (;;) {
+        if (pos >= in.size()) throw std::runtime_error("Пошкоджений стиснений блок архіву резервних копій");
+        const unsigned char b = static_cast<unsigned char>(in[pos++]);
+        length += b;
+        if (b != 255) return length;
+    }
+}
+
+std::string decompressBlock(std::string_view in, std::size_t rawSize) {
+    std::string out;
+    out.reserve(rawSize);
+    std::size_t pos = 0;
+    while (pos < in.size()) {
+        const unsigned char token = static_cast<unsigned char>(in[pos++]);
+        const std::size_t literalLength = readLength(in, pos, token >> 4);
+        if (literalLength > in.size() - pos || out.size() + literalLength > rawSize) {
+            throw std::runtime_error("Пошкоджений стиснений блок архіву резервних копій");
+        }
+        out.append(in.substr(pos, literalLength));
+        pos += literalLength;
+        if (pos == in.size()) break; // Остання послідовність - лише літерали
+        if (in.size() - pos < 2) throw std::runtime_error("Пошкоджений стиснений блок архіву резервних копій");
+        const std::size_t offset = static_cast<unsigned char>(in[pos]) | (std::size_t(static_cast<unsigned char>(in[pos + 1])) << 8);
+        pos += 2;
+        const std::size_t matchLength = readLength(in, pos, token & 0x0F) + kMinMatch;
+        if (offset == 0 || offset > out.size() || out.size() + matchLength > rawSize) {
+            throw std::runtime_error("Пошкоджений стиснений блок архіву резервних копій");
+        }
+        // Збіг може перекривати сам себе (offset < matchLength) - копіюється побайтово
+        const std::size_t from = out.size() - offset;
+        for (std::size_t i = 0; i < matchLength; ++i) out += out[from + i];
+    }
+    if (out.size() != rawSize) throw std::runtime_error("Пошкоджений стиснений блок архіву резервних копій");
+    return out;
+}
+
+std::FILE* openFile(const fs::path& path, const char* mode) {
+#ifdef _WIN32
+    std::wstring wideMode(mode, mode + std::strlen(mode));
+    return _wfopen(path.wstring().c_str(), wideMode.c_str());
+#else
+    return std::fopen(path.c_str(), mode);
+#endif
+}
+
+bool seekTo(std::FILE* file, std::uint64_t offset) {
+#ifdef _WIN32
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+}
+
+bool readExact(std::FILE* file, char* data, std::size_t size) {
+    return size == 0 || std::fread(data, 1, size, file) == size;
+}
+
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Ідентичність файлу (inode / індекс файлу NTFS); 0 - невідома. Ущільнення замінює архів новим
+// файлом, тож розмір і час зміни можуть збігтися зі старими, а ідентичність - ні.
+std::uint64_t fileIdentity(const fs::path& path) {
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(path.wstring().c_str(), FILE_READ_ATTRIBUTES,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return 0;
+    BY_HANDLE_FILE_INFORMATION info;
+    const bool ok = GetFileInformationByHandle(handle, &info) != 0;
+    CloseHandle(handle);
+    return ok ? (std::uint64_t(info.nFileIndexHigh) << 32) | info.nFileIndexLow : 0;
+#else
+    struct stat status;
+    return stat(path.c_str(), &status) == 0 ? static_cast<std::uint64_t>(status.st_ino) : 0;
+#endif
+}
+
+struct FileCloser {
+    void operator()(std::FILE* file) const { if (file) std::fclose(file); }
+};
+using FilePtr = std::unique_ptr<std::FILE, FileCloser>;
+
+}
+
+BackupArchive::BackupArchive(fs::path path) : m_path(std::move(path)), m_lockPath(m_path) {
+    m_lockPath += ".lock";
+}
+
+std::uint64_t BackupArchive::blockSize(const Block& block) {
+    return kBlockHeaderSize + block.storedSize;
+}
+
+std::string BackupArchive::serializeIndexLocked() const {
+    // Порядок записів - за зміщенням, щоб послідовні читання йшли вперед по файлу
+    std::vector<std::pair<std::string, const Block*>> blocks;
+    blocks.reserve(m_blocks.size());
+    for (const auto& item : m_blocks) blocks.emplace_back(item.first, &item.second);
+    std::sort(blocks.begin(), blocks.end(), [](const auto& a, const auto& b) { return a.second->offset < b.second->offset; });
+
+    std::string index(kIndexMagic, sizeof(kIndexMagic));
+    putU32(index, static_cast<std::uint32_t>(blocks.size()));
+    std::string binaryHash;
+    for (const auto& item : blocks) {
+        hexToBinary(item.first, binaryHash);
+        index += binaryHash;
+        index += static_cast<char>(item.second->flags);
+        putU64(index, item.second->offset);
+        putU32(index, item.second->rawSize);
+        putU32(index, item.second->storedSize);
+    }
+    return index;
+}
+
+std::string BackupArchive::serializeFooter(std::uint64_t indexOffset, const std::string& index) {
+    std::string footer(kFooterMagic, sizeof(kFooterMagic));
+    putU64(footer, indexOffset);
+    putU32(footer, crc32(index.data(), index.size()));
+    return footer;
+}
+
+// Перечитує індекс, лише якщо файл змінився з часу останнього читання/запису (зокрема іншим екземпляром
+// чи процесом) або його замінило ущільнення. Викликається під FileLock архіву.
+void BackupArchive::refreshLocked() {
+    std::error_code ec;
+    const std::uintmax_t size = fs::file_size(m_path, ec);
+    if (ec || size < sizeof(kFileMagic)) { // Архіву ще немає (або порожній файл)
+        m_blocks.clear();
+        m_dataEnd = sizeof(kFileMagic);
+        m_deadBytes = 0;
+        m_loadedSize = 0;
+        m_loadedTime = fs::file_time_type();
+        m_loadedIdentity = 0;
+        return;
+    }
+    const fs::file_time_type time = fs::last_write_time(m_path, ec);
+    const std::uint64_t identity = fileIdentity(m_path);
+    if (size == m_loadedSize && time == m_loadedTime && identity == m_loadedIdentity) return;
+
+    FilePtr file(openFile(m_path, "rb"));
+    if (!file) throw std::runtime_error("Не вдалося відкрити архів резервних копій: " + m_path.string());
+    if (!loadIndexLocked(file.get(), size)) recoverLocked(file.get(), size);
+
+    std::uint64_t liveBytes = 0;
+    for (const auto& item : m_blocks) liveBytes += blockSize(item.second);
+    m_deadBytes = m_dataEnd - sizeof(kFileMagic) - std::min<std::uint64_t>(liveBytes, m_dataEnd - sizeof(kFileMagic));
+    m_loadedSize = size;
+    m_loadedTime = time;
+    m_loadedIdentity = identity;
+}
+
+// Швидкий шлях: кінцівка -> індекс. Повертає false, якщо кінцівка чи індекс пошкоджені.
+bool BackupArchive::loadIndexLocked(std::FILE* file, std::uintmax_t size) {
+    char magic[sizeof(kFileMagic)];
+    if (size < sizeof(kFileMagic) + kFooterSize || !readExact(file, magic, sizeof(magic)) ||
+        std::memcmp(magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+        return false;
+    }
+    char footer[kFooterSize];
+    if (!seekTo(file, size - kFooterSize) || !readExact(file, footer, kFooterSize) ||
+        std::memcmp(footer, kFooterMagic, sizeof(kFooterMagic)) != 0) {
+        return false;
+    }
+    const std::uint64_t indexOffset = getU64(footer + 8);
+    if (indexOffset < sizeof(kFileMagic) || indexOffset > size - kFooterSize) return false;
+    std::string index(static_cast<std::size_t>(size - kFooterSize - indexOffset), '\0');
+    if (!seekTo(file, indexOffset) || !readExact(file, &index[0], index.size()) ||
+        crc32(index.data(), index.size()) != getU32(footer + 16) || index.size() < 8 ||
+        std::memcmp(index.data(), kIndexMagic, sizeof(kIndexMagic)) != 0) {
+        return false;
+    }
+    const std::uint32_t count = getU32(index.data() + 4);
+    if (index.size() != 8 + std::size_t(count) * kIndexRecordSize) return false;
+
+    m_blocks.clear();
+    m_blocks.reserve(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        const char* record = index.data() + 8 + std::size_t(i) * kIndexRecordSize;
+        Block block;
+        block.flags = static_cast<std::uint8_t>(record[32]);
+        block.offset = getU64(record + 33);
+        block.rawSize = getU32(record + 41);
+        block.storedSize = getU32(record + 45);
+        if (block.offset + blockSize(block) > indexOffset) return false;
+        m_blocks.emplace(binaryToHex(record), block);
+    }
+    m_dataEnd = indexOffset;
+    return true;
+}
+
+// Повільний шлях після збою: послідовний прохід по блоках до першого неповного чи пошкодженого
+void BackupArchive::recoverLocked(std::FILE* file, std::uintmax_t size) {
+    m_blocks.clear();
+    m_dataEnd = sizeof(kFileMagic);
+    char magic[sizeof(kFileMagic)];
+    if (!seekTo(file, 0) || !readExact(file, magic, sizeof(magic)) || std::memcmp(magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+        throw std::runtime_error("Файл не є архівом резервних копій: " + m_path.string());
+    }
+    std::uint64_t offset = sizeof(kFileMagic);
+    std::string stored;
+    char header[kBlockHeaderSize];
+    while (offset + kBlockHeaderSize <= size) {
+        if (!seekTo(file, offset) || !readExact(file, header, kBlockHeaderSize) ||
+            std::memcmp(header, kBlockMagic, sizeof(kBlockMagic)) != 0) {
+            break;
+        }
+        Block block;
+        block.flags = static_cast<std::uint8_t>(header[4]);
+        block.offset = offset;
+        block.rawSize = getU32(header + 37);
+        block.storedSize = getU32(header + 41);
+        if (offset + blockSize(block) > size) break;
+        stored.resize(block.storedSize);
+        if (!readExact(file, &stored[0], stored.size()) || crc32(stored.data(), stored.size()) != getU32(header + 45)) break;
+        m_blocks[binaryToHex(header + 5)] = block; // Пізніша копія того самого вмісту замінює ранішу
+        offset += blockSize(block);
+    }
+    m_dataEnd = offset;
+}
+
+bool BackupArchive::contains(const std::string& hash) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FileLock fileLock(m_lockPath, FileLock::Mode::Shared);
+    refreshLocked();
+    return m_blocks.count(hash) > 0;
+}
+
+void BackupArchive::append(const std::string& hash, std::uint8_t kind, std::string_view payload) {
+    std::string binaryHash;
+    if (!hexToBinary(hash, binaryHash)) throw std::runtime_error("Некоректний хеш блоку архіву: " + hash);
+    if (payload.size() > 0xFFFFFFFFu) throw std::runtime_error("Резервна копія завелика для архіву: " + hash);
+
+    // Стиснення лише якщо воно щось дає: інакше блок зберігається як є
+    std::string compressed = compressBlock(payload);
+    const bool useCompressed = compressed.size() < payload.size();
+    const std::string_view stored = useCompressed ? std::string_view(compressed) : payload;
+
+    Block block;
+    block.flags = static_cast<std::uint8_t>((kind & kKindMask) | (useCompressed ? kFlagCompressed : 0));
+    block.rawSize = static_cast<std::uint32_t>(payload.size());
+    block.storedSize = static_cast<std::uint32_t>(stored.size());
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FileLock fileLock(m_lockPath, FileLock::Mode::Exclusive);
+    refreshLocked();
+    if (m_blocks.count(hash) > 0) return;
+    block.offset = m_dataEnd;
+
+    std::string data(kBlockMagic, sizeof(kBlockMagic));
+    data += static_cast<char>(block.flags);
+    data += binaryHash;
+    putU32(data, block.rawSize);
+    putU32(data, block.storedSize);
+    putU32(data, crc32(stored.data(), stored.size()));
+    data.append(stored);
+
+    m_blocks.emplace(hash, block);
+    const std::uint64_t indexOffset = m_dataEnd + data.size();
+    const std::string index = serializeIndexLocked();
+    data += index;
+    data += serializeFooter(indexOffset, index);
+
+    std::error_code ec;
+    const std::uintmax_t oldSize = fs::file_size(m_path, ec);
+    const bool fresh = ec || oldSize < sizeof(kFileMagic);
+    FilePtr file(openFile(m_path, fresh ? "w+b" : "r+b"));
+    bool ok = static_cast<bool>(file);
+    if (ok && fresh) ok = std::fwrite(kFileMagic, 1, sizeof(kFileMagic), file.get()) == sizeof(kFileMagic);
+    // Новий блок перекриває старий індекс
+    ok = ok && seekTo(file.get(), block.offset) && std::fwrite(data.data(), 1, data.size(), file.get()) == data.size() &&
+         syncFile(file.get());
+    file.reset();
+    // Після відновлення за збоєм за даними може лишитися довший недописаний хвіст
+    if (ok && !fresh && oldSize > indexOffset + index.size() + kFooterSize) {
+        fs::resize_file(m_path, indexOffset + index.size() + kFooterSize, ec);
+        ok = !ec;
+    }
+    if (!ok) {
+        m_blocks.erase(hash);
+        m_loadedSize = 0; // Стан файлу невідомий - наступний виклик перечитає його
+        throw std::runtime_error("Не вдалося дописати архів резервних копій (можливо, диск заповнений): " + m_path.string());
+    }
+    m_dataEnd = indexOffset;
+    m_loadedSize = fs::file_size(m_path, ec);
+    m_loadedTime = fs::last_write_time(m_path, ec);
+    m_loadedIdentity = fileIdentity(m_path);
+}
+
+// Один пошук у файлі і одна розпаковка. Спільний замок утримується до кінця читання:
+// ущільнення в іншому процесі не замінить файл між пошуком у індексі і читанням блоку.
+bool BackupArchive::read(const std::string& hash, std::uint8_t& kind, std::string& payload) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    FileLock fileLock(m_lockPath, FileLock::Mode::Shared);
+    refreshLocked();
+    auto it = m_blocks.find(hash);
+    if (it == m_blocks.end()) return false;
+    const Block block = it->second;
+    lock.unlock(); // Читання блоку не потребує стану в пам'яті
+
+    FilePtr file(openFile(m_path, "rb"));
+    std::string data(blockSize(block), '\0');
+    if (!file || !seekTo(file.get(), block.offset) || !readExact(file.get(), &data[0], data.size()) ||
+        std::memcmp(data.data(), kBlockMagic, sizeof(kBlockMagic)) != 0) {
+        throw std::runtime_error("Не вдалося прочитати блок архіву резервних копій: " + hash);
+    }
+    const std::string_view stored = std::string_view(data).substr(kBlockHeaderSize);
+    if (crc32(stored.data(), stored.size()) != getU32(data.data() + 45)) {
+        throw std::runtime_error("Блок архіву резервних копій пошкоджено: " + hash);
+    }
+    payload = (block.flags & kFlagCompressed) ? decompressBlock(stored, block.rawSize) : std::string(stored);
+    kind = block.flags & kKindMask;
+    return true;
+}
+
+// Блоки лише вилучаються з індексу; місце повертається ущільненням, коли мертві блоки
+// займають понад половину даних - тоді архів переписується атомарно без них
+std::uint64_t BackupArchive::remove(const std::vector<std::string>& hashes) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FileLock fileLock(m_lockPath, FileLock::Mode::Exclusive);
+    refreshLocked();
+    std::uint64_t removedBytes = 0;
+    for (const std::string& hash : hashes) {
+        auto it = m_blocks.find(hash);
+        if (it == m_blocks.end()) continue;
+        removedBytes += blockSize(it->second);
+        m_blocks.erase(it);
+    }
+    if (removedBytes == 0) return 0;
+    m_deadBytes += removedBytes;
+
+    if (m_deadBytes * 2 > m_dataEnd) {
+        try {
+            compactLocked();
+            return removedBytes;
+        } catch (const std::runtime_error& e) {
+            // Ущільнення лише повертає місце: без нього новий індекс дописується в наявний файл
+            std::cerr << "Warning: Backup archive compaction failed: " << e.what() << std::endl;
+        }
+    }
+
+    const std::string index = serializeIndexLocked();
+    const std::string tail = index + serializeFooter(m_dataEnd, index);
+    FilePtr file(openFile(m_path, "r+b"));
+    bool ok = file && seekTo(file.get(), m_dataEnd) && std::fwrite(tail.data(), 1, tail.size(), file.get()) == tail.size() &&
+              syncFile(file.get());
+    file.reset();
+    std::error_code ec;
+    // Новий індекс коротший за старий - хвіст старого обрізається
+    if (ok) fs::resize_file(m_path, m_dataEnd + tail.size(), ec);
+    m_loadedSize = 0;
+    if (!ok || ec) {
+        throw std::runtime_error("Не вдалося оновити індекс архіву резервних копій: " + m_path.string());
+    }
+    refreshLocked();
+    return removedBytes;
+}
+
+// Живі блоки спершу читаються в пам'ять, і архів закривається до заміни: на Windows файл, відкритий
+// через _wfopen, не можна замінити rename. Після будь-якої помилки індекс перечитується з диска.
+void BackupArchive::compactLocked() {
+    try {
+        std::vector<std::pair<std::string, Block*>> blocks;
+        blocks.reserve(m_blocks.size());
+        for (auto& item : m_blocks) blocks.emplace_back(item.first, &item.second);
+        std::sort(blocks.begin(), blocks.end(), [](const auto& a, const auto& b) { return a.second->offset < b.second->offset; });
+
+        std::unordered_map<std::string, Block> compacted;
+        compacted.reserve(blocks.size());
+        std::string content(kFileMagic, sizeof(kFileMagic));
+        {
+            FilePtr in(openFile(m_path, "rb"));
+            if (!in) throw std::runtime_error("Не вдалося відкрити архів резервних копій: " + m_path.string());
+            for (const auto& item : blocks) {
+                // Блоки копіюються як є, без повторного стиснення
+                const std::size_t offset = content.size();
+                content.resize(offset + blockSize(*item.second));
+                if (!seekTo(in.get(), item.second->offset) || !readExact(in.get(), &content[offset], content.size() - offset)) {
+                    throw std::runtime_error("Не вдалося прочитати блок архіву резервних копій: " + m_path.string());
+                }
+                Block moved = *item.second;
+                moved.offset = offset;
+                compacted.emplace(item.first, moved);
+            }
+        }
+
+        m_blocks.swap(compacted);
+        const std::string index = serializeIndexLocked();
+        m_blocks.swap(compacted);
+        const std::uint64_t dataEnd = content.size();
+        content += index;
+        content += serializeFooter(dataEnd, index);
+        AtomicFile::writeBuffer(m_path, content.data(), content.size());
+    } catch (const std::runtime_error&) {
+        m_loadedSize = 0;
+        throw;
+    }
+    m_loadedSize = 0;
+    refreshLocked();
+}
+
+BackupArchive::Stats BackupArchive::stats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FileLock fileLock(m_lockPath, FileLock::Mode::Shared);
+    refreshLocked();
+    Stats stats;
+    stats.blocks = m_blocks.size();
+    stats.fileBytes = m_loadedSize;
+    stats.deadBytes = m_deadBytes;
+    for (const auto& item : m_blocks) {
+        stats.rawBytes += item.second.rawSize;
+        stats.storedBytes += item.second.storedSize;
+        stats.blockBytes += blockSize(item.second);
+    }
+    return stats;
+}
@@ -0,0 +1,146 @@
+#include "main.h" // Головний заголовок (містить оголошення BackupDelta)
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Line {
+    std::size_t offset;
+    std::size_t length; // Разом з '\n'
+};
+
+std::vector<Line> splitLines(std::string_view text) {
+    std::vector<Line> lines;
+    std::size_t start = 0;
+    while (start < text.size()) {
+        std::size_t end = text.find('\n', start);
+        end = (end == std::string_view::npos) ? text.size() : end + 1;
+        lines.push_back({start, end - start});
+        start = end;
+    }
+    return lines;
+}
+
+// Копія з іншого місця бази коротша за цей поріг дорожча за сам рядок у дельті
+const std::size_t kMinJumpCopy = 16;
+
+void appendNumber(std::string& out, std::size_t value) {
+    char buffer[24];
+    auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, result.ptr);
+}
+
+std::size_t readNumber(std::string_view delta, std::size_t& pos, char terminator) {
+    std::size_t value = 0;
+    auto result = std::from_chars(delta.data() + pos, delta.data() + delta.size(), value);
+    if (result.ec != std::errc() || result.ptr == delta.data() + delta.size() || *result.ptr != terminator) {
+        throw std::runtime_error("Пошкоджена дельта резервної копії");
+    }
+    pos = static_cast<std::size_t>(result.ptr - delta.data()) + 1;
+    return value;
+}
+
+}
+
+// Жадібне зіставлення рядків: поки рядки збігаються з очікуваною позицією в базі, копія
+// подовжується; інакше шукається найближче входження рядка не раніше цієї позиції.
+// Для конфігів, що відрізняються кількома значеннями, дельта - кілька десятків байтів.
+std::string BackupDelta::encode(std::string_view base, std::string_view target) {
+    const std::vector<Line> baseLines = splitLines(base);
+    std::unordered_map<std::string_view, std::vector<std::size_t>> positions;
+    positions.reserve(baseLines.size());
+    for (std::size_t i = 0; i < baseLines.size(); ++i) {
+        positions[base.substr(baseLines[i].offset, baseLines[i].length)].push_back(i);
+    }
+
+    std::string out;
+    std::size_t copyOffset = 0, copyLength = 0;
+    std::size_t literalOffset = 0, literalLength = 0;
+    auto flushCopy = [&]() {
+        if (copyLength == 0) return;
+        out += 'C';
+        appendNumber(out, copyOffset);
+        out += ' ';
+        appendNumber(out, copyLength);
+        out += '\n';
+        copyLength = 0;
+    };
+    auto flushLiteral = [&]() {
+        if (literalLength == 0) return;
+        out += 'I';
+        appendNumber(out, literalLength);
+        out += '\n';
+        out.append(target.substr(literalOffset, literalLength));
+        literalLength = 0;
+    };
+
+    std::size_t expected = 0; // Рядок бази, наступний за останнім скопійованим
+    std::size_t targetOffset = 0;
+    while (targetOffset < target.size()) {
+        std::size_t end = target.find('\n', targetOffset);
+        end = (end == std::string_view::npos) ? target.size() : end + 1;
+        const std::string_view line = target.substr(targetOffset, end - targetOffset);
+
+        std::size_t match = baseLines.size();
+        if (expected < baseLines.size() && base.substr(baseLines[expected].offset, baseLines[expected].length) == line) {
+            match = expected;
+        } else if (line.size() >= kMinJumpCopy) {
+            auto it = positions.find(line);
+            if (it != positions.end()) {
+                const auto& candidates = it->second;
+                auto next = std::lower_bound(candidates.begin(), candidates.end(), expected);
+                match = (next != candidates.end()) ? *next : candidates.back();
+            }
+        }
+
+        if (match < baseLines.size()) {
+            flushLiteral();
+            const Line& baseLine = baseLines[match];
+            if (copyLength > 0 && copyOffset + copyLength == baseLine.offset) {
+                copyLength += baseLine.length;
+            } else {
+                flushCopy();
+                copyOffset = baseLine.offset;
+                copyLength = baseLine.length;
+            }
+            expected = match + 1;
+        } else {
+            flushCopy();
+            if (literalLength == 0) literalOffset = targetOffset;
+            literalLength += line.size();
+        }
+        targetOffset = end;
+    }
+    flushCopy();
+    flushLiteral();
+    return out;
+}
+
+std::string BackupDelta::apply(std::string_view base, std::string_view delta) {
+    std::string out;
+    std::size_t pos = 0;
+    while (pos < delta.size()) {
+        const char op = delta[pos++];
+        if (op == 'C') {
+            const std::size_t offset = readNumber(delta, pos, ' ');
+            const std::size_t length = readNumber(delta, pos, '\n');
+            if (offset > base.size() || length > base.size() - offset) {
+                throw std::runtime_error("Дельта резервної копії посилається за межі бази");
+            }
+            out.append(base.substr(offset, length));
+        } else if (op == 'I') {
+            const std::size_t length = readNumber(delta, pos, '\n');
+            if (length > delta.size() - pos) {
+                throw std::runtime_error("Пошкоджена дельта резервної копії");
+            }
+            out.append(delta.substr(pos, length));
+            pos += length;
+        } else {
+            throw std::runtime_error("Пошкоджена дельта резервної копії");
+        }
+    }
+    return out;
+}
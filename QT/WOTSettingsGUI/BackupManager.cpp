@@ -23,8 +23,9 @@ fs::path BackupManager::getGameConfigPath() {
     return appDataDir / "Wargaming.net" / "WorldOfTanks" / "preferences.xml";
 }
 
-// Повертає шлях до створеного бекапу або кидає виняток
-fs::path BackupManager::createBackup() {
+// Повертає запис сховища для створеної копії або кидає виняток
+BackupEntry BackupManager::createBackup() {
+    TraceScope trace("BackupManager::createBackup");
     fs::path sourcePath = getGameConfigPath();
 
     if (!fs::exists(sourcePath)) {
@@ -46,26 +47,68 @@ fs::path BackupManager::createBackup() {
     std::stringstream ss;
     ss << "preferences_" << std::put_time(&local_tm, "%Y_%m_%d_%H%M%S") << ".xml";
 
-    // Отримуємо поточний шлях виконуваного файлу для формування відносних шляхів
-    fs::path currentExecutablePath = fs::current_path(); // або QCoreApplication::applicationDirPath() якщо використовуєте Qt
-    fs::path backupDir = currentExecutablePath / "Restored Configs";
-    fs::path backupPath = backupDir / ss.str();
-
+    // Сховище зберігає кожен унікальний вміст один раз: копія незміненого файлу - лише запис в індексі
     try {
-        if (!fs::exists(backupDir)) {
-            fs::create_directories(backupDir);
-        }
-        fs::copy_file(sourcePath, backupPath, fs::copy_options::overwrite_existing);
-        return backupPath;
+        return m_store.add(sourcePath, static_cast<std::int64_t>(in_time_t), ss.str());
     } catch (const fs::filesystem_error& e) {
         throw std::runtime_error(std::string("Помилка файлової системи при створенні резервної копії: ") + e.what());
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string("Помилка запису резервної копії: ") + e.what());
     } catch (...) {
         throw std::runtime_error("Невідома помилка під час створення резервної копії.");
     }
 }
 
+std::vector<BackupEntry> BackupManager::listBackups() {
+    return m_store.list();
+}
+
+void BackupManager::restoreBackup(const BackupEntry& entry) {
+    TraceScope trace("BackupManager::restoreBackup");
+    // Вміст запису (з дельт відновлюється повна версія) перевіряється так само, як окремі копії:
+    // спершу у тимчасовий файл поруч зі сховищем, потім валідація і атомарна заміна preferences.xml
+    std::string content;
+    try {
+        content = m_store.read(entry); // Перевіряє хеш
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string("Помилка читання резервної копії: ") + e.what());
+    }
+    const fs::path stagedPath = m_store.directory() / ("restore-" + std::to_string(entry.id) + ".xml");
+    try {
+        AtomicFile::writeBuffer(stagedPath, content.data(), content.size());
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string("Помилка підготовки резервної копії до відновлення: ") + e.what());
+    }
+
+    std::error_code ec;
+    if (!m_validator.validateBeforeAction(stagedPath, "Відновлення з резервної копії (перевірка джерела)", true)) {
+        fs::remove(stagedPath, ec);
+        throw std::runtime_error("Перевірка резервної копії перед відновленням не пройдена або скасована.");
+    }
+
+    fs::path targetPath = getGameConfigPath();
+    try {
+        if (!fs::exists(targetPath.parent_path())) {
+            fs::create_directories(targetPath.parent_path());
+        }
+        AtomicFile::copy(stagedPath, targetPath);
+    } catch (const fs::filesystem_error& e) {
+        fs::remove(stagedPath, ec);
+        throw std::runtime_error(std::string("Помилка файлової системи при відновленні з копії: ") + e.what());
+    } catch (const std::runtime_error& e) {
+        fs::remove(stagedPath, ec);
+        throw std::runtime_error(std::string("Помилка відновлення з копії: ") + e.what());
+    }
+    fs::remove(stagedPath, ec);
+}
+
+void BackupManager::setDeltaStorage(unsigned keyframeInterval) {
+    m_store.setKeyframeInterval(keyframeInterval);
+}
+
 // Приймає шлях до файлу бекапу, кидає виняток при помилці
 void BackupManager::restoreFromBackup(const fs::path& backupPath) {
+    TraceScope trace("BackupManager::restoreFromBackup");
     if (!fs::exists(backupPath)) {
         throw std::runtime_error("Обраний файл резервної копії не знайдено: " + backupPath.string());
     }
@@ -82,26 +125,24 @@ void BackupManager::restoreFromBackup(const fs::path& backupPath) {
             fs::create_directories(targetDir);
         }
 
-        if (fs::exists(targetPath)) {
-            try {
-                fs::remove(targetPath);
-                // std::cerr << "Successfully removed existing preferences.xml before restoration." << std::endl;
-            } catch (const fs::filesystem_error& e) {
-                // Якщо не вдалося видалити, це вже проблема з дозволами/блокуванням
-                throw std::runtime_error(std::string("Помилка файлової системи: не вдалося видалити існуючий файл preferences.xml перед відновленням. ") + e.what());
-            }
-        }
-
-        // Використовуємо overwrite_existing на випадок, якщо remove не спрацював з невідомих причин
-        // або файл був створений між remove та copy_file.
-        fs::copy_file(backupPath, targetPath, fs::copy_options::overwrite_existing);
+        // Атомарна заміна: поточний preferences.xml лишається цілим, доки копія не записана повністю
+        AtomicFile::copy(backupPath, targetPath);
     } catch (const fs::filesystem_error& e) {
         throw std::runtime_error(std::string("Помилка файлової системи при відновленні з копії: ") + e.what());
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string("Помилка запису під час відновлення з копії: ") + e.what());
     } catch (...) {
         throw std::runtime_error("Невідома помилка під час відновлення з копії.");
     }
 }
 
-void BackupManager::manageBackupSpace() {
-    // Тут може бути логіка для видалення старих бекапів.
+RetentionReport BackupManager::manageBackupSpace(const RetentionPolicy& policy) {
+    const auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    try {
+        return m_store.prune(policy, static_cast<std::int64_t>(now));
+    } catch (const fs::filesystem_error& e) {
+        throw std::runtime_error(std::string("Помилка файлової системи при очищенні резервних копій: ") + e.what());
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string("Помилка очищення резервних копій: ") + e.what());
+    }
 }
@@ -0,0 +1,558 @@
+#include "main.h" // Головний заголовок (містить оголошення BackupStore та BackupEntry)
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_set>
+
+namespace {
+
+const char* const kIndexFileName = "backups.idx";
+const char* const kArchiveFileName = "backups.pack";
+const char* const kLockFileName = "backups.lock"; // Замок сховища між процесами (FileLock)
+const char* const kObjectsDirName = "objects"; // Окремі файли об'єктів сховищ, створених до появи архіву
+const std::uint8_t kKindFull = 0;
+const std::uint8_t kKindDelta = 1;
+const char* const kDeltaMagic = "WOTDELTA1";
+// Межа глибини ланцюжка при читанні. Не залежить від поточного інтервалу ключових кадрів: ланцюжки,
+// записані з більшим інтервалом, лишаються читабельними після його зменшення або вимкнення дельт.
+const unsigned kMaxDeltaDepth = 4096;
+const char* const kObjectLinePrefix = "#obj\t";
+const char* const kGenerationLinePrefix = "#gen\t";
+
+// --- SHA-256 (FIPS 180-4) для адресації вмісту ---
+class Sha256 {
+public:
+    Sha256() { m_state = {0x6a09e667u, 0xbb67ae85u, 0x3c6ef372u, 0xa54ff53au, 0x510e527fu, 0x9b05688cu, 0x1f83d9abu, 0x5be0cd19u}; }
+
+    void update(const unsigned char* data, std::size_t size) {
+        m_totalBytes += size;
+        if (m_bufferSize > 0) {
+            std::size_t take = std::min(size, m_buffer.size() - m_bufferSize);
+            std::memcpy(m_buffer.data() + m_bufferSize, data, take);
+            m_bufferSize += take;
+            data += take;
+            size -= take;
+            if (m_bufferSize < m_buffer.size()) return;
+            transform(m_buffer.data());
+            m_bufferSize = 0;
+        }
+        for (; size >= 64; data += 64, size -= 64) transform(data);
+        std::memcpy(m_buffer.data(), data, size);
+        m_bufferSize = size;
+    }
+
+    std::string hexDigest() {
+        const std::uint64_t bitLength = m_totalBytes * 8;
+        const unsigned char pad = 0x80;
+        const unsigned char zero = 0x00;
+        update(&pad, 1);
+        while (m_bufferSize != 56) update(&zero, 1);
+        unsigned char lengthBytes[8];
+        for (int i = 0; i < 8; ++i) lengthBytes[i] = static_cast<unsigned char>(bitLength >> (56 - 8 * i));
+        update(lengthBytes, 8);
+
+        static const char* const kHex = "0123456789abcdef";
+        std::string hex;
+        hex.reserve(64);
+        for (std::uint32_t word : m_state) {
+            for (int shift = 28; shift >= 0; shift -= 4) hex += kHex[(word >> shift) & 0xF];
+        }
+        return hex;
+    }
+
+private:
+    static std::uint32_t rotr(std::uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+    void transform(const unsigned char* block) {
+        static const std::uint32_t k[64] = {
+            0x428a2f98u, 0x71374491u, 0xb5c0fbcfu, 0xe9b5dba5u, 0x3956c25bu, 0x59f111f1u, 0x923f82a4u, 0xab1c5ed5u,
+            0xd807aa98u, 0x12835b01u, 0x243185beu, 0x550c7dc3u, 0x72be5d74u, 0x80deb1feu, 0x9bdc06a7u, 0xc19bf174u,
+            0xe49b69c1u, 0xefbe4786u, 0x0fc19dc6u, 0x240ca1ccu, 0x2de92c6fu, 0x4a7484aau, 0x5cb0a9dcu, 0x76f988dau,
+            0x983e5152u, 0xa831c66du, 0xb00327c8u, 0xbf597fc7u, 0xc6e00bf3u, 0xd5a79147u, 0x06ca6351u, 0x14292967u,
+            0x27b70a85u, 0x2e1b2138u, 0x4d2c6dfcu, 0x53380d13u, 0x650a7354u, 0x766a0abbu, 0x81c2c92eu, 0x92722c85u,
+            0xa2bfe8a1u, 0xa81a664bu, 0xc24b8b70u, 0xc76c51a3u, 0xd192e819u, 0xd6990624u, 0xf40e3585u, 0x106aa070u,
+            0x19a4c116u, 0x1e376c08u, 0x2748774cu, 0x34b0bcb5u, 0x391c0cb3u, 0x4ed8aa4au, 0x5b9cca4fu, 0x682e6ff3u,
+            0x748f82eeu, 0x78a5636fu, 0x84c87814u, 0x8cc70208u, 0x90befffau, 0xa4506cebu, 0xbef9a3f7u, 0xc67178f2u};
+
+        std::uint32_t w[64];
+        for (int i = 0; i < 16; ++i) {
+            w[i] = (std::uint32_t(block[4 * i]) << 24) | (std::uint32_t(block[4 * i + 1]) << 16) |
+                   (std::uint32_t(block[4 * i + 2]) << 8) | std::uint32_t(block[4 * i + 3]);
+        }
+        for (int i = 16; i < 64; ++i) {
+            std::uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            std::uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        std::uint32_t a = m_state[0], b = m_state[1], c = m_state[2], d = m_state[3];
+        std::uint32_t e = m_state[4], f = m_state[5], g = m_state[6], h = m_state[7];
+        for (int i = 0; i < 64; ++i) {
+            std::uint32_t s1 = rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25);
+            std::uint32_t ch = (e & f) ^ (~e & g);
+            std::uint32_t t1 = h + s1 + ch + k[i] + w[i];
+            std::uint32_t s0 = rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22);
+            std::uint32_t maj = (a & b) ^ (a & c) ^ (b & c);
+            std::uint32_t t2 = s0 + maj;
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        m_state[0] += a; m_state[1] += b; m_state[2] += c; m_state[3] += d;
+        m_state[4] += e; m_state[5] += f; m_state[6] += g; m_state[7] += h;
+    }
+
+    std::array<std::uint32_t, 8> m_state;
+    std::array<unsigned char, 64> m_buffer{};
+    std::size_t m_bufferSize = 0;
+    std::uint64_t m_totalBytes = 0;
+};
+
+std::string readWholeFile(const fs::path& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Не вдалося відкрити файл: " + path.string());
+    }
+    std::string content;
+    std::error_code ec;
+    const std::uintmax_t size = fs::file_size(path, ec);
+    if (!ec) content.reserve(static_cast<std::size_t>(size));
+    content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (file.bad()) {
+        throw std::runtime_error("Помилка читання файлу: " + path.string());
+    }
+    return content;
+}
+
+// Рядок індексу: id \t timestamp \t hash \t size \t name [\t base \t depth].
+// Для дельта-об'єктів додаються хеш бази і глибина ланцюжка (1 - дельта від повної копії).
+std::string formatIndexLine(const BackupEntry& entry, const std::string& base, unsigned depth) {
+    std::ostringstream line;
+    line << entry.id << '\t' << entry.timestamp << '\t' << entry.hash << '\t' << entry.size << '\t' << entry.name;
+    if (!base.empty()) line << '\t' << base << '\t' << depth;
+    line << '\n';
+    return line.str();
+}
+
+// Рядок об'єкта, на який не посилається жоден запис, але від якого залежать дельти:
+// #obj \t hash \t base \t depth (base порожній для повної копії)
+std::string formatObjectLine(const std::string& hash, const std::string& base, unsigned depth) {
+    return kObjectLinePrefix + hash + '\t' + base + '\t' + std::to_string(depth) + '\n';
+}
+
+// Перший рядок індексу: #gen \t покоління. Нове покоління - при кожному переписуванні індексу,
+// тож інший екземпляр бачить, що прочитаний ним префікс уже не дійсний, навіть якщо розмір не зменшився.
+std::string newGeneration() {
+    std::random_device device;
+    std::mt19937_64 rng((std::uint64_t(device()) << 32) ^ device() ^
+                        static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+    std::ostringstream value;
+    value << std::hex << rng();
+    return value.str();
+}
+
+std::string formatGenerationLine(const std::string& generation) {
+    return kGenerationLinePrefix + generation + '\n';
+}
+
+// Порожній рядок - індекс без заголовка (створений до появи поколінь)
+std::string readGeneration(std::istream& index) {
+    std::string line;
+    if (!std::getline(index, line) || index.eof()) return std::string();
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    const std::size_t prefixLength = std::strlen(kGenerationLinePrefix);
+    return line.compare(0, prefixLength, kGenerationLinePrefix) == 0 ? line.substr(prefixLength) : std::string();
+}
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::size_t start = 0;
+    for (;;) {
+        std::size_t tab = line.find('\t', start);
+        fields.push_back(line.substr(start, tab == std::string::npos ? std::string::npos : tab - start));
+        if (tab == std::string::npos) return fields;
+        start = tab + 1;
+    }
+}
+
+bool parseIndexLine(const std::string& line, BackupEntry& entry, std::string& base, unsigned& depth) {
+    const std::vector<std::string> fields = splitFields(line);
+    if (fields.size() != 5 && fields.size() != 7) return false;
+    try {
+        entry.id = std::stoull(fields[0]);
+        entry.timestamp = std::stoll(fields[1]);
+        entry.size = std::stoull(fields[3]);
+        depth = fields.size() == 7 ? static_cast<unsigned>(std::stoul(fields[6])) : 0;
+    } catch (const std::exception&) {
+        return false;
+    }
+    entry.hash = fields[2];
+    entry.name = fields[4];
+    base = fields.size() == 7 ? fields[5] : std::string();
+    return entry.hash.size() == 64 && (base.empty() || base.size() == 64);
+}
+
+}
+
+BackupStore::BackupStore(fs::path directory)
+    : m_directory(std::move(directory)), m_archive(m_directory / kArchiveFileName) {}
+
+std::string BackupStore::hashContent(const std::string& content) {
+    Sha256 sha;
+    sha.update(reinterpret_cast<const unsigned char*>(content.data()), content.size());
+    return sha.hexDigest();
+}
+
+fs::path BackupStore::objectPath(const std::string& hash) const {
+    return m_directory / kObjectsDirName / (hash + ".xml");
+}
+
+fs::path BackupStore::deltaPath(const std::string& hash) const {
+    return m_directory / kObjectsDirName / (hash + ".delta");
+}
+
+void BackupStore::setKeyframeInterval(unsigned interval) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_keyframeInterval = interval;
+}
+
+void BackupStore::resetLocked() {
+    m_entries.clear();
+    m_refCounts.clear();
+    m_deltaObjects.clear();
+    m_dependents.clear();
+    m_indexOffset = 0;
+    m_indexGeneration.clear();
+}
+
+void BackupStore::noteDeltaLocked(const std::string& hash, const std::string& base, unsigned depth) {
+    if (base.empty()) return;
+    if (m_deltaObjects.emplace(hash, DeltaInfo{base, depth}).second) ++m_dependents[base];
+}
+
+// Довантажує рядки, дописані в індекс після попереднього читання (зокрема іншими екземплярами).
+// Інше покоління в заголовку означає, що індекс переписано (prune) - тоді він читається заново.
+// Незавершений останній рядок (збій посеред дописування) пропускається. Викликається під FileLock сховища.
+void BackupStore::refreshLocked() {
+    const fs::path indexPath = m_directory / kIndexFileName;
+    std::ifstream index(indexPath, std::ios::binary);
+    if (!index.is_open()) {
+        resetLocked();
+        return;
+    }
+    const std::string generation = readGeneration(index);
+    index.clear();
+    index.seekg(0, std::ios::end);
+    const std::uintmax_t indexSize = static_cast<std::uintmax_t>(index.tellg());
+    if (generation != m_indexGeneration || indexSize < m_indexOffset) {
+        resetLocked();
+        m_indexGeneration = generation;
+    }
+    if (indexSize == m_indexOffset) return;
+
+    index.seekg(static_cast<std::streamoff>(m_indexOffset));
+    std::string line;
+    while (std::getline(index, line)) {
+        if (index.eof()) break; // Рядок без '\n' - запис ще не завершено
+        m_indexOffset += line.size() + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.compare(0, std::strlen(kGenerationLinePrefix), kGenerationLinePrefix) == 0) continue;
+
+        if (line.compare(0, std::strlen(kObjectLinePrefix), kObjectLinePrefix) == 0) {
+            const std::vector<std::string> fields = splitFields(line);
+            if (fields.size() == 4) {
+                try {
+                    noteDeltaLocked(fields[1], fields[2], static_cast<unsigned>(std::stoul(fields[3])));
+                } catch (const std::exception&) {}
+            }
+            continue;
+        }
+
+        BackupEntry entry;
+        std::string base;
+        unsigned depth = 0;
+        if (parseIndexLine(line, entry, base, depth)) {
+            noteDeltaLocked(entry.hash, base, depth);
+            ++m_refCounts[entry.hash];
+            m_entries.push_back(std::move(entry));
+        }
+    }
+}
+
+// Вміст об'єкта: повна копія або дельта, застосована до відновленої бази (рекурсивно до ключового кадру).
+// Спершу архів; окремі файли objects/ лишилися від сховищ, створених до появи архіву.
+std::string BackupStore::readObject(const std::string& hash, unsigned depthLimit) {
+    std::uint8_t kind = kKindFull;
+    std::string delta;
+    if (!m_archive.read(hash, kind, delta)) {
+        std::error_code ec;
+        const fs::path fullPath = objectPath(hash);
+        if (fs::exists(fullPath, ec)) return readWholeFile(fullPath);
+        delta = readWholeFile(deltaPath(hash));
+    } else if (kind == kKindFull) {
+        return delta;
+    }
+    // Заголовок: WOTDELTA1 <base> <depth>\n
+    const std::size_t headerEnd = delta.find('\n');
+    const std::size_t magicLength = std::strlen(kDeltaMagic);
+    if (headerEnd == std::string::npos || delta.compare(0, magicLength, kDeltaMagic) != 0 || headerEnd < magicLength + 66) {
+        throw std::runtime_error("Пошкоджений дельта-об'єкт резервної копії: " + hash);
+    }
+    const std::string base = delta.substr(magicLength + 1, 64);
+    // Глибина із заголовка (1 - дельта від ключового кадру) строго спадає вздовж ланцюжка, тож цикл неможливий
+    unsigned long depth = 0;
+    try {
+        depth = std::stoul(delta.substr(magicLength + 66, headerEnd - magicLength - 66));
+    } catch (const std::exception&) {
+        throw std::runtime_error("Пошкоджений дельта-об'єкт резервної копії: " + hash);
+    }
+    if (depth == 0 || depth > depthLimit) {
+        throw std::runtime_error("Ланцюжок дельт резервної копії зациклений або задовгий: " + hash);
+    }
+    const std::string baseContent = readObject(base, static_cast<unsigned>(depth) - 1);
+    return BackupDelta::apply(baseContent, std::string_view(delta).substr(headerEnd + 1));
+}
+
+BackupEntry BackupStore::add(const fs::path& sourceFile, std::int64_t timestamp, const std::string& name) {
+    std::string content = readWholeFile(sourceFile);
+    const std::string hash = hashContent(content);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if (ec) {
+        throw std::runtime_error("Не вдалося створити сховище резервних копій: " + m_directory.string());
+    }
+    FileLock fileLock(m_directory / kLockFileName, FileLock::Mode::Exclusive);
+    refreshLocked();
+
+    // Вміст, який уже є у сховищі, повторно не записується - лише новий рядок індексу
+    const bool known = m_refCounts.count(hash) > 0 || m_deltaObjects.count(hash) > 0 || m_archive.contains(hash) ||
+                       fs::exists(objectPath(hash), ec) || fs::exists(deltaPath(hash), ec);
+    if (!known) {
+        bool storedAsDelta = false;
+        // Дельта від попередньої версії, доки ланцюжок коротший за інтервал ключових кадрів
+        if (m_keyframeInterval > 1 && !m_entries.empty()) {
+            const std::string& previousHash = m_entries.back().hash;
+            auto previousDelta = m_deltaObjects.find(previousHash);
+            const unsigned depth = (previousDelta != m_deltaObjects.end() ? previousDelta->second.depth : 0) + 1;
+            if (depth < m_keyframeInterval) {
+                try {
+                    const std::string previousContent = previousHash == m_lastHash ? m_lastContent
+                                                                                    : readObject(previousHash, kMaxDeltaDepth);
+                    std::string delta = std::string(kDeltaMagic) + ' ' + previousHash + ' ' + std::to_string(depth) + '\n';
+                    delta += BackupDelta::encode(previousContent, content);
+                    // Дельта має сенс, лише якщо суттєво менша за повну копію
+                    if (delta.size() < content.size() / 2) {
+                        m_archive.append(hash, kKindDelta, delta);
+                        noteDeltaLocked(hash, previousHash, depth);
+                        storedAsDelta = true;
+                    }
+                } catch (const std::runtime_error&) {
+                    // База недоступна або пошкоджена - новий ключовий кадр
+                }
+            }
+        }
+        if (!storedAsDelta) {
+            m_archive.append(hash, kKindFull, content);
+        }
+    }
+
+    BackupEntry entry;
+    entry.id = m_entries.empty() ? 1 : m_entries.back().id + 1;
+    entry.timestamp = timestamp;
+    entry.hash = hash;
+    entry.size = content.size();
+    entry.name = name;
+
+    auto deltaInfo = m_deltaObjects.find(hash);
+    std::string line = deltaInfo != m_deltaObjects.end() ? formatIndexLine(entry, deltaInfo->second.base, deltaInfo->second.depth)
+                                                         : formatIndexLine(entry, "", 0);
+    // Хвіст без '\n' лишився від перерваного дописування: новий запис починається з нового рядка
+    const std::uintmax_t indexSize = fs::file_size(m_directory / kIndexFileName, ec);
+    if (!ec && indexSize > m_indexOffset) {
+        line.insert(line.begin(), '\n');
+        m_indexOffset = indexSize;
+    } else if (ec || indexSize == 0) {
+        m_indexGeneration = newGeneration(); // Новий індекс починається із заголовка
+        line.insert(0, formatGenerationLine(m_indexGeneration));
+    }
+    std::ofstream index(m_directory / kIndexFileName, std::ios::binary | std::ios::app);
+    if (!index.is_open() || !index.write(line.data(), static_cast<std::streamsize>(line.size())) || !index.flush()) {
+        throw std::runtime_error("Не вдалося дописати індекс резервних копій: " + (m_directory / kIndexFileName).string());
+    }
+    index.close();
+
+    m_indexOffset += line.size();
+    ++m_refCounts[hash];
+    m_entries.push_back(entry);
+    m_lastHash = hash;
+    m_lastContent = std::move(content); // База для наступної дельти без повторного читання
+    return entry;
+}
+
+std::vector<BackupEntry> BackupStore::list() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FileLock fileLock(m_directory / kLockFileName, FileLock::Mode::Shared);
+    refreshLocked();
+    return m_entries;
+}
+
+bool BackupStore::find(std::uint64_t id, BackupEntry& entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FileLock fileLock(m_directory / kLockFileName, FileLock::Mode::Shared);
+    refreshLocked();
+    // id зростають разом з позицією в індексі
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), id,
+                               [](const BackupEntry& e, std::uint64_t value) { return e.id < value; });
+    if (it == m_entries.end() || it->id != id) return false;
+    entry = *it;
+    return true;
+}
+
+std::string BackupStore::read(const BackupEntry& entry) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FileLock fileLock(m_directory / kLockFileName, FileLock::Mode::Shared); // prune іншого процесу не видалить об'єкти посеред читання
+    // Запас на ланцюжки, створені з більшим інтервалом
+    std::string content = readObject(entry.hash, kMaxDeltaDepth);
+    if (hashContent(content) != entry.hash) {
+        throw std::runtime_error("Вміст резервної копії пошкоджено (не збігається хеш): " + entry.name);
+    }
+    return content;
+}
+
+void BackupStore::restore(const BackupEntry& entry, const fs::path& target) {
+    const std::string content = read(entry);
+    AtomicFile::writeBuffer(target, content.data(), content.size());
+}
+
+namespace {
+std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+    std::int64_t q = value / divisor;
+    return (value % divisor != 0 && value < 0) ? q - 1 : q;
+}
+}
+
+RetentionReport BackupStore::prune(const RetentionPolicy& policy, std::int64_t now) {
+    TraceScope trace("BackupStore::prune");
+    const auto start = std::chrono::steady_clock::now();
+    RetentionReport report;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    FileLock fileLock(m_directory / kLockFileName, FileLock::Mode::Exclusive);
+    refreshLocked();
+    const std::size_t count = m_entries.size();
+    if (count == 0) return report;
+
+    std::vector<char> keep(count, 0);
+    const std::size_t keepLast = std::min(count, std::max<std::size_t>(policy.keepLast, 1));
+    for (std::size_t i = count - keepLast; i < count; ++i) keep[i] = 1;
+
+    // Найновіша копія кожного кошика (дня/тижня) у межах вікна; записи йдуть за зростанням id
+    auto keepNewestPerBucket = [&](std::int64_t bucketSeconds, int buckets) {
+        if (buckets <= 0) return;
+        const std::int64_t windowStart = now - bucketSeconds * buckets;
+        std::unordered_set<std::int64_t> seen;
+        for (std::size_t i = count; i-- > 0;) {
+            const std::int64_t timestamp = m_entries[i].timestamp;
+            if (timestamp < windowStart) continue; // Без break: час у записах може йти не монотонно
+            if (seen.insert(floorDiv(timestamp, bucketSeconds)).second) keep[i] = 1;
+        }
+    };
+    keepNewestPerBucket(24 * 60 * 60, policy.keepDailyDays);
+    keepNewestPerBucket(7 * 24 * 60 * 60, policy.keepWeeklyWeeks);
+
+    // Межа обсягу: кожен унікальний вміст рахується один раз; витісняються найстаріші з утримуваних
+    std::unordered_map<std::string, std::size_t> keptRefs;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (keep[i] && keptRefs[m_entries[i].hash]++ == 0) report.totalBytes += m_entries[i].size;
+    }
+    if (policy.maxTotalBytes > 0) {
+        for (std::size_t i = 0; i + 1 < count && report.totalBytes > policy.maxTotalBytes; ++i) {
+            if (!keep[i]) continue;
+            keep[i] = 0;
+            if (--keptRefs[m_entries[i].hash] == 0) report.totalBytes -= m_entries[i].size;
+        }
+    }
+
+    std::vector<BackupEntry> kept;
+    kept.reserve(count);
+    std::vector<std::string> unreferenced; // Об'єкти, на які більше не посилається жоден запис
+    for (std::size_t i = 0; i < count; ++i) {
+        if (keep[i]) {
+            kept.push_back(m_entries[i]);
+            continue;
+        }
+        auto ref = m_refCounts.find(m_entries[i].hash);
+        if (ref != m_refCounts.end() && --ref->second == 0) {
+            unreferenced.push_back(ref->first);
+            m_refCounts.erase(ref);
+        }
+    }
+    report.keptEntries = kept.size();
+    report.removedEntries = count - kept.size();
+    if (report.removedEntries == 0) {
+        report.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return report;
+    }
+
+    // Об'єкт видаляється, лише коли від нього не залежить жодна дельта; видалення дельти
+    // звільняє її базу, тож звільнення йде каскадом по ланцюжку
+    std::vector<std::string> removable;
+    std::vector<std::string> pending = std::move(unreferenced);
+    while (!pending.empty()) {
+        std::string hash = std::move(pending.back());
+        pending.pop_back();
+        if (m_refCounts.count(hash) > 0 || m_dependents[hash] > 0) continue;
+        m_dependents.erase(hash);
+        auto delta = m_deltaObjects.find(hash);
+        if (delta != m_deltaObjects.end()) {
+            const std::string base = delta->second.base;
+            m_deltaObjects.erase(delta);
+            if (--m_dependents[base] == 0 && m_refCounts.count(base) == 0) pending.push_back(base);
+        }
+        removable.push_back(std::move(hash));
+    }
+
+    // Спершу індекс, потім об'єкти: збій між кроками лишає зайві об'єкти, а не записи без вмісту.
+    // Дельти без записів, від яких залежать інші дельти, зберігаються рядками #obj.
+    const std::string generation = newGeneration();
+    std::string indexContent = formatGenerationLine(generation);
+    for (const auto& delta : m_deltaObjects) {
+        if (m_refCounts.count(delta.first) == 0) indexContent += formatObjectLine(delta.first, delta.second.base, delta.second.depth);
+    }
+    for (const BackupEntry& entry : kept) {
+        auto delta = m_deltaObjects.find(entry.hash);
+        indexContent += delta != m_deltaObjects.end() ? formatIndexLine(entry, delta->second.base, delta->second.depth)
+                                                      : formatIndexLine(entry, "", 0);
+    }
+    try {
+        AtomicFile::writeBuffer(m_directory / kIndexFileName, indexContent.data(), indexContent.size());
+    } catch (const std::runtime_error&) {
+        // Лічильники й дельти вище вже змінено, а індекс на диску - ні: стан читається з нього заново
+        resetLocked();
+        throw;
+    }
+    m_entries = std::move(kept);
+    m_indexOffset = indexContent.size();
+    m_indexGeneration = generation;
+
+    // Блоки архіву лише вилучаються з його індексу; місце повертає ущільнення архіву
+    report.removedObjects = removable.size();
+    report.reclaimedBytes += m_archive.remove(removable);
+    for (const std::string& hash : removable) {
+        for (const fs::path& path : {objectPath(hash), deltaPath(hash)}) {
+            std::error_code ec;
+            const std::uintmax_t size = fs::file_size(path, ec);
+            if (!ec && fs::remove(path, ec)) report.reclaimedBytes += size;
+        }
+    }
+
+    report.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return report;
+}
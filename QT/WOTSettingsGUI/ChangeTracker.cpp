@@ -1,58 +1,202 @@
 #include "main.h" // Головний заголовок
-#include <fstream>
+#include <atomic>
 #include <chrono>
-#include <iomanip>
+#include <condition_variable>
 #include <filesystem>
-#include <sstream>
 #include <iostream> // Залишаємо для std::cerr
+#include <thread>
 
 namespace fs = std::filesystem;
 
-// Метод для запису дії в лог
-void ChangeTracker::logAction(const std::string& functionName, bool success, const std::string& details) {
-    const fs::path logDir = "User Data";
-    const fs::path logFilePath = logDir / "logs.txt";
+namespace {
 
-    try {
-        if (!fs::exists(logDir)) {
-            try {
-                fs::create_directory(logDir);
-            } catch(const fs::filesystem_error& e) {
-                std::cerr << "CRITICAL ERROR: Could not create log directory '" << logDir.string() << "'. Error: " << e.what() << std::endl;
-                return;
-            }
+const char* const kLogDirectory = "User Data";
+
+// Спільний для всіх ChangeTracker фоновий записувач логу.
+// Виклики logAction лише кладуть запис у черги без блокувань (MPSC-черга Вьюкова): жодних
+// звернень до файлової системи в потоці UI. Потік-записувач тримає лог (LogStore) відкритим,
+// форматує записи пачками і скидає їх на диск за часом, за розміром або при завершенні програми.
+class LogWriter {
+public:
+    static LogWriter& instance() {
+        static LogWriter writer;
+        return writer;
+    }
+
+    void push(LogEntry&& record) {
+        if (!m_threadStarted) { // Потік не вдалося запустити - пишемо одразу, як раніше
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_store.append(record);
+            m_store.flush();
+            return;
+        }
+        Node* node = new Node;
+        node->record = std::move(record);
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+        m_pushed.fetch_add(1, std::memory_order_release);
+        // Будимо записувач лише при досягненні порогу: решту забирає періодичне пробудження
+        if (m_pending.fetch_add(1, std::memory_order_relaxed) + 1 == kWakeThreshold) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_wakeCondition.notify_one();
         }
+    }
 
-        std::ofstream logFile(logFilePath, std::ios::app);
+    // Чекає, доки всі записи, додані до виклику, потраплять у файл
+    void flush() {
+        if (!m_threadStarted) return;
+        const std::uint64_t target = m_pushed.load(std::memory_order_acquire);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_flushRequested = true;
+        m_wakeCondition.notify_one();
+        m_flushedCondition.wait(lock, [&] { return m_written >= target; });
+    }
 
-        if (!logFile.is_open()) {
-            std::cerr << "ERROR: Could not open log file for writing: " << logFilePath.string() << std::endl;
+    // Застосовується записувачем при наступному пробудженні
+    void setPolicy(const LogRotationPolicy& policy) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_threadStarted) {
+            m_store.setPolicy(policy);
             return;
         }
+        m_pendingPolicy = policy;
+        m_hasPendingPolicy = true;
+    }
 
-        auto now = std::chrono::system_clock::now();
-        auto now_c = std::chrono::system_clock::to_time_t(now);
-        std::tm now_tm;
-#ifdef _WIN32
-        localtime_s(&now_tm, &now_c);
-#else
-        localtime_r(&now_c, &now_tm);
-#endif
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        LogEntry record;
+    };
+
+    static constexpr std::size_t kWakeThreshold = 256;          // Записів у черзі до позачергового пробудження
+    static constexpr std::size_t kBufferLimit = 64 * 1024;      // Байтів до проміжного запису у файл
+    static constexpr std::chrono::milliseconds kFlushInterval{200};
+
+    LogWriter() : m_head(&m_stub), m_tail(&m_stub) {
+        try {
+            m_thread = std::thread(&LogWriter::run, this);
+            m_threadStarted = true;
+        } catch (const std::system_error& e) {
+            std::cerr << "ERROR: Could not start log writer thread, logging synchronously: " << e.what() << std::endl;
+        }
+    }
+
+    ~LogWriter() {
+        if (m_threadStarted) {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopping = true;
+                m_wakeCondition.notify_one();
+            }
+            m_thread.join();
+        }
+    }
+
+    // Споживач один - потік-записувач, тож хвіст черги змінюється без атомарних операцій
+    bool pop(LogEntry& record) {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) return false;
+        record = std::move(next->record);
+        m_tail = next;
+        if (tail != &m_stub) delete tail;
+        return true;
+    }
 
-        logFile << std::put_time(&now_tm, "%Y-%m-%d_%H:%M:%S") << " | "
-                << functionName << " | Result: [" << (success ? "OK" : "NOK") << "]";
+    void run() {
+        LogEntry record;
+        std::uint64_t drained = 0;
+        for (;;) {
+            bool stopping = false;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wakeCondition.wait_for(lock, kFlushInterval, [&] {
+                    return m_stopping || m_flushRequested || m_pending.load(std::memory_order_relaxed) >= kWakeThreshold;
+                });
+                stopping = m_stopping;
+                m_flushRequested = false;
+                if (m_hasPendingPolicy) {
+                    m_store.setPolicy(m_pendingPolicy);
+                    m_hasPendingPolicy = false;
+                }
+            }
 
-        if (!details.empty()) {
-            logFile << " | Details: " << details;
+            // Перед завершенням черга вичерпується повністю
+            while (pop(record)) {
+                m_pending.fetch_sub(1, std::memory_order_relaxed);
+                m_store.append(record);
+                ++drained;
+                if (m_store.bufferedBytes() >= kBufferLimit) m_store.flush();
+            }
+            m_store.flush();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_written = drained;
+            }
+            m_flushedCondition.notify_all();
+            if (stopping) break;
         }
+        if (m_tail != &m_stub) {
+            delete m_tail;
+            m_tail = &m_stub;
+        }
+    }
+
+    Node m_stub;
+    std::atomic<Node*> m_head; // Сюди додають виробники
+    Node* m_tail;              // Звідси забирає записувач
+    std::atomic<std::size_t> m_pending{0};
+    std::atomic<std::uint64_t> m_pushed{0};
 
-        logFile << std::endl;
+    std::mutex m_mutex; // Лише для очікування/пробудження (і синхронного запису без потоку)
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_flushedCondition;
+    bool m_stopping = false;
+    bool m_flushRequested = false;
+    std::uint64_t m_written = 0;
 
-    } catch (const fs::filesystem_error& e) {
-        std::cerr << "Filesystem error during logging: " << e.what() << std::endl;
+    LogRotationPolicy m_pendingPolicy;
+    bool m_hasPendingPolicy = false;
+
+    LogStore m_store{kLogDirectory}; // Оголошено перед потоком: створюється раніше за нього
+    std::thread m_thread;
+    bool m_threadStarted = false;
+};
+
+}
+
+// Метод для запису дії в лог: лише ставить запис у чергу фонового записувача
+void ChangeTracker::logAction(const std::string& functionName, bool success, const std::string& details) {
+    try {
+        const auto now = std::chrono::system_clock::now().time_since_epoch();
+        LogWriter::instance().push(LogEntry{std::chrono::duration_cast<std::chrono::milliseconds>(now).count(),
+                                            functionName, success, details});
     } catch (const std::exception& e) {
         std::cerr << "Standard exception during logging: " << e.what() << std::endl;
     } catch (...) {
         std::cerr << "Unknown error during logging." << std::endl;
     }
 }
+
+void ChangeTracker::flush() {
+    LogWriter::instance().flush();
+}
+
+void ChangeTracker::setRotationPolicy(const LogRotationPolicy& policy) {
+    LogWriter::instance().setPolicy(policy);
+}
+
+std::vector<LogEntry> ChangeTracker::readHistory(const LogQuery& query) {
+    flush();
+    return LogStore::query(kLogDirectory, query);
+}
+
+// Записує кожну зміну окремим рядком, щоб лог містив саме те, що змінилось у файлі
+void ChangeTracker::logChanges(const std::string& functionName, const fs::path& filePath, const SettingChangeSet& changes) {
+    const std::string fileName = filePath.filename().string();
+    for (const SettingChange& change : changes) {
+        logAction(functionName, true, fileName + " | " + change.category + "/" + change.key +
+                                          ": '" + change.oldValue + "' -> '" + change.newValue + "'");
+    }
+}
@@ -0,0 +1,330 @@
+#include "main.h" // Головний заголовок (містить оголошення ConfigDiff)
+#include "pugixml/pugixml.hpp"
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+
+namespace {
+
+bool nameIs(const pugi::xml_node& node, const char* name) {
+    return std::strcmp(node.name(), name) == 0;
+}
+
+// Мітка запису <entry> (порожня для інших елементів): записи зіставляються за нею
+std::string_view entryLabel(const pugi::xml_node& node) {
+    if (!nameIs(node, "entry")) return {};
+    return XmlUtil::trimmed(node.child_value("label"));
+}
+
+// Ідентичність дочірнього елемента серед сусідів: ім'я, мітка і номер входження такої пари
+struct ChildKey {
+    std::string_view name;
+    std::string_view label;
+    unsigned occurrence = 0;
+    bool operator==(const ChildKey& other) const {
+        return occurrence == other.occurrence && name == other.name && label == other.label;
+    }
+};
+struct ChildKeyHash {
+    std::size_t operator()(const ChildKey& key) const {
+        const std::hash<std::string_view> hash;
+        return hash(key.name) ^ (hash(key.label) * 31) ^ (static_cast<std::size_t>(key.occurrence) * 0x9e3779b9u);
+    }
+};
+struct NameLabelHash {
+    std::size_t operator()(const std::pair<std::string_view, std::string_view>& key) const {
+        const std::hash<std::string_view> hash;
+        return hash(key.first) ^ (hash(key.second) * 31);
+    }
+};
+
+struct KeyedChild {
+    ChildKey key;
+    pugi::xml_node node;
+};
+
+std::vector<KeyedChild> keyedChildren(const pugi::xml_node& parent) {
+    std::vector<KeyedChild> children;
+    std::unordered_map<std::pair<std::string_view, std::string_view>, unsigned, NameLabelHash> seen;
+    for (pugi::xml_node child = XmlUtil::firstElement(parent); child; child = XmlUtil::nextElement(child)) {
+        ChildKey key{child.name(), entryLabel(child), 0};
+        key.occurrence = seen[{key.name, key.label}]++;
+        children.push_back({key, child});
+    }
+    return children;
+}
+
+// Сегмент шляху для елемента: "name", "entry[LABEL]" або "name[N]" для N-го входження
+void appendKeySegment(std::string& path, const ChildKey& key) {
+    path += key.name;
+    if (!key.label.empty()) {
+        path += '[';
+        path += key.label;
+        path += ']';
+    }
+    if (key.occurrence > 0) path += "[" + std::to_string(key.occurrence + 1) + "]";
+}
+
+void appendSegment(std::string& path, const pugi::xml_node& node) {
+    ChildKey key{node.name(), entryLabel(node), 0};
+    for (pugi::xml_node sibling = node.previous_sibling(node.name()); sibling; sibling = sibling.previous_sibling(node.name())) {
+        if (entryLabel(sibling) == key.label) ++key.occurrence;
+    }
+    appendKeySegment(path, key);
+}
+
+// Шлях окремого вузла (ConfigDiff::nodePath): підйом до <root> по батьківських вузлах
+std::string pathOf(const pugi::xml_node& node) {
+    std::vector<pugi::xml_node> chain;
+    for (pugi::xml_node n = node; n && n.type() == pugi::node_element && n.parent().type() != pugi::node_document; n = n.parent()) {
+        chain.push_back(n);
+    }
+    std::string path;
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        if (!path.empty()) path += '/';
+        appendSegment(path, *it);
+    }
+    return path;
+}
+
+// Перше входження серед сусідів (SettingNodeIndex індексує лише його)
+bool isFirstOccurrence(const pugi::xml_node& node) {
+    const std::string_view label = entryLabel(node);
+    for (pugi::xml_node sibling = node.previous_sibling(node.name()); sibling; sibling = sibling.previous_sibling(node.name())) {
+        if (entryLabel(sibling) == label) return false;
+    }
+    return true;
+}
+
+// Ключ FilteredSettingsMap за розташуванням вузла (ті самі секції, що й у SettingNodeIndex).
+// nodeFirst/parentFirst - чи вузол і його батько є першими входженнями серед сусідів.
+std::string settingKeyOf(const pugi::xml_node& node, bool nodeFirst, bool parentFirst) {
+    if (!nodeFirst) return {};
+    const pugi::xml_node parent = node.parent();
+    const pugi::xml_node grand = parent.parent();
+    auto underRoot = [](const pugi::xml_node& section) { return nameIs(section.parent(), "root"); };
+
+    if (nameIs(node, "entry") || (nameIs(node, "activeOption") && nameIs(parent, "entry"))) {
+        const pugi::xml_node entry = nameIs(node, "entry") ? node : parent;
+        if (!(nameIs(node, "entry") ? nodeFirst : parentFirst)) return {};
+        const pugi::xml_node section = entry.parent();
+        const std::string_view label = entryLabel(entry);
+        if (nameIs(section, "graphicsPreferences") && underRoot(section) && SettingSchema::find(ConfigSection::GRAPHICS_ENTRY, label)) {
+            return std::string(label);
+        }
+        return {};
+    }
+    if (nameIs(parent, "soundPrefs") && nameIs(grand, "scriptsPreferences") && underRoot(grand)) {
+        return SettingSchema::find(ConfigSection::SOUND_PREFS, node.name()) ? node.name() : std::string();
+    }
+    if (nameIs(parent, "camera") && nameIs(grand.parent(), "controlMode") && underRoot(grand.parent().parent())) {
+        return SettingSchema::findControl(grand.name(), node.name()) ? std::string(grand.name()) + "/" + node.name() : std::string();
+    }
+    if (nameIs(parent, "graphicsPreferences") && underRoot(parent)) {
+        return SettingSchema::find(ConfigSection::GRAPHICS_PREFERENCES, node.name()) ? node.name() : std::string();
+    }
+    if (nameIs(parent, "devicePreferences") && underRoot(parent)) {
+        return SettingSchema::find(ConfigSection::DEVICE_PREFERENCES, node.name()) ? node.name() : std::string();
+    }
+    return {};
+}
+
+class DiffWalker {
+public:
+    explicit DiffWalker(ConfigDiffResult& result) : m_result(result) {}
+
+    void compareRoots(const pugi::xml_node& a, const pugi::xml_node& b) {
+        compareElements(a, b, 0, nullptr);
+    }
+
+private:
+    // Рівень шляху від <root> до поточного елемента. Ключ (ім'я/мітка/входження) відомий одразу, якщо
+    // елемент зіставлено за ключем; після попарного проходу ключі дітей батька рахуються один раз і лише
+    // тоді, коли під ними знайдено відмінність - шлях і номер входження не шукаються по сусідах.
+    struct Level {
+        pugi::xml_node node;       // Елемент документа "після" (предки зіставлені, тож ключі ті самі в обох)
+        std::size_t position = 0;  // Номер серед дочірніх елементів батька
+        bool keyKnown = false;
+        ChildKey key;
+        std::vector<ChildKey> childKeys; // Ключі дочірніх елементів node (порожньо, доки не знадобляться)
+    };
+
+    void compareElements(const pugi::xml_node& a, const pugi::xml_node& b, std::size_t position, const ChildKey* key) {
+        ++m_result.comparedElements;
+        Level level;
+        level.node = b;
+        level.position = position;
+        if (key) {
+            level.key = *key;
+            level.keyKnown = true;
+        }
+        m_levels.push_back(std::move(level));
+        const std::string_view valueA = XmlUtil::trimmed(a.child_value());
+        const std::string_view valueB = XmlUtil::trimmed(b.child_value());
+        if (valueA != valueB) emitCurrent(b, valueA, valueB);
+        compareChildren(a, b);
+        m_levels.pop_back();
+    }
+
+    void compareChildren(const pugi::xml_node& a, const pugi::xml_node& b) {
+        // Звичайний випадок - однаковий порядок: діти порівнюються попарно без хеш-таблиць
+        pugi::xml_node childA = XmlUtil::firstElement(a);
+        pugi::xml_node childB = XmlUtil::firstElement(b);
+        std::size_t prefix = 0;
+        while (childA && childB && nameIs(childA, childB.name()) && entryLabel(childA) == entryLabel(childB)) {
+            compareElements(childA, childB, prefix, nullptr);
+            childA = XmlUtil::nextElement(childA);
+            childB = XmlUtil::nextElement(childB);
+            ++prefix;
+        }
+        if (!childA && !childB) return;
+
+        // Порядок розійшовся: решта зіставляється за ключем (ім'я/мітка/входження рахуються від початку)
+        const std::vector<KeyedChild> listA = keyedChildren(a);
+        const std::vector<KeyedChild> listB = keyedChildren(b);
+        std::unordered_map<ChildKey, std::size_t, ChildKeyHash> indexB;
+        indexB.reserve(listB.size() - prefix);
+        for (std::size_t i = prefix; i < listB.size(); ++i) indexB.emplace(listB[i].key, i);
+
+        std::vector<bool> matchedB(listB.size(), false);
+        for (std::size_t i = prefix; i < listA.size(); ++i) {
+            auto it = indexB.find(listA[i].key);
+            if (it == indexB.end()) {
+                emitSubtree(ConfigDifference::Kind::REMOVED, listA[i]);
+                continue;
+            }
+            matchedB[it->second] = true;
+            compareElements(listA[i].node, listB[it->second].node, it->second, &listB[it->second].key);
+        }
+        for (std::size_t i = prefix; i < listB.size(); ++i) {
+            if (!matchedB[i]) emitSubtree(ConfigDifference::Kind::ADDED, listB[i]);
+        }
+    }
+
+    const ChildKey& keyAt(std::size_t depth) {
+        Level& level = m_levels[depth];
+        if (!level.keyKnown) {
+            std::vector<ChildKey>& siblings = m_levels[depth - 1].childKeys;
+            if (siblings.empty()) {
+                for (const KeyedChild& child : keyedChildren(m_levels[depth - 1].node)) siblings.push_back(child.key);
+            }
+            level.key = siblings[level.position];
+            level.keyKnown = true;
+        }
+        return level.key;
+    }
+
+    // Шлях рівнів 1..depth (<root> - рівень 0 - у шлях не входить)
+    std::string pathTo(std::size_t depth) {
+        std::string path;
+        for (std::size_t i = 1; i <= depth; ++i) {
+            if (i > 1) path += '/';
+            appendKeySegment(path, keyAt(i));
+        }
+        return path;
+    }
+
+    bool firstAt(std::size_t depth) {
+        return depth == 0 || keyAt(depth).occurrence == 0;
+    }
+
+    // Змінене значення поточного елемента (верхній рівень)
+    void emitCurrent(const pugi::xml_node& node, std::string_view oldValue, std::string_view newValue) {
+        const std::size_t depth = m_levels.size() - 1;
+        emit(ConfigDifference::Kind::CHANGED, pathTo(depth), settingKeyOf(node, firstAt(depth), depth < 2 || firstAt(depth - 1)),
+             oldValue, newValue);
+    }
+
+    // Додана/видалена дитина поточного елемента
+    void emitSubtree(ConfigDifference::Kind kind, const KeyedChild& child) {
+        const std::size_t depth = m_levels.size() - 1;
+        std::string path = pathTo(depth);
+        if (!path.empty()) path += '/';
+        appendKeySegment(path, child.key);
+        std::string key = settingKeyOf(child.node, child.key.occurrence == 0, firstAt(depth));
+        // Значення - лише для листків; піддерево з дочірніми елементами описується шляхом
+        const std::string_view value = XmlUtil::firstElement(child.node) ? std::string_view() : XmlUtil::trimmed(child.node.child_value());
+        if (kind == ConfigDifference::Kind::ADDED) emit(kind, std::move(path), std::move(key), {}, value);
+        else emit(kind, std::move(path), std::move(key), value, {});
+    }
+
+    void emit(ConfigDifference::Kind kind, std::string path, std::string key, std::string_view oldValue, std::string_view newValue) {
+        ConfigDifference difference;
+        difference.kind = kind;
+        difference.path = std::move(path);
+        difference.key = std::move(key);
+        difference.oldValue = std::string(oldValue);
+        difference.newValue = std::string(newValue);
+        m_result.differences.push_back(std::move(difference));
+        switch (kind) {
+        case ConfigDifference::Kind::ADDED:   ++m_result.addedCount; break;
+        case ConfigDifference::Kind::REMOVED: ++m_result.removedCount; break;
+        case ConfigDifference::Kind::CHANGED: ++m_result.changedCount; break;
+        }
+    }
+
+    ConfigDiffResult& m_result;
+    std::vector<Level> m_levels;
+};
+
+}
+
+ConfigDiffResult ConfigDiff::compare(const pugi::xml_document& before, const pugi::xml_document& after) {
+    TraceScope trace("ConfigDiff::compare");
+    ConfigDiffResult result;
+    const pugi::xml_node rootA = before.child("root");
+    const pugi::xml_node rootB = after.child("root");
+    if (!rootA || !rootB) {
+        throw std::runtime_error("Не знайдено <root> елемент у одному з документів для порівняння.");
+    }
+    DiffWalker(result).compareRoots(rootA, rootB);
+    return result;
+}
+
+ConfigDiffResult ConfigDiff::compareFiles(const fs::path& before, const fs::path& after) {
+    auto load = [](const fs::path& path) {
+        std::shared_ptr<const ParsedDocument> parsed = DocumentCache::instance().load(path);
+        if (!parsed->ok) {
+            throw std::runtime_error("Не вдалося розібрати файл для порівняння: " + path.string() + " (" + parsed->errorDescription + ")");
+        }
+        return parsed;
+    };
+    const std::shared_ptr<const ParsedDocument> parsedBefore = load(before);
+    const std::shared_ptr<const ParsedDocument> parsedAfter = load(after);
+    return compare(*parsedBefore->doc, *parsedAfter->doc);
+}
+
+std::string ConfigDiff::nodePath(const pugi::xml_node& node) {
+    return pathOf(node);
+}
+
+std::string ConfigDiff::settingKey(const pugi::xml_node& node) {
+    return settingKeyOf(node, isFirstOccurrence(node), isFirstOccurrence(node.parent()));
+}
+
+pugi::xml_node ConfigDiff::findNode(const pugi::xml_document& doc, std::string_view path) {
+    pugi::xml_node node = doc.child("root");
+    std::string segment;
+    while (node && !path.empty()) {
+        // "/" всередині [мітки] не розділяє сегменти
+        std::size_t end = 0;
+        for (int depth = 0; end < path.size() && (depth > 0 || path[end] != '/'); ++end) {
+            if (path[end] == '[') ++depth;
+            else if (path[end] == ']' && depth > 0) --depth;
+        }
+        const std::string_view wanted = path.substr(0, end);
+        path.remove_prefix(std::min(path.size(), end + 1));
+
+        pugi::xml_node match;
+        for (const KeyedChild& child : keyedChildren(node)) {
+            segment.clear();
+            appendKeySegment(segment, child.key);
+            if (segment == wanted) {
+                match = child.node;
+                break;
+            }
+        }
+        node = match;
+    }
+    return node;
+}
@@ -3,34 +3,15 @@
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
-#include <unordered_set> // Потрібен для фільтрів в getFilteredSettings
 #include <vector>
 #include <map>
 #include <utility> // для std::pair
 #include <iostream> // Для std::cerr
 #include <string>   // Для std::string
-#include <algorithm> // Для std::find_if_not
-#include <cctype>   // Для std::isspace
+#include <algorithm> // Для std::find_if
+#include <cstring>  // Для std::strcmp
 
 
-namespace {
-
-std::string ltrim(std::string s) {
-    s.erase(s.begin(), std::find_if_not(s.begin(), s.end(), ::isspace));
-    return s;
-}
-
-std::string rtrim(std::string s) {
-    s.erase(std::find_if_not(s.rbegin(), s.rend(), ::isspace).base(), s.end());
-    return s;
-}
-
-std::string trim(std::string s) {
-    return ltrim(rtrim(std::move(s)));
-}
-
-}
-
 // Метод для читання всього вмісту файлу як рядка
 std::string ConfigEditor::readConfigContent(const fs::path& configPath) {
     if (!fs::exists(configPath)) {
@@ -56,38 +37,25 @@ std::string ConfigEditor::readConfigContent(const fs::path& configPath) {
 
 // Метод для отримання відфільтрованих налаштувань
 FilteredSettingsMap ConfigEditor::getFilteredSettings(const fs::path& configPath) {
+    TraceScope trace("ConfigEditor::getFilteredSettings");
     FilteredSettingsMap categorizedSettings;
 
-    // Завантаження та перевірка XML
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(configPath.wstring().c_str());
-    if (!result) {
-        throw std::runtime_error("Помилка завантаження XML: " + std::string(result.description()) + " у файлі " + configPath.string());
+    // Завантаження та перевірка XML (через кеш: після validateFile файл повторно не розбирається)
+    std::shared_ptr<const ParsedDocument> parsed = DocumentCache::instance().load(configPath);
+    if (!parsed->ok) {
+        throw std::runtime_error("Помилка завантаження XML: " + parsed->errorDescription + " у файлі " + configPath.string());
     }
 
-    pugi::xml_node root = doc.child("root");
+    pugi::xml_node root = parsed->doc->child("root");
     if (!root) {
         throw std::runtime_error("Відсутній кореневий елемент <root> у файлі: " + configPath.string());
     }
 
-    // Визначення фільтрів
-    const std::unordered_set<std::string> soundSettingsFilter = {
-        "masterVolume", "volume_micVivox", "volume_vehicles", "volume_music",
-        "volume_effects", "volume_ambient", "volume_gui", "volume_voice", "soundMode",
-        "bass_boost"
-    };
-    const std::unordered_set<std::string> controlSettingsFilter = {
-        "horzInvert", "vertInvert", "keySensitivity", "sensitivity", "scrollSensitivity"
-    };
-    const std::unordered_set<std::string> deviceSettingsFilter = {
-        "windowMode", "windowedWidth", "windowedHeight", "fullscreenWidth",
-        "fullscreenHeight", "fullscreenRefresh", "aspectRatio", "gamma", "tripleBuffering"
-    };
-    const std::vector<std::string> graphicDirectTagsFilter = {
-        "graphicsSettingsVersion", "graphicsSettingsVersionMinor", "graphicsSettingsVersionMaintainance",
-        "graphicsSettingsStatus", "ParticlSystemNoRenderGroup", "distributionLevel",
-        "colorGradingStrength", "brightnessDeferred", "contrastDeferred", "saturationDeferred"
-    };
+    // Які налаштування потрапляють у вид, визначає SettingSchema (прапорець SettingSpec::EDITOR)
+    const char* soundCategory = SettingSchema::categoryName(ConfigSection::SOUND_PREFS);
+    const char* controlCategory = SettingSchema::categoryName(ConfigSection::CONTROL_CAMERA);
+    const char* graphicsCategory = SettingSchema::categoryName(ConfigSection::GRAPHICS_PREFERENCES);
+    const char* deviceCategory = SettingSchema::categoryName(ConfigSection::DEVICE_PREFERENCES);
 
     pugi::xml_node scriptsPreferences = root.child("scriptsPreferences");
     if (scriptsPreferences) {
@@ -96,31 +64,28 @@ FilteredSettingsMap ConfigEditor::getFilteredSettings(const fs::path& configPath
         if (soundPrefs) {
             std::vector<std::pair<std::string, std::string>> currentCategorySettings;
             for (const auto& setting : soundPrefs.children()) {
-                std::string name = trim(setting.name());
-                if (soundSettingsFilter.count(name)) {
-                    currentCategorySettings.push_back({name, trim(setting.text().as_string())});
+                if (SettingSchema::isEditorSetting(ConfigSection::SOUND_PREFS, setting.name())) {
+                    currentCategorySettings.push_back({setting.name(), std::string(XmlUtil::trimmed(setting.text().as_string()))});
                 }
             }
-            if (!currentCategorySettings.empty()) categorizedSettings["Sound Settings"] = currentCategorySettings;
+            if (!currentCategorySettings.empty()) categorizedSettings[soundCategory] = std::move(currentCategorySettings);
         }
         // Керування
         pugi::xml_node controlMode = scriptsPreferences.child("controlMode");
         if (controlMode) {
             std::vector<std::pair<std::string, std::string>> currentCategorySettings;
             for (const auto& mode : controlMode.children()) {
-                std::string modeName = trim(mode.name());
                 pugi::xml_node camera = mode.child("camera");
                 if (camera) {
                     for (const auto& setting : camera.children()) {
-                        std::string settingNamePart = trim(setting.name());
-                        if (controlSettingsFilter.count(settingNamePart)) {
-                            std::string fullSettingName = modeName + "/" + settingNamePart; // Формуємо повний ключ
-                            currentCategorySettings.push_back({fullSettingName, trim(setting.text().as_string())});
+                        if (SettingSchema::isEditorControlSetting(setting.name())) {
+                            std::string fullSettingName = std::string(mode.name()) + "/" + setting.name(); // Формуємо повний ключ
+                            currentCategorySettings.push_back({std::move(fullSettingName), std::string(XmlUtil::trimmed(setting.text().as_string()))});
                         }
                     }
                 }
             }
-            if (!currentCategorySettings.empty()) categorizedSettings["Control Settings"] = currentCategorySettings;
+            if (!currentCategorySettings.empty()) categorizedSettings[controlCategory] = std::move(currentCategorySettings);
         }
     }
 
@@ -128,23 +93,22 @@ FilteredSettingsMap ConfigEditor::getFilteredSettings(const fs::path& configPath
     pugi::xml_node graphicsPreferences = root.child("graphicsPreferences");
     if (graphicsPreferences) {
         std::vector<std::pair<std::string, std::string>> currentCategorySettings;
-        // Обробка прямих тегів
-        for(const std::string& tagName : graphicDirectTagsFilter) {
-            pugi::xml_node node = graphicsPreferences.child(tagName.c_str());
-            if(node) {
-                currentCategorySettings.push_back({tagName, trim(node.text().as_string())});
+        // Прямі теги (у порядку таблиці схеми, перше входження) і потім усі <entry> з <label>
+        auto directTags = SettingSchema::sectionSpecs(ConfigSection::GRAPHICS_PREFERENCES);
+        for (const SettingSpec* spec = directTags.first; spec != directTags.second; ++spec) {
+            if (!(spec->flags & SettingSpec::EDITOR)) continue;
+            pugi::xml_node node = graphicsPreferences.child(spec->tag);
+            if (node) {
+                currentCategorySettings.push_back({spec->tag, std::string(XmlUtil::trimmed(node.text().as_string()))});
             }
         }
-        // Обробка тегів <entry>
         for (const auto& entry : graphicsPreferences.children("entry")) {
-            std::string label = entry.child_value("label");
-            std::string trimmed_label = trim(label);
+            std::string trimmed_label = std::string(XmlUtil::trimmed(entry.child_value("label")));
             if (!trimmed_label.empty()) {
-                std::string activeOption = entry.child_value("activeOption");
-                currentCategorySettings.push_back({trimmed_label, trim(activeOption)});
+                currentCategorySettings.push_back({std::move(trimmed_label), std::string(XmlUtil::trimmed(entry.child_value("activeOption")))});
             }
         }
-        if (!currentCategorySettings.empty()) categorizedSettings["Graphics Settings"] = currentCategorySettings;
+        if (!currentCategorySettings.empty()) categorizedSettings[graphicsCategory] = std::move(currentCategorySettings);
     }
 
     // Пристрій
@@ -152,112 +116,227 @@ FilteredSettingsMap ConfigEditor::getFilteredSettings(const fs::path& configPath
     if (devicePreferences) {
         std::vector<std::pair<std::string, std::string>> currentCategorySettings;
         for (const auto& setting : devicePreferences.children()) {
-            std::string name = trim(setting.name());
-            if (deviceSettingsFilter.count(name)) {
-                currentCategorySettings.push_back({name, trim(setting.text().as_string())});
+            if (SettingSchema::isEditorSetting(ConfigSection::DEVICE_PREFERENCES, setting.name())) {
+                currentCategorySettings.push_back({setting.name(), std::string(XmlUtil::trimmed(setting.text().as_string()))});
             }
         }
-        if (!currentCategorySettings.empty()) categorizedSettings["Device Settings"] = currentCategorySettings;
+        if (!currentCategorySettings.empty()) categorizedSettings[deviceCategory] = std::move(currentCategorySettings);
     }
 
     return categorizedSettings;
 }
 
-// Метод для збереження змін в XML
-void ConfigEditor::saveFilteredSettings(const fs::path& configPath, const FilteredSettingsMap& settings) {
-    pugi::xml_document doc;
-    pugi::xml_parse_result loadResult = doc.load_file(configPath.wstring().c_str());
-
-    if (!loadResult) {
-        throw std::runtime_error("Не вдалося завантажити файл для збереження: " + configPath.string() + " (" + loadResult.description() + ")");
+// Потоковий варіант getFilteredSettings: DOM не будується, у пам'яті лише поточний блок файлу
+FilteredSettingsMap ConfigEditor::getFilteredSettingsStreaming(const fs::path& configPath) {
+    TraceScope trace("ConfigEditor::getFilteredSettingsStreaming");
+    std::ifstream file(configPath, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Не вдалося відкрити файл конфігурації: " + configPath.string());
     }
 
-    pugi::xml_node root = doc.child("root");
-    if (!root) {
-        throw std::runtime_error("Не знайдено <root> елемент у файлі: " + configPath.string());
+    FilteredSettingsReader reader;
+    std::vector<char> chunk(64 * 1024);
+    try {
+        while (file) {
+            file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            std::streamsize got = file.gcount();
+            if (got > 0) reader.feed(chunk.data(), static_cast<std::size_t>(got));
+        }
+        if (file.bad()) {
+            throw std::runtime_error("Помилка читання файлу конфігурації");
+        }
+        return reader.finish();
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Помилка завантаження XML: " + std::string(e.what()) + " у файлі " + configPath.string());
     }
+}
 
-    for (const auto& categoryPair : settings) {
-        const std::string& categoryName = categoryPair.first;
-        const auto& settingsInCategory = categoryPair.second;
-
-        pugi::xml_node categoryNode;
-        pugi::xml_node scriptsPrefsNode;
-        pugi::xml_node graphicsPrefsNode;
-
-        if (categoryName == "Sound Settings") {
-            scriptsPrefsNode = root.child("scriptsPreferences");
-            if (scriptsPrefsNode) categoryNode = scriptsPrefsNode.child("soundPrefs");
-        } else if (categoryName == "Graphics Settings") {
-            graphicsPrefsNode = root.child("graphicsPreferences");
-            categoryNode = graphicsPrefsNode;
-        } else if (categoryName == "Control Settings") {
-            scriptsPrefsNode = root.child("scriptsPreferences");
-            if (scriptsPrefsNode) categoryNode = scriptsPrefsNode.child("controlMode");
-        } else if (categoryName == "Device Settings") {
-            categoryNode = root.child("devicePreferences");
-        }
+FilteredSettingsMap ConfigEditor::extractFilteredSettings(const char* data, std::size_t size) {
+    FilteredSettingsReader reader;
+    reader.feed(data, size);
+    return reader.finish();
+}
 
-        if (!categoryNode) {
-            std::cerr << "Warning: Category node not found in XML for category during save: " << categoryName << std::endl;
-            continue;
+// Метод для збереження змін в XML: записуються лише значення, що відрізняються від документа
+SettingChangeSet ConfigEditor::saveFilteredSettings(const fs::path& configPath, const FilteredSettingsMap& settings) {
+    TraceScope trace("ConfigEditor::saveFilteredSettings");
+    SettingChangeSet changes;
+    for (const auto& categoryPair : settings) {
+        for (const auto& settingPair : categoryPair.second) {
+            changes.push_back({categoryPair.first, settingPair.first, "", settingPair.second});
         }
+    }
+    return saveSettingChanges(configPath, changes);
+}
 
-        for (const auto& settingPair : settingsInCategory) {
-            const std::string& settingName = settingPair.first;
-            const std::string& newValue = settingPair.second;
-
-            pugi::xml_node settingNode;
-
-            if (categoryName == "Control Settings" && settingName.find('/') != std::string::npos) {
-                size_t slashPos = settingName.find('/');
-                std::string modeName = settingName.substr(0, slashPos);
-                std::string actualSettingName = settingName.substr(slashPos + 1);
-                pugi::xml_node modeNode = categoryNode.child(modeName.c_str());
-                if(modeNode) {
-                    pugi::xml_node cameraNode = modeNode.child("camera");
-                    if(cameraNode) {
-                        settingNode = cameraNode.child(actualSettingName.c_str());
-                    } else {
-                        std::cerr << "Warning: <camera> node not found for mode '" << modeName << "' during save." << std::endl; continue;
-                    }
+SettingChangeSet ConfigEditor::diffSettings(const FilteredSettingsMap& before, const FilteredSettingsMap& after) {
+    SettingChangeSet changes;
+    for (const auto& categoryPair : after) {
+        auto beforeCategory = before.find(categoryPair.first);
+        const auto& settingsInCategory = categoryPair.second;
+        for (std::size_t i = 0; i < settingsInCategory.size(); ++i) {
+            const auto& settingPair = settingsInCategory[i];
+            const std::string* oldValue = nullptr;
+            if (beforeCategory != before.end()) {
+                // Діалог зберігає порядок ключів, тож спершу перевіряється та сама позиція
+                const auto& list = beforeCategory->second;
+                if (i < list.size() && list[i].first == settingPair.first) {
+                    oldValue = &list[i].second;
                 } else {
-                    std::cerr << "Warning: Control mode node not found: '" << modeName << "' during save." << std::endl; continue;
+                    auto it = std::find_if(list.begin(), list.end(), [&](const auto& p) { return p.first == settingPair.first; });
+                    if (it != list.end()) oldValue = &it->second;
                 }
             }
-            else if (categoryName == "Graphics Settings") {
-                settingNode = categoryNode.child(settingName.c_str());
-                if (!settingNode) {
-                    bool foundEntry = false;
-                    for (pugi::xml_node entry : categoryNode.children("entry")) {
-                        if (trim(entry.child_value("label")) == settingName) {
-                            settingNode = entry.child("activeOption");
-                            foundEntry = true;
-                            break;
-                        }
-                    }
-                    if (!foundEntry) {
-                        std::cerr << "Warning: Graphics node (direct or entry/label) not found for key: " << settingName << " during save." << std::endl;
-                        continue;
-                    }
-                }
+            if (oldValue && *oldValue == settingPair.second) continue;
+            changes.push_back({categoryPair.first, settingPair.first, oldValue ? *oldValue : "", settingPair.second});
+        }
+    }
+    return changes;
+}
+
+SettingChangeSet ConfigEditor::saveSettingChanges(const fs::path& configPath, const SettingChangeSet& changes) {
+    TraceScope trace("ConfigEditor::saveSettingChanges");
+    if (changes.empty()) return {}; // Нічого не змінено - файл не читається і не записується
+
+    std::shared_ptr<const ParsedDocument> parsed = DocumentCache::instance().load(configPath);
+
+    if (!parsed->ok) {
+        throw std::runtime_error("Не вдалося завантажити файл для збереження: " + configPath.string() + " (" + parsed->errorDescription + ")");
+    }
+
+    // Кешований документ лише читається: спершу визначаються значення, які справді змінюються
+    const pugi::xml_document& cached = *parsed->doc;
+    if (!cached.child("root")) {
+        throw std::runtime_error("Не знайдено <root> елемент у файлі: " + configPath.string());
+    }
+    // Вузли значень знаходяться за індексом, побудованим при завантаженні документа,
+    // тож кожне налаштування - один пошук у хеш-таблиці замість обходу секції
+    std::shared_ptr<const SettingNodeIndex> cachedIndex = parsed->index ? parsed->index : SettingNodeIndex::build(cached);
+
+    static const ConfigSection kCategorySections[] = {
+        ConfigSection::SOUND_PREFS, ConfigSection::CONTROL_CAMERA,
+        ConfigSection::GRAPHICS_PREFERENCES, ConfigSection::DEVICE_PREFERENCES
+    };
+
+    SettingChangeSet applied;
+    std::vector<ConfigSection> appliedSections; // Секція кожної зміни з applied
+    const std::string* lastCategory = nullptr;
+    const ConfigSection* section = nullptr;
+
+    for (const SettingChange& change : changes) {
+        // Зміни зазвичай згруповані за категоріями, тож секція визначається раз на групу
+        if (!lastCategory || *lastCategory != change.category) {
+            lastCategory = &change.category;
+            section = nullptr;
+            for (const ConfigSection& candidate : kCategorySections) {
+                if (change.category == SettingSchema::categoryName(candidate)) { section = &candidate; break; }
             }
-            // Обробка для інших категорій (Sound, Device)
-            else {
-                settingNode = categoryNode.child(settingName.c_str());
+            if (!section || !cachedIndex->hasSection(*section)) {
+                section = nullptr;
+                std::cerr << "Warning: Category node not found in XML for category during save: " << change.category << std::endl;
             }
+        }
+        if (!section) continue;
 
-            if (settingNode) {
-                if (!settingNode.text().set(newValue.c_str())) {
-                    std::cerr << "Warning: Failed to set text for node: " << settingName << std::endl;
-                }
-            } else {
-                std::cerr << "Warning: Setting node could not be found in XML for key: '" << settingName << "' in category '" << categoryName << "' during save." << std::endl;
-            }
+        pugi::xml_node settingNode = cachedIndex->find(*section, change.key);
+        if (!settingNode) {
+            std::cerr << "Warning: Setting node could not be found in XML for key: '" << change.key << "' in category '" << change.category << "' during save." << std::endl;
+            continue;
+        }
+
+        std::string currentValue = std::string(XmlUtil::trimmed(settingNode.text().as_string()));
+        if (currentValue == change.newValue) continue; // Значення вже таке - вузол не чіпаємо
+        applied.push_back({change.category, change.key, std::move(currentValue), change.newValue});
+        appliedSections.push_back(*section);
+    }
+
+    if (applied.empty()) return applied; // Документ не змінився - копія і запис на диск не потрібні
+
+    // Зміни вносяться в приватну копію: інші власники кешованого документа бачать незмінну версію,
+    // а після невдалого запису кеш і далі відповідає файлу
+    std::shared_ptr<pugi::xml_document> doc = DocumentCache::copyDocument(*parsed);
+    std::shared_ptr<const SettingNodeIndex> index = SettingNodeIndex::build(*doc);
+    for (std::size_t i = 0; i < applied.size(); ++i) {
+        pugi::xml_node settingNode = index->find(appliedSections[i], applied[i].key);
+        if (!settingNode || !settingNode.text().set(applied[i].newValue.c_str())) {
+            throw std::runtime_error("Не вдалося змінити значення '" + applied[i].key + "' у файлі: " + configPath.string());
+        }
+    }
+
+    try {
+        AtomicFile::saveDocument(configPath, *doc);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Не вдалося зберегти зміни у файл: " + configPath.string() + " (" + e.what() + ")");
+    }
+    DocumentCache::instance().store(configPath, std::move(doc), std::move(index));
+    return applied;
+}
+
+const SettingSpec* ConfigEditor::nodeSpec(const pugi::xml_node& node, std::string& key) {
+    key.clear();
+    if (node.type() != pugi::node_element) return nullptr;
+    for (const pugi::xml_node& child : node.children()) {
+        if (child.type() == pugi::node_element) return nullptr; // Секція, а не значення
+    }
+    key = ConfigDiff::settingKey(node);
+    if (!key.empty()) return SettingSchema::findKey(key);
+
+    // Прямі теги scriptsPreferences (напр. fov) не мають ключа у FilteredSettingsMap, але мають правило
+    const pugi::xml_node parent = node.parent();
+    if (std::strcmp(parent.name(), "scriptsPreferences") == 0 && std::strcmp(parent.parent().name(), "root") == 0) {
+        if (const SettingSpec* spec = SettingSchema::find(ConfigSection::SCRIPTS_PREFERENCES, node.name())) {
+            key = node.name();
+            return spec;
         }
     }
+    return nullptr;
+}
+
+bool ConfigEditor::checkNodeValue(const pugi::xml_node& node, const std::string& value, std::string& error) {
+    std::string key;
+    const SettingSpec* spec = nodeSpec(node, key);
+    if (!spec) return true;
+    if (spec->type == SettingType::NON_EDITABLE) {
+        error = key + ": значення не редагується.";
+        return false;
+    }
+    return SettingSchema::checkValue(*spec, key, value.c_str(), error);
+}
+
+SettingChange ConfigEditor::saveNodeValue(const fs::path& configPath, const std::string& nodePath,
+                                          const std::string& expectedValue, const std::string& newValue) {
+    TraceScope trace("ConfigEditor::saveNodeValue");
+    std::shared_ptr<const ParsedDocument> parsed = DocumentCache::instance().load(configPath);
+    if (!parsed->ok) {
+        throw std::runtime_error("Не вдалося завантажити файл для збереження: " + configPath.string() + " (" + parsed->errorDescription + ")");
+    }
+
+    // Як і saveSettingChanges: перевірки - на кешованому документі, зміна - у приватній копії
+    pugi::xml_node node = ConfigDiff::findNode(*parsed->doc, nodePath);
+    if (!node) {
+        throw std::runtime_error("Елемент '" + nodePath + "' не знайдено у файлі: " + configPath.string());
+    }
+    std::string error;
+    if (!checkNodeValue(node, newValue, error)) {
+        throw std::runtime_error("Неприпустиме значення: " + error);
+    }
+    std::string currentValue = std::string(XmlUtil::trimmed(node.child_value()));
+    if (currentValue != expectedValue) {
+        throw std::runtime_error("Елемент '" + nodePath + "' змінено поза редактором (у файлі: '" + currentValue + "'). Відкрийте файл заново.");
+    }
+    SettingChange change{"XML", nodePath, std::move(currentValue), newValue};
+    if (change.oldValue == change.newValue) return change; // Файл уже містить це значення
 
-    if (!doc.save_file(configPath.wstring().c_str())) {
-        throw std::runtime_error("Не вдалося зберегти зміни у файл: " + configPath.string());
+    std::shared_ptr<pugi::xml_document> doc = DocumentCache::copyDocument(*parsed);
+    pugi::xml_node copyNode = ConfigDiff::findNode(*doc, nodePath);
+    if (!copyNode || !copyNode.text().set(newValue.c_str())) {
+        throw std::runtime_error("Не вдалося змінити значення елемента '" + nodePath + "'.");
+    }
+    try {
+        AtomicFile::saveDocument(configPath, *doc);
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error("Не вдалося зберегти зміни у файл: " + configPath.string() + " (" + e.what() + ")");
     }
+    DocumentCache::instance().store(configPath, std::move(doc)); // Індекс будується для копії
+    return change;
 }
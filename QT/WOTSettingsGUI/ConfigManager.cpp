@@ -1,4 +1,5 @@
 #include "main.h" // Головний заголовок
+#include "pugixml/pugixml.hpp"
 #include <fstream>
 #include <sstream>
 #include <vector>
@@ -24,8 +25,26 @@ fs::path ConfigManager::getCurrentGameConfigPath() {
     return getGameConfigPathInternal();
 }
 
+// Знімок останнього застосованого конфігу користувача - база для тристороннього злиття
+fs::path ConfigManager::appliedBasePath() {
+    return fs::path("User Data") / "applied-base.xml";
+}
+
+// Керовані значення бази - ті, що користувач застосував востаннє, тож базою є сам конфіг користувача.
+// Невдалий запис бази не скасовує застосування: наступне злиття просто візьме значення користувача.
+void ConfigManager::recordAppliedBase(const fs::path& sourceConfigPath) {
+    try {
+        const fs::path basePath = appliedBasePath();
+        fs::create_directories(basePath.parent_path());
+        AtomicFile::copy(sourceConfigPath, basePath);
+    } catch (const std::exception& e) {
+        std::cerr << "Попередження: не вдалося зберегти базу для злиття конфігів: " << e.what() << std::endl;
+    }
+}
+
 // Приймає шлях до конфігу користувача, кидає виняток при помилці
 void ConfigManager::changeCurrentConfig(const fs::path& sourceConfigPath) {
+    TraceScope trace("ConfigManager::changeCurrentConfig");
     if (!fs::exists(sourceConfigPath)) {
         throw std::runtime_error("Обраний файл конфігурації користувача не знайдено: " + sourceConfigPath.string());
     }
@@ -36,17 +55,64 @@ void ConfigManager::changeCurrentConfig(const fs::path& sourceConfigPath) {
     fs::path targetPath = getGameConfigPathInternal();
     fs::path targetDir = targetPath.parent_path();
 
-    // Застосування (копіювання з заміною)
+    // Застосування (атомарна заміна)
     try {
         if (!fs::exists(targetDir)) {
             fs::create_directories(targetDir);
         }
-        fs::copy_file(sourceConfigPath, targetPath, fs::copy_options::overwrite_existing);
+        AtomicFile::copy(sourceConfigPath, targetPath); // Гра ніколи не побачить обрізаний файл
     } catch (const fs::filesystem_error& e) {
         throw std::runtime_error(std::string("Помилка файлової системи при застосуванні конфігу: ") + e.what());
+    } catch (const std::runtime_error& e) {
+        throw std::runtime_error(std::string("Помилка запису конфігу гри: ") + e.what());
     } catch (...) {
         throw std::runtime_error("Невідома помилка під час застосування конфігу.");
     }
+    recordAppliedBase(sourceConfigPath);
+}
+
+// Застосовує лише керовані налаштування, решта файлу гри (дані, записані грою) зберігається
+ConfigMergeResult ConfigManager::mergeIntoCurrentConfig(const fs::path& sourceConfigPath, ConfigMerge::ConflictPolicy policy) {
+    TraceScope trace("ConfigManager::mergeIntoCurrentConfig");
+    if (!fs::is_regular_file(sourceConfigPath)) {
+        throw std::runtime_error("Обраний файл конфігурації користувача не знайдено: " + sourceConfigPath.string());
+    }
+    const fs::path targetPath = getGameConfigPathInternal();
+    if (!fs::exists(targetPath)) {
+        changeCurrentConfig(sourceConfigPath); // Зливати нема з чим
+        return {};
+    }
+
+    // Розбір без DocumentCache: ours змінюється на місці, а файли одноразові
+    auto parse = [](const fs::path& path, const char* what) {
+        std::shared_ptr<const ParsedDocument> parsed = DocumentCache::parseFile(path);
+        if (!parsed->ok) {
+            throw std::runtime_error(std::string("Не вдалося розібрати ") + what + ": " + path.string() + " (" + parsed->errorDescription + ")");
+        }
+        return parsed;
+    };
+    const std::shared_ptr<const ParsedDocument> theirs = parse(sourceConfigPath, "конфіг користувача");
+    const std::shared_ptr<const ParsedDocument> ours = parse(targetPath, "поточний конфіг гри");
+    std::shared_ptr<const ParsedDocument> base;
+    if (fs::exists(appliedBasePath())) {
+        base = DocumentCache::parseFile(appliedBasePath());
+        if (!base->ok) {
+            std::cerr << "Попередження: база для злиття пошкоджена, використовуються значення користувача." << std::endl;
+            base.reset();
+        }
+    }
+
+    ConfigMergeResult result = ConfigMerge::merge(base ? base->doc.get() : nullptr, *ours->doc, *theirs->doc, policy);
+    if (!result.applied.empty()) {
+        try {
+            AtomicFile::saveDocument(targetPath, *ours->doc);
+        } catch (const std::runtime_error& e) {
+            throw std::runtime_error(std::string("Помилка запису конфігу гри: ") + e.what());
+        }
+        DocumentCache::instance().invalidate(targetPath);
+    }
+    recordAppliedBase(sourceConfigPath);
+    return result;
 }
 
 // Читає та повертає вміст поточного конфігу гри
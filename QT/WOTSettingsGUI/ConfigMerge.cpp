@@ -0,0 +1,68 @@
+#include "main.h" // Головний заголовок (містить оголошення ConfigMerge)
+#include "pugixml/pugixml.hpp"
+
+namespace {
+
+// Секції, якими керує програма (scriptsPreferences поза soundPrefs/controlMode гра веде сама)
+constexpr ConfigSection kManagedSections[] = {
+    ConfigSection::SOUND_PREFS, ConfigSection::CONTROL_CAMERA, ConfigSection::GRAPHICS_PREFERENCES,
+    ConfigSection::GRAPHICS_ENTRY, ConfigSection::DEVICE_PREFERENCES,
+};
+
+}
+
+ConfigMergeResult ConfigMerge::merge(const pugi::xml_document* base, pugi::xml_document& ours, const pugi::xml_document& theirs,
+                                     ConflictPolicy policy) {
+    TraceScope trace("ConfigMerge::merge");
+    if (!ours.child("root") || !theirs.child("root")) {
+        throw std::runtime_error("Не знайдено <root> елемент у файлі гри або в конфігу користувача.");
+    }
+    ConfigMergeResult result;
+    result.hadBase = base && base->child("root");
+
+    const std::shared_ptr<const SettingNodeIndex> oursIndex = SettingNodeIndex::build(ours);
+    const std::shared_ptr<const SettingNodeIndex> theirsIndex = SettingNodeIndex::build(theirs);
+    const std::shared_ptr<const SettingNodeIndex> baseIndex = result.hadBase ? SettingNodeIndex::build(*base) : nullptr;
+
+    std::string key;
+    for (ConfigSection section : kManagedSections) {
+        const auto range = SettingSchema::sectionSpecs(section);
+        for (const SettingSpec* spec = range.first; spec != range.second; ++spec) {
+            if (spec->type == SettingType::NON_EDITABLE) continue;
+            ++result.managedKeys;
+            key.assign(spec->tag);
+
+            const pugi::xml_node theirsNode = theirsIndex->find(section, key);
+            if (!theirsNode) continue; // Конфіг користувача цього налаштування не задає
+            const pugi::xml_node oursNode = oursIndex->find(section, key);
+            if (!oursNode) {
+                result.missingKeys.push_back(key);
+                continue;
+            }
+            const std::string_view theirsValue = XmlUtil::trimmed(theirsNode.text().as_string());
+            const std::string_view oursValue = XmlUtil::trimmed(oursNode.text().as_string());
+            if (theirsValue == oursValue) continue;
+
+            const std::string category = SettingSchema::categoryName(section);
+            // Без бази (або без вузла в ній) зміну гри не відрізнити від старого значення - застосовується theirs
+            const pugi::xml_node baseNode = baseIndex ? baseIndex->find(section, key) : pugi::xml_node();
+            const bool oursChanged = baseNode && XmlUtil::trimmed(baseNode.text().as_string()) != oursValue;
+            const bool theirsChanged = !baseNode || XmlUtil::trimmed(baseNode.text().as_string()) != theirsValue;
+
+            if (oursChanged && !theirsChanged) {
+                result.kept.push_back({category, key, std::string(theirsValue), std::string(oursValue)});
+                continue;
+            }
+            if (oursChanged) {
+                result.conflicts.push_back({category, key, std::string(oursValue), std::string(theirsValue)});
+                if (policy == ConflictPolicy::OURS) continue;
+            }
+            SettingChange change{category, key, std::string(oursValue), std::string(theirsValue)};
+            if (!oursNode.text().set(change.newValue.c_str())) {
+                throw std::runtime_error("Не вдалося змінити значення '" + key + "' у файлі гри.");
+            }
+            result.applied.push_back(std::move(change));
+        }
+    }
+    return result;
+}
@@ -0,0 +1,240 @@
+#include "main.h" // Головний заголовок (містить оголошення ConfigWatcher)
+#include <algorithm>
+#include <cctype>
+#include <condition_variable>
+#include <iostream>
+#include <set>
+#include <thread>
+#ifdef __linux__
+#include <cerrno>
+#include <poll.h>        // Для poll
+#include <sys/inotify.h> // Для inotify_init1, inotify_add_watch
+#include <unistd.h>      // Для read, pipe, close
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Абсолютний шлях без "." і кінцевого "/": так само складаються шляхи з подій (директорія / ім'я)
+fs::path watchPath(const fs::path& path) {
+    fs::path normal = fs::absolute(path).lexically_normal();
+    if (!normal.has_filename() && normal.has_parent_path()) normal = normal.parent_path();
+    return normal;
+}
+
+bool isXmlFile(const fs::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return std::tolower(c); });
+    return extension == ".xml";
+}
+
+}
+
+struct ConfigWatcher::State {
+    std::chrono::milliseconds debounce;
+    std::set<fs::path> files;       // Окремі файли (спостерігається їхня директорія)
+    std::set<fs::path> directories; // Усі *.xml у директорії (без вкладених)
+    Callback callback;
+    std::thread thread;
+    std::map<fs::path, Clock::time_point> pending; // Шлях -> момент, після якого подія вважається завершеною
+
+    bool matches(const fs::path& path) const {
+        return files.count(path) || (directories.count(path.parent_path()) && isXmlFile(path));
+    }
+    void touch(const fs::path& path) {
+        if (matches(path)) pending[path] = Clock::now() + debounce;
+    }
+    // Шляхи, що не змінювались довше за debounce; решта лишається чекати
+    std::vector<fs::path> takeSettled() {
+        std::vector<fs::path> settled;
+        const Clock::time_point now = Clock::now();
+        for (auto it = pending.begin(); it != pending.end();) {
+            if (it->second <= now) {
+                settled.push_back(it->first);
+                it = pending.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return settled;
+    }
+    // Скільки чекати до найближчого завершення (нескінченно, якщо подій немає)
+    std::chrono::milliseconds untilNextDeadline() const {
+        if (pending.empty()) return std::chrono::milliseconds::max();
+        Clock::time_point earliest = Clock::time_point::max();
+        for (const auto& entry : pending) earliest = std::min(earliest, entry.second);
+        return std::max(std::chrono::milliseconds(0), std::chrono::ceil<std::chrono::milliseconds>(earliest - Clock::now()));
+    }
+    void deliver() {
+        const std::vector<fs::path> settled = takeSettled();
+        if (settled.empty()) return;
+        try {
+            callback(settled);
+        } catch (const std::exception& e) {
+            std::cerr << "ConfigWatcher: помилка обробки змін: " << e.what() << std::endl;
+        }
+    }
+
+#ifdef __linux__
+    int inotifyFd = -1;
+    int wakePipe[2] = {-1, -1}; // Запис у wakePipe[1] будить потік для зупинки
+    std::map<int, fs::path> watchedDirectories; // Дескриптор inotify -> директорія
+
+    void open() {
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd < 0 || pipe(wakePipe) != 0) {
+            close();
+            throw std::runtime_error("Не вдалося ініціалізувати inotify для стеження за конфігами.");
+        }
+        std::set<fs::path> dirs = directories;
+        for (const fs::path& file : files) dirs.insert(file.parent_path());
+        // IN_MODIFY продовжує дебаунс на кожному блоці запису; заміна через rename - IN_MOVED_TO
+        const uint32_t mask = IN_CLOSE_WRITE | IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM;
+        for (const fs::path& dir : dirs) {
+            const int wd = inotify_add_watch(inotifyFd, dir.c_str(), mask);
+            if (wd < 0) {
+                std::cerr << "ConfigWatcher: директорію не можна відстежувати: " << dir.string() << std::endl;
+                continue;
+            }
+            watchedDirectories[wd] = dir;
+        }
+    }
+    void close() {
+        if (inotifyFd >= 0) ::close(inotifyFd);
+        if (wakePipe[0] >= 0) ::close(wakePipe[0]);
+        if (wakePipe[1] >= 0) ::close(wakePipe[1]);
+        inotifyFd = wakePipe[0] = wakePipe[1] = -1;
+        watchedDirectories.clear();
+    }
+    void wake() {
+        const char byte = 0;
+        if (wakePipe[1] >= 0 && ::write(wakePipe[1], &byte, 1) < 0) {
+            std::cerr << "ConfigWatcher: не вдалося розбудити потік стеження" << std::endl;
+        }
+    }
+    void readEvents() {
+        alignas(inotify_event) char buffer[16 * 1024];
+        for (;;) {
+            const ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+            if (length <= 0) return; // EAGAIN - подій більше немає
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += sizeof(inotify_event) + event->len;
+                if (event->mask & IN_Q_OVERFLOW) {
+                    // Частину подій втрачено: вважаються зміненими всі окремі файли
+                    for (const fs::path& file : files) touch(file);
+                    continue;
+                }
+                auto dir = watchedDirectories.find(event->wd);
+                if (dir != watchedDirectories.end() && event->len > 0) touch(dir->second / event->name);
+            }
+        }
+    }
+    void run() {
+        for (;;) {
+            const std::chrono::milliseconds wait = untilNextDeadline();
+            pollfd fds[2] = {{wakePipe[0], POLLIN, 0}, {inotifyFd, POLLIN, 0}};
+            const int timeout = wait == std::chrono::milliseconds::max() ? -1 : static_cast<int>(std::min<std::int64_t>(wait.count(), 60000));
+            const int ready = ::poll(fds, 2, timeout);
+            if (ready < 0 && errno != EINTR) break;
+            if (fds[0].revents) break; // stop()
+            if (ready > 0 && (fds[1].revents & POLLIN)) readEvents();
+            deliver();
+        }
+    }
+#else
+    // Без inotify: опитування часу зміни і розміру з інтервалом у половину дебаунсу
+    struct Snapshot {
+        fs::file_time_type writeTime{};
+        std::uintmax_t size = 0;
+        bool operator!=(const Snapshot& other) const { return writeTime != other.writeTime || size != other.size; }
+    };
+    std::map<fs::path, Snapshot> snapshots;
+    std::mutex stopMutex;
+    std::condition_variable stopCondition;
+    bool stopping = false;
+
+    std::map<fs::path, Snapshot> scan() const {
+        std::map<fs::path, Snapshot> current;
+        auto add = [&](const fs::path& path) {
+            std::error_code ec;
+            Snapshot snapshot;
+            snapshot.writeTime = fs::last_write_time(path, ec);
+            if (ec) return;
+            snapshot.size = fs::file_size(path, ec);
+            if (!ec) current[path] = snapshot;
+        };
+        for (const fs::path& file : files) add(file);
+        std::error_code ec;
+        for (const fs::path& dir : directories) {
+            for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+                if (isXmlFile(it->path())) add(it->path());
+            }
+        }
+        return current;
+    }
+    void open() {
+        stopping = false;
+        snapshots = scan();
+    }
+    void close() {}
+    void wake() {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+        stopCondition.notify_all();
+    }
+    void run() {
+        const std::chrono::milliseconds interval = std::max(std::chrono::milliseconds(100), debounce / 2);
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(stopMutex);
+                if (stopCondition.wait_for(lock, std::min(interval, untilNextDeadline()), [this] { return stopping; })) break;
+            }
+            std::map<fs::path, Snapshot> current = scan();
+            for (const auto& entry : current) {
+                auto old = snapshots.find(entry.first);
+                if (old == snapshots.end() || old->second != entry.second) touch(entry.first);
+            }
+            for (const auto& entry : snapshots) {
+                if (!current.count(entry.first)) touch(entry.first); // Видалено
+            }
+            snapshots = std::move(current);
+            deliver();
+        }
+    }
+#endif
+};
+
+ConfigWatcher::ConfigWatcher(std::chrono::milliseconds debounce) : m_state(std::make_unique<State>()) {
+    m_state->debounce = debounce;
+}
+
+ConfigWatcher::~ConfigWatcher() {
+    stop();
+}
+
+void ConfigWatcher::addFile(const fs::path& filePath) {
+    if (m_state->thread.joinable()) throw std::runtime_error("ConfigWatcher: шляхи додаються до start().");
+    m_state->files.insert(watchPath(filePath));
+}
+
+void ConfigWatcher::addDirectory(const fs::path& directory) {
+    if (m_state->thread.joinable()) throw std::runtime_error("ConfigWatcher: шляхи додаються до start().");
+    m_state->directories.insert(watchPath(directory));
+}
+
+void ConfigWatcher::start(Callback callback) {
+    if (m_state->thread.joinable()) return;
+    m_state->callback = std::move(callback);
+    m_state->open();
+    m_state->thread = std::thread([state = m_state.get()] { state->run(); });
+}
+
+void ConfigWatcher::stop() {
+    if (!m_state->thread.joinable()) return;
+    m_state->wake();
+    m_state->thread.join();
+    m_state->close();
+    m_state->pending.clear();
+}
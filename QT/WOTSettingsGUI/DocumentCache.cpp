@@ -0,0 +1,144 @@
+#include "main.h" // Головний заголовок (містить оголошення DocumentCache та ParsedDocument)
+#include "pugixml/pugixml.hpp"
+#include <system_error>
+#include <utility>
+
+namespace {
+
+// Ключ кешу: абсолютний нормалізований шлях, щоб "a/../b.xml" і "b.xml" збігались
+fs::path makeKey(const fs::path& filePath) {
+    std::error_code ec;
+    fs::path absolutePath = fs::absolute(filePath, ec);
+    return (ec ? filePath : absolutePath).lexically_normal();
+}
+
+// Поточна версія файлу на диску (false, якщо файл недоступний)
+bool statFile(const fs::path& filePath, fs::file_time_type& writeTime, std::uintmax_t& fileSize) {
+    std::error_code ec;
+    writeTime = fs::last_write_time(filePath, ec);
+    if (ec) return false;
+    fileSize = fs::file_size(filePath, ec);
+    return !ec;
+}
+
+}
+
+DocumentCache& DocumentCache::instance() {
+    static DocumentCache cache;
+    return cache;
+}
+
+std::shared_ptr<const ParsedDocument> DocumentCache::parseFile(const fs::path& filePath) {
+    return parseDocument(filePath, false);
+}
+
+std::shared_ptr<pugi::xml_document> DocumentCache::copyDocument(const ParsedDocument& parsed) {
+    TraceScope trace("DocumentCache::copy");
+    auto copy = std::make_shared<pugi::xml_document>();
+    if (parsed.doc) copy->reset(*parsed.doc);
+    return copy;
+}
+
+std::shared_ptr<const ParsedDocument> DocumentCache::parseDocument(const fs::path& filePath, bool buildIndex) {
+    TraceScope trace("DocumentCache::parse");
+    auto parsed = std::make_shared<ParsedDocument>();
+    statFile(filePath, parsed->writeTime, parsed->fileSize);
+
+    auto doc = std::make_shared<pugi::xml_document>();
+    pugi::xml_parse_result result = doc->load_file(filePath.wstring().c_str());
+    parsed->ok = (result.status == pugi::status_ok);
+    parsed->errorDescription = result.description();
+    parsed->errorOffset = result.offset;
+    if (parsed->ok) {
+        // Індекс потрібен лише документам, які редагуються (saveFilteredSettings)
+        if (buildIndex) parsed->index = SettingNodeIndex::build(*doc);
+        parsed->doc = std::move(doc);
+    }
+    return parsed;
+}
+
+std::shared_ptr<const ParsedDocument> DocumentCache::load(const fs::path& filePath) {
+    const fs::path key = makeKey(filePath);
+
+    fs::file_time_type writeTime{};
+    std::uintmax_t fileSize = 0;
+    const bool statOk = statFile(filePath, writeTime, fileSize);
+
+    if (statOk) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_slots.find(key);
+        if (it != m_slots.end()) {
+            if (it->second.entry->writeTime == writeTime && it->second.entry->fileSize == fileSize) {
+                it->second.lastUse = ++m_useCounter;
+                return it->second.entry;
+            }
+            m_slots.erase(it); // Файл змінився - стара версія більше не потрібна
+        }
+    }
+
+    // Розбір і побудова індексу вузлів виконуються поза блокуванням, щоб паралельні запити до інших файлів не чекали
+    std::shared_ptr<const ParsedDocument> parsed = parseDocument(filePath, true);
+
+    // Файли, які не вдалося навіть stat-нути, не кешуємо: ключа версії немає
+    if (statOk) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        insertLocked(key, parsed);
+    }
+    return parsed;
+}
+
+void DocumentCache::store(const fs::path& filePath, std::shared_ptr<pugi::xml_document> doc,
+                          std::shared_ptr<const SettingNodeIndex> index) {
+    const fs::path key = makeKey(filePath);
+
+    auto parsed = std::make_shared<ParsedDocument>();
+    if (!doc || !statFile(filePath, parsed->writeTime, parsed->fileSize)) {
+        invalidate(filePath);
+        return;
+    }
+    parsed->ok = true;
+    parsed->errorDescription = "No error";
+    parsed->index = index ? std::move(index) : SettingNodeIndex::build(*doc);
+    parsed->doc = std::move(doc);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slots.erase(key);
+    insertLocked(key, std::move(parsed));
+}
+
+void DocumentCache::invalidate(const fs::path& filePath) {
+    const fs::path key = makeKey(filePath);
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slots.erase(key);
+}
+
+void DocumentCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_slots.clear();
+}
+
+void DocumentCache::setCapacity(std::size_t capacity) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_capacity = capacity > 0 ? capacity : 1;
+    while (m_slots.size() > m_capacity) {
+        auto oldest = m_slots.begin();
+        for (auto it = m_slots.begin(); it != m_slots.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+        }
+        m_slots.erase(oldest);
+    }
+}
+
+// Викликається під m_mutex. Витісняє найдавніше використаний запис, якщо кеш заповнений.
+void DocumentCache::insertLocked(const fs::path& key, std::shared_ptr<const ParsedDocument> entry) {
+    if (m_slots.find(key) == m_slots.end() && m_slots.size() >= m_capacity) {
+        auto oldest = m_slots.begin();
+        for (auto it = m_slots.begin(); it != m_slots.end(); ++it) {
+            if (it->second.lastUse < oldest->second.lastUse) oldest = it;
+        }
+        m_slots.erase(oldest);
+    }
+    Slot& slot = m_slots[key];
+    slot.entry = std::move(entry);
+    slot.lastUse = ++m_useCounter;
+}
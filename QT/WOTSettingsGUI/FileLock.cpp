@@ -0,0 +1,56 @@
+#include "main.h" // Головний заголовок (містить оголошення FileLock)
+#include <cerrno>
+#include <stdexcept>
+#ifdef _WIN32
+#include <windows.h> // Для CreateFileW, LockFileEx
+#else
+#include <fcntl.h>    // Для open
+#include <sys/file.h> // Для flock
+#include <unistd.h>   // Для close
+#endif
+
+FileLock::FileLock(const fs::path& lockPath, Mode mode) {
+#ifdef _WIN32
+    HANDLE handle = CreateFileW(lockPath.wstring().c_str(), GENERIC_READ | GENERIC_WRITE,
+                                FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        if (GetLastError() == ERROR_PATH_NOT_FOUND) return;
+        throw std::runtime_error("Не вдалося відкрити файл блокування: " + lockPath.string());
+    }
+    OVERLAPPED overlapped = {};
+    const DWORD flags = mode == Mode::Exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0;
+    if (!LockFileEx(handle, flags, 0, MAXDWORD, MAXDWORD, &overlapped)) {
+        CloseHandle(handle);
+        throw std::runtime_error("Не вдалося заблокувати файл: " + lockPath.string());
+    }
+    m_handle = handle;
+#else
+    const int fd = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        if (errno == ENOENT) return;
+        throw std::runtime_error("Не вдалося відкрити файл блокування: " + lockPath.string());
+    }
+    int result;
+    do {
+        result = flock(fd, mode == Mode::Exclusive ? LOCK_EX : LOCK_SH);
+    } while (result != 0 && errno == EINTR);
+    if (result != 0) {
+        close(fd);
+        throw std::runtime_error("Не вдалося заблокувати файл: " + lockPath.string());
+    }
+    m_fd = fd;
+#endif
+}
+
+FileLock::~FileLock() {
+#ifdef _WIN32
+    if (m_handle) {
+        OVERLAPPED overlapped = {};
+        UnlockFileEx(static_cast<HANDLE>(m_handle), 0, MAXDWORD, MAXDWORD, &overlapped);
+        CloseHandle(static_cast<HANDLE>(m_handle));
+    }
+#else
+    if (m_fd >= 0) close(m_fd); // Закриття знімає flock
+#endif
+}
@@ -6,34 +6,38 @@
 #include <string>
 #include <limits>    // Для numeric_limits (якщо потрібен)
 #include <iostream>  // Для std::cerr у внутрішніх методах
-#include <QMessageBox> // Для вікон повідомлень у validateBeforeAction
-#include <QString>     // Для роботи з QMessageBox
+#include <chrono>    // Для вимірювання часу пакетної валідації
+#include <algorithm> // Для std::sort
+#include <cctype>    // Для std::tolower
 
 
 namespace {
-bool tryParseFloat(const char* text, float& outValue) {
-    if (!text) return false;
-    std::string s(text);
-    std::istringstream iss(s);
-    iss >> outValue;
-    char remaining;
-    return !iss.fail() && !(iss >> remaining);
+void checkNode(const SettingSpec* spec, const pugi::xml_node& valueNode, std::vector<std::string>& errors) {
+    if (!spec || !valueNode) return;
+    std::string error;
+    if (!SettingSchema::checkValue(*spec, spec->tag, valueNode.text().as_string(), error)) {
+        errors.push_back(std::move(error));
+    }
 }
-bool tryParseInt(const char* text, int& outValue) {
-    if (!text) return false;
-    std::string s(text);
-    std::istringstream iss(s);
-    iss >> outValue;
-    char remaining;
-    return !iss.fail() && !(iss >> remaining);
+
+// Один прохід по прямих дочірніх елементах секції з пошуком правила в таблиці
+void checkSectionChildren(const pugi::xml_node& sectionNode, ConfigSection section, std::vector<std::string>& errors) {
+    for (const pugi::xml_node& child : sectionNode.children()) {
+        if (child.type() != pugi::node_element) continue;
+        checkNode(SettingSchema::find(section, child.name()), child, errors);
+    }
 }
 }
 
 
 // Реалізація основного методу валідації
 ValidationResult FileValidator::validateFile(const fs::path& filePath) {
+    return validateFileInternal(filePath, true);
+}
+
+ValidationResult FileValidator::validateFileInternal(const fs::path& filePath, bool useCache) {
+    TraceScope trace("FileValidator::validateFile");
     ValidationResult result;
-    pugi::xml_document doc;
 
     if (!fs::exists(filePath)) {
         result.wellFormedError = "Файл не знайдено: " + filePath.string();
@@ -44,9 +48,12 @@ ValidationResult FileValidator::validateFile(const fs::path& filePath) {
         return result; // isWellFormed = false
     }
 
-    // Перевірка Well-Formed
+    // Перевірка Well-Formed (документ береться зі спільного кешу, тож подальші
+    // getFilteredSettings/saveFilteredSettings для цієї ж версії файлу не розбирають його знову)
+    std::shared_ptr<const ParsedDocument> parsed = useCache ? DocumentCache::instance().load(filePath)
+                                                            : DocumentCache::parseFile(filePath);
     std::string wfError;
-    result.isWellFormed = isXmlWellFormedInternal(filePath, doc, wfError);
+    result.isWellFormed = isXmlWellFormedInternal(*parsed, wfError);
     if (!result.isWellFormed) {
         result.wellFormedError = wfError;
         return result;
@@ -54,6 +61,7 @@ ValidationResult FileValidator::validateFile(const fs::path& filePath) {
 
     // Перевірка структури (тільки якщо XML коректний)
     std::string structWarn;
+    const pugi::xml_document& doc = *parsed->doc;
     result.hasStructure = hasExpectedStructureInternal(doc, structWarn);
     result.structureInfo = structWarn; // Записуємо повідомлення (може бути "OK" або попередження)
 
@@ -63,71 +71,143 @@ ValidationResult FileValidator::validateFile(const fs::path& filePath) {
     return result;
 }
 
-// Реалізація допоміжного методу для GUI
-bool FileValidator::validateBeforeAction(const fs::path& filePath, const std::string& actionNameStd, bool showSuccess) {
-    QString actionName = QString::fromStdString(actionNameStd);
-    ValidationResult result = validateFile(filePath);
+BatchValidationReport FileValidator::validateFiles(const std::vector<fs::path>& filePaths, unsigned threadCount) {
+    BatchValidationReport report;
+    report.threadCount = threadCount > 0 ? threadCount : WorkerPool::defaultThreadCount();
+    report.results.resize(filePaths.size());
+
+    const auto start = std::chrono::steady_clock::now();
 
-    if (result.isValid()) {
-        QString summary;
-        bool hasWarnings = false;
+    // Кожен потік пише лише у свою комірку results, тож синхронізація не потрібна.
+    // Кеш документів не використовується: тисячі файлів витіснили б робочі документи GUI.
+    WorkerPool::forEach(filePaths.size(), report.threadCount, [&](std::size_t i) {
+        auto& entry = report.results[i];
+        entry.first = filePaths[i];
+        try {
+            entry.second = validateFileInternal(filePaths[i], false);
+        } catch (const std::exception& e) {
+            entry.second = ValidationResult();
+            entry.second.wellFormedError = std::string("Помилка під час валідації: ") + e.what();
+        }
+    });
 
-        summary += "XML: OK.\n";
-        summary += QString("Структура: %1\n").arg(QString::fromStdString(result.structureInfo));
-        if (!result.hasStructure) hasWarnings = true;
+    report.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
 
-        if (result.valueErrors.empty()) {
-            summary += "Значення: OK.";
+    for (const auto& entry : report.results) {
+        if (!entry.second.isValid()) ++report.invalidCount;
+        else if (entry.second.hasWarnings()) ++report.warningCount;
+        else ++report.validCount;
+    }
+    return report;
+}
+
+BatchValidationReport FileValidator::validateDirectory(const fs::path& directory, bool recursive, unsigned threadCount) {
+    if (!fs::exists(directory) || !fs::is_directory(directory)) {
+        throw std::runtime_error("Директорію для валідації не знайдено: " + directory.string());
+    }
+    return validateFiles(collectXmlFiles(directory, recursive), threadCount);
+}
+
+std::vector<fs::path> FileValidator::collectXmlFiles(const fs::path& directory, bool recursive) {
+    std::vector<fs::path> files;
+    auto isXml = [](const fs::path& p) {
+        std::string ext = p.extension().string();
+        std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return ext == ".xml";
+    };
+    try {
+        if (recursive) {
+            for (const auto& entry : fs::recursive_directory_iterator(directory, fs::directory_options::skip_permission_denied)) {
+                if (entry.is_regular_file() && isXml(entry.path())) files.push_back(entry.path());
+            }
         } else {
-            summary += QString("Значення: Знайдено %1 потенційних проблем.").arg(result.valueErrors.size());
-            hasWarnings = true;
-            summary += "\nПриклади помилок значень:\n";
-            int count = 0;
-            for(const auto& err : result.valueErrors) {
-                if (++count > 3) {
-                    summary += "- ...\n";
-                    break;
-                }
-                summary += QString("- %1\n").arg(QString::fromStdString(err));
+            for (const auto& entry : fs::directory_iterator(directory, fs::directory_options::skip_permission_denied)) {
+                if (entry.is_regular_file() && isXml(entry.path())) files.push_back(entry.path());
             }
         }
+    } catch (const fs::filesystem_error& e) {
+        throw std::runtime_error(std::string("Помилка файлової системи при скануванні директорії: ") + e.what());
+    }
+    std::sort(files.begin(), files.end()); // Стабільний порядок звіту незалежно від ФС
+    return files;
+}
 
-        if (hasWarnings) {
-            QMessageBox::StandardButton reply;
-            QString warningText = QString("Увага! Файл '%1' містить попередження:\n\n%2\n\nПродовжити дію '%3'?")
-                                      .arg(QString::fromStdWString(filePath.filename().wstring()))
-                                      .arg(summary)
-                                      .arg(actionName);
-            reply = QMessageBox::warning(nullptr, actionName + " - Попередження валідації",
-                                         warningText,
-                                         QMessageBox::Yes | QMessageBox::No,
-                                         QMessageBox::No);
-            return (reply == QMessageBox::Yes);
-        } else {
-            if (showSuccess) {
-                QMessageBox::information(nullptr, actionName + " - Валідація успішна",
-                                         QString("Файл '%1' успішно пройшов валідацію.")
-                                             .arg(QString::fromStdWString(filePath.filename().wstring())));
+namespace {
+std::mutex& defaultPromptMutex() {
+    static std::mutex m;
+    return m;
+}
+std::shared_ptr<ValidationPrompt>& defaultPromptSlot() {
+    static std::shared_ptr<ValidationPrompt> prompt = std::make_shared<HeadlessValidationPrompt>();
+    return prompt;
+}
+}
+
+void FileValidator::setDefaultPrompt(std::shared_ptr<ValidationPrompt> prompt) {
+    std::lock_guard<std::mutex> lock(defaultPromptMutex());
+    defaultPromptSlot() = prompt ? std::move(prompt) : std::make_shared<HeadlessValidationPrompt>();
+}
+
+std::shared_ptr<ValidationPrompt> FileValidator::defaultPrompt() {
+    std::lock_guard<std::mutex> lock(defaultPromptMutex());
+    return defaultPromptSlot();
+}
+
+// Перевірка перед дією: текст зведення формується тут, показ/рішення - у ValidationPrompt
+bool FileValidator::validateBeforeAction(const fs::path& filePath, const std::string& actionNameStd, bool showSuccess) {
+    return confirmBeforeAction(filePath, validateFile(filePath), actionNameStd, showSuccess);
+}
+
+bool FileValidator::confirmBeforeAction(const fs::path& filePath, const ValidationResult& result, const std::string& actionNameStd, bool showSuccess) {
+    std::shared_ptr<ValidationPrompt> prompt = m_prompt ? m_prompt : defaultPrompt();
+
+    if (!result.isValid()) { // Критична помилка XML
+        prompt->reportFailure(filePath, actionNameStd, result.wellFormedError);
+        return false;
+    }
+
+    if (!result.hasWarnings()) {
+        if (showSuccess) prompt->reportSuccess(filePath, actionNameStd);
+        return true;
+    }
+
+    std::string summary = "XML: OK.\n";
+    summary += "Структура: " + result.structureInfo + "\n";
+    if (result.valueErrors.empty()) {
+        summary += "Значення: OK.";
+    } else {
+        summary += "Значення: Знайдено " + std::to_string(result.valueErrors.size()) + " потенційних проблем.";
+        summary += "\nПриклади помилок значень:\n";
+        int count = 0;
+        for (const auto& err : result.valueErrors) {
+            if (++count > 3) {
+                summary += "- ...\n";
+                break;
             }
-            return true;
+            summary += "- " + err + "\n";
         }
-    } else { // Критична помилка XML
-        QMessageBox::critical(nullptr, actionName + " - Помилка валідації",
-                              QString("Не вдалося виконати дію '%1'.\nФайл '%2' не пройшов валідацію:\n%3")
-                                  .arg(actionName)
-                                  .arg(QString::fromStdWString(filePath.filename().wstring()))
-                                  .arg(QString::fromStdString(result.wellFormedError)));
-        return false;
     }
+    return prompt->confirmWarnings(filePath, actionNameStd, summary);
 }
 
+bool HeadlessValidationPrompt::confirmWarnings(const fs::path& filePath, const std::string& actionName, const std::string& summary) {
+    if (m_verbose) {
+        std::cerr << "WARNING: '" << filePath.filename().string() << "' (" << actionName << "):\n" << summary << std::endl;
+    }
+    return m_acceptWarnings;
+}
+
+void HeadlessValidationPrompt::reportFailure(const fs::path& filePath, const std::string& actionName, const std::string& error) {
+    if (m_verbose) {
+        std::cerr << "ERROR: '" << filePath.filename().string() << "' (" << actionName << "): " << error << std::endl;
+    }
+}
 
-bool FileValidator::isXmlWellFormedInternal(const fs::path& filePath, pugi::xml_document& doc, std::string& errorMsg) {
-    pugi::xml_parse_result result = doc.load_file(filePath.c_str());
-    if (result.status != pugi::status_ok) {
+bool FileValidator::isXmlWellFormedInternal(const ParsedDocument& parsed, std::string& errorMsg) {
+    if (!parsed.ok) {
         // Формуємо повідомлення про помилку
         std::stringstream ss;
-        ss << "Помилка XML: " << result.description() << " (позиція " << result.offset << ")";
+        ss << "Помилка XML: " << parsed.errorDescription << " (позиція " << parsed.errorOffset << ")";
         errorMsg = ss.str();
         return false;
     }
@@ -174,124 +254,51 @@ bool FileValidator::hasExpectedStructureInternal(const pugi::xml_document& doc,
     return structureOk;
 }
 
+std::vector<std::string> FileValidator::checkValues(const pugi::xml_document& doc) {
+    return findInvalidSimpleValuesInternal(doc);
+}
+
 std::vector<std::string> FileValidator::findInvalidSimpleValuesInternal(const pugi::xml_document& doc) {
     std::vector<std::string> errors;
     const pugi::xml_node root = doc.child("root");
     if (!root) return {"Помилка: Відсутній <root> елемент для перевірки значень."};
 
-    // Перевірка <soundPrefs>
-    const pugi::xml_node scriptsPrefs = root.child("scriptsPreferences");
-    if (scriptsPrefs) {
-        const pugi::xml_node soundPrefs = scriptsPrefs.child("soundPrefs");
-        if (soundPrefs) {
-            const std::vector<std::string> volumeTags = { // список тегів гучності
-                "masterVolume", "volume_micVivox", "volume_vehicles", "volume_music",
-                "volume_effects", "volume_ambient", "volume_gui", "volume_voice",
-                "volume_masterFadeVivox", "volume_masterVivox", "volume_music_hangar",
-                "volume_ev_ambient", "volume_ev_effects", "volume_ev_gui",
-                "volume_ev_music", "volume_ev_vehicles", "volume_ev_voice"
-            };
-            for (const std::string& tagName : volumeTags) {
-                pugi::xml_node node = soundPrefs.child(tagName.c_str());
-                if (node) {
-                    float value;
-                    const char* text = node.text().as_string();
-                    if (tryParseFloat(text, value)) {
-                        if (value < 0.0f || value > 1.0f) {
-                            errors.push_back("<" + tagName + ">: '" + text + "'. Очікується [0.0, 1.0].");
-                        }
-                    } else {
-                        errors.push_back("<" + tagName + ">: '" + text + "'. Очікується число.");
-                    }
-                }
-            }
-        }
-
-        // Перевірка <fov>
-        const pugi::xml_node fovNode = scriptsPrefs.child("fov");
-        if(fovNode) {
-            float value;
-            const char* text = fovNode.text().as_string();
-            if(tryParseFloat(text, value)) {
-                if (value < 50.0f || value > 130.0f) { // Допустимий діапазон FOV
-                    errors.push_back("<fov>: '" + std::string(text) + "'. Нетипове значення (очікується 50-130).");
-                }
-            } else {
-                errors.push_back("<fov>: '" + std::string(text) + "'. Очікується число.");
-            }
-        }
+    // Типи та діапазони беруться з SettingSchema (ті самі, що й у редакторі)
+    for (const pugi::xml_node& section : root.children()) {
+        if (section.type() != pugi::node_element) continue;
+        const std::string_view sectionName = section.name();
 
-    }
-
-    // Перевірка <devicePreferences>
-    const pugi::xml_node devicePrefs = root.child("devicePreferences");
-    if (devicePrefs) {
-        // Window Mode
-        pugi::xml_node wmNode = devicePrefs.child("windowMode");
-        if (wmNode) {
-            int value;
-            const char* text = wmNode.text().as_string();
-            if(tryParseInt(text, value)) {
-                if (value < 0 || value > 2) { // 0 - вікно, 1 - повноекранне вікно, 2 - повний екран
-                    errors.push_back("<windowMode>: '" + std::string(text) + "'. Очікується 0, 1, або 2.");
-                }
-            } else {
-                errors.push_back("<windowMode>: '" + std::string(text) + "'. Очікується ціле число.");
-            }
-        }
-        // Resolutions
-        const std::vector<std::pair<std::string, int>> resolutionTags = {
-            {"windowedWidth", 640}, {"windowedHeight", 480},
-            {"fullscreenWidth", 800}, {"fullscreenHeight", 600}
-        };
-        for (const auto& pair : resolutionTags) {
-            pugi::xml_node resNode = devicePrefs.child(pair.first.c_str());
-            if(resNode) {
-                int value;
-                const char* text = resNode.text().as_string();
-                if(tryParseInt(text, value)) {
-                    if (value < pair.second) {
-                        errors.push_back("<" + pair.first + ">: '" + text + "'. Очікується >= " + std::to_string(pair.second) + ".");
+        if (sectionName == "scriptsPreferences") {
+            for (const pugi::xml_node& child : section.children()) {
+                if (child.type() != pugi::node_element) continue;
+                const std::string_view name = child.name();
+                if (name == "soundPrefs") {
+                    checkSectionChildren(child, ConfigSection::SOUND_PREFS, errors);
+                } else if (name == "controlMode") {
+                    for (const pugi::xml_node& mode : child.children()) {
+                        const pugi::xml_node camera = mode.child("camera");
+                        for (const pugi::xml_node& setting : camera.children()) {
+                            if (setting.type() != pugi::node_element) continue;
+                            checkNode(SettingSchema::findControl(mode.name(), setting.name()), setting, errors);
+                        }
                     }
                 } else {
-                    errors.push_back("<" + pair.first + ">: '" + text + "'. Очікується ціле число.");
-                }
-            }
-        }
-        // Refresh Rate
-        pugi::xml_node rrNode = devicePrefs.child("fullscreenRefresh");
-        if(rrNode) {
-            int value;
-            const char* text = rrNode.text().as_string();
-            if(tryParseInt(text, value)) {
-                if (value < 10 || value > 400) {
-                    errors.push_back("<fullscreenRefresh>: '" + std::string(text) + "'. Нетипове значення (очікується 50-240).");
+                    checkNode(SettingSchema::find(ConfigSection::SCRIPTS_PREFERENCES, name), child, errors);
                 }
-            } else {
-                errors.push_back("<fullscreenRefresh>: '" + std::string(text) + "'. Очікується ціле число.");
             }
-        }
-    }
-
-    // Перевірка графіки
-    const pugi::xml_node graphPrefs = root.child("graphicsPreferences");
-    if (graphPrefs) {
-        const std::vector<std::string> graphTags = {
-            "colorGradingStrength", "brightnessDeferred", "contrastDeferred", "saturationDeferred"
-        };
-        for (const std::string& tagName : graphTags) {
-            pugi::xml_node node = graphPrefs.child(tagName.c_str());
-            if (node) {
-                float value;
-                const char* text = node.text().as_string();
-                if (tryParseFloat(text, value)) {
-                    if (value < 0.0f || value > 1.5f) {
-                        errors.push_back("<" + tagName + ">: '" + text + "'. Нетипове значення (очікується ~[0.0, 1.0]).");
-                    }
+        } else if (sectionName == "graphicsPreferences") {
+            // Прямі теги та записи <entry> перевіряються в одному проході
+            for (const pugi::xml_node& child : section.children()) {
+                if (child.type() != pugi::node_element) continue;
+                if (std::string_view(child.name()) == "entry") {
+                    const std::string_view label = XmlUtil::trimmed(child.child_value("label"));
+                    checkNode(SettingSchema::find(ConfigSection::GRAPHICS_ENTRY, label), child.child("activeOption"), errors);
                 } else {
-                    errors.push_back("<" + tagName + ">: '" + text + "'. Очікується число.");
+                    checkNode(SettingSchema::find(ConfigSection::GRAPHICS_PREFERENCES, child.name()), child, errors);
                 }
             }
+        } else if (sectionName == "devicePreferences") {
+            checkSectionChildren(section, ConfigSection::DEVICE_PREFERENCES, errors);
         }
     }
 
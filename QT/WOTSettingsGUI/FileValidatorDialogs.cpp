@@ -0,0 +1,33 @@
+#include "mainwindow.h" // Оголошення MessageBoxValidationPrompt
+#include <QMessageBox> // Для вікон повідомлень у validateBeforeAction
+#include <QString>     // Для роботи з QMessageBox
+
+// Реалізація ValidationPrompt для GUI (єдина частина валідації, що залежить від Qt Widgets)
+bool MessageBoxValidationPrompt::confirmWarnings(const fs::path& filePath, const std::string& actionNameStd, const std::string& summary) {
+    QString actionName = QString::fromStdString(actionNameStd);
+    QString warningText = QString("Увага! Файл '%1' містить попередження:\n\n%2\n\nПродовжити дію '%3'?")
+                              .arg(QString::fromStdWString(filePath.filename().wstring()))
+                              .arg(QString::fromStdString(summary))
+                              .arg(actionName);
+    QMessageBox::StandardButton reply = QMessageBox::warning(nullptr, actionName + " - Попередження валідації",
+                                                             warningText,
+                                                             QMessageBox::Yes | QMessageBox::No,
+                                                             QMessageBox::No);
+    return (reply == QMessageBox::Yes);
+}
+
+void MessageBoxValidationPrompt::reportSuccess(const fs::path& filePath, const std::string& actionNameStd) {
+    QString actionName = QString::fromStdString(actionNameStd);
+    QMessageBox::information(nullptr, actionName + " - Валідація успішна",
+                             QString("Файл '%1' успішно пройшов валідацію.")
+                                 .arg(QString::fromStdWString(filePath.filename().wstring())));
+}
+
+void MessageBoxValidationPrompt::reportFailure(const fs::path& filePath, const std::string& actionNameStd, const std::string& error) {
+    QString actionName = QString::fromStdString(actionNameStd);
+    QMessageBox::critical(nullptr, actionName + " - Помилка валідації",
+                          QString("Не вдалося виконати дію '%1'.\nФайл '%2' не пройшов валідацію:\n%3")
+                              .arg(actionName)
+                              .arg(QString::fromStdWString(filePath.filename().wstring()))
+                              .arg(QString::fromStdString(error)));
+}
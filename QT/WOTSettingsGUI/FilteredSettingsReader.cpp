@@ -0,0 +1,450 @@
+#include "main.h" // Головний заголовок (містить FilteredSettingsReader, SettingSchema, FilteredSettingsMap)
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+// Роль відкритого елемента: визначає, що робити з його дочірніми елементами та текстом
+enum class Role {
+    IGNORED,          // Піддерево поза фільтром - лише перевірка парності тегів
+    ROOT,
+    SCRIPTS,          // scriptsPreferences
+    SOUND,            // scriptsPreferences/soundPrefs
+    CONTROL,          // scriptsPreferences/controlMode
+    MODE,             // controlMode/<режим>
+    CAMERA,           // controlMode/<режим>/camera
+    GRAPHICS,         // graphicsPreferences
+    ENTRY,            // graphicsPreferences/entry
+    DEVICE,           // devicePreferences
+    SOUND_VALUE,
+    CONTROL_VALUE,
+    GRAPHICS_VALUE,   // Прямий тег graphicsPreferences
+    DEVICE_VALUE,
+    ENTRY_LABEL,
+    ENTRY_OPTION
+};
+
+struct Frame {
+    Role role;
+    std::size_t nameOffset; // Початок імені в State::names
+    std::size_t slot;       // Для GRAPHICS_VALUE - індекс у sectionSpecs(GRAPHICS_PREFERENCES)
+};
+
+bool isCaptureRole(Role role) {
+    return role == Role::SOUND_VALUE || role == Role::CONTROL_VALUE || role == Role::GRAPHICS_VALUE ||
+           role == Role::DEVICE_VALUE || role == Role::ENTRY_LABEL || role == Role::ENTRY_OPTION;
+}
+
+bool isXmlSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+void appendUtf8(std::string& out, unsigned long cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+// Декодування тексту так, як це робить pugixml з parse_default (parse_escapes + parse_eol).
+// Невідомі або некоректні посилання залишаються як є.
+std::string decodeText(std::string_view raw) {
+    std::string out;
+    out.reserve(raw.size());
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        char c = raw[i];
+        if (c == '\r') {
+            out += '\n';
+            if (i + 1 < raw.size() && raw[i + 1] == '\n') ++i;
+            continue;
+        }
+        if (c != '&') {
+            out += c;
+            continue;
+        }
+        std::size_t semi = raw.find(';', i + 1);
+        if (semi == std::string_view::npos) {
+            out += c;
+            continue;
+        }
+        std::string_view ref = raw.substr(i + 1, semi - i - 1);
+        if (ref == "lt") out += '<';
+        else if (ref == "gt") out += '>';
+        else if (ref == "amp") out += '&';
+        else if (ref == "quot") out += '"';
+        else if (ref == "apos") out += '\'';
+        else if (ref.size() > 1 && ref[0] == '#') {
+            const bool hex = ref[1] == 'x';
+            std::string_view digits = ref.substr(hex ? 2 : 1);
+            unsigned long cp = 0;
+            bool ok = !digits.empty() && digits.size() <= 8;
+            for (char d : digits) {
+                int v = -1;
+                if (d >= '0' && d <= '9') v = d - '0';
+                else if (hex && d >= 'a' && d <= 'f') v = d - 'a' + 10;
+                else if (hex && d >= 'A' && d <= 'F') v = d - 'A' + 10;
+                if (v < 0) { ok = false; break; }
+                cp = cp * (hex ? 16 : 10) + static_cast<unsigned long>(v);
+            }
+            if (!ok || cp > 0x10FFFF) {
+                out += c;
+                continue;
+            }
+            appendUtf8(out, cp);
+        } else {
+            out += c;
+            continue;
+        }
+        i = semi;
+    }
+    return out;
+}
+
+} // namespace
+
+struct FilteredSettingsReader::State {
+    std::string buffer;          // Ще не розібраний хвіст вхідних даних
+    std::size_t consumed = 0;    // Скільки байтів уже відкинуто з початку buffer (для позицій у помилках)
+    std::size_t peakBuffer = 0;
+
+    std::string names;           // Імена відкритих елементів підряд (стек без окремих алокацій)
+    std::vector<Frame> stack;
+
+    // Текст поточного захоплюваного елемента (лише прямі текстові вузли, перший непорожній)
+    std::string pendingText;
+    std::string capturedText;
+    bool hasCapturedText = false;
+
+    bool rootSeen = false, scriptsSeen = false, graphicsSeen = false, deviceSeen = false;
+    bool soundSeen = false, controlSeen = false, cameraSeen = false;
+    bool labelSeen = false, optionSeen = false;
+    std::string entryLabel, entryOption;
+
+    std::pair<const SettingSpec*, const SettingSpec*> graphicsSpecs;
+    std::vector<std::pair<bool, std::string>> graphicsSlots; // Перше входження кожного прямого тегу
+
+    std::vector<std::pair<std::string, std::string>> sound, control, graphicsEntries, device;
+
+    State()
+        : graphicsSpecs(SettingSchema::sectionSpecs(ConfigSection::GRAPHICS_PREFERENCES)),
+          graphicsSlots(static_cast<std::size_t>(graphicsSpecs.second - graphicsSpecs.first)) {}
+
+    [[noreturn]] void fail(const std::string& what, std::size_t offset) const {
+        throw std::runtime_error("Помилка XML: " + what + " (позиція " + std::to_string(consumed + offset) + ")");
+    }
+
+    Role topRole() const { return stack.empty() ? Role::IGNORED : stack.back().role; }
+    std::string_view topName() const {
+        return std::string_view(names).substr(stack.back().nameOffset);
+    }
+
+    // Роль нового дочірнього елемента залежно від ролі батька
+    Role childRole(std::string_view name, std::size_t& slot) {
+        switch (topRole()) {
+        case Role::ROOT:
+            if (name == "scriptsPreferences" && !scriptsSeen) { scriptsSeen = true; return Role::SCRIPTS; }
+            if (name == "graphicsPreferences" && !graphicsSeen) { graphicsSeen = true; return Role::GRAPHICS; }
+            if (name == "devicePreferences" && !deviceSeen) { deviceSeen = true; return Role::DEVICE; }
+            return Role::IGNORED;
+        case Role::SCRIPTS:
+            if (name == "soundPrefs" && !soundSeen) { soundSeen = true; return Role::SOUND; }
+            if (name == "controlMode" && !controlSeen) { controlSeen = true; return Role::CONTROL; }
+            return Role::IGNORED;
+        case Role::SOUND:
+            return SettingSchema::isEditorSetting(ConfigSection::SOUND_PREFS, name) ? Role::SOUND_VALUE : Role::IGNORED;
+        case Role::CONTROL:
+            cameraSeen = false;
+            return Role::MODE;
+        case Role::MODE:
+            if (name == "camera" && !cameraSeen) { cameraSeen = true; return Role::CAMERA; }
+            return Role::IGNORED;
+        case Role::CAMERA:
+            return SettingSchema::isEditorControlSetting(name) ? Role::CONTROL_VALUE : Role::IGNORED;
+        case Role::GRAPHICS: {
+            if (name == "entry") {
+                labelSeen = optionSeen = false;
+                entryLabel.clear();
+                entryOption.clear();
+                return Role::ENTRY;
+            }
+            const SettingSpec* spec = SettingSchema::find(ConfigSection::GRAPHICS_PREFERENCES, name);
+            if (!spec || !(spec->flags & SettingSpec::EDITOR)) return Role::IGNORED;
+            slot = static_cast<std::size_t>(spec - graphicsSpecs.first);
+            return graphicsSlots[slot].first ? Role::IGNORED : Role::GRAPHICS_VALUE;
+        }
+        case Role::DEVICE:
+            return SettingSchema::isEditorSetting(ConfigSection::DEVICE_PREFERENCES, name) ? Role::DEVICE_VALUE : Role::IGNORED;
+        case Role::ENTRY:
+            if (name == "label" && !labelSeen) { labelSeen = true; return Role::ENTRY_LABEL; }
+            if (name == "activeOption" && !optionSeen) { optionSeen = true; return Role::ENTRY_OPTION; }
+            return Role::IGNORED;
+        default:
+            if (stack.empty() && name == "root" && !rootSeen) { rootSeen = true; return Role::ROOT; }
+            return Role::IGNORED;
+        }
+    }
+
+    void openElement(std::string_view name) {
+        std::size_t slot = 0;
+        Role role = childRole(name, slot);
+        stack.push_back({role, names.size(), slot});
+        names.append(name.data(), name.size());
+        if (isCaptureRole(role)) {
+            capturedText.clear();
+            hasCapturedText = false;
+        }
+    }
+
+    void closeElement() {
+        const Frame frame = stack.back();
+        std::string_view name = topName();
+        switch (frame.role) {
+        case Role::SOUND_VALUE:
+            sound.emplace_back(std::string(name), std::string(XmlUtil::trimmed(capturedText)));
+            break;
+        case Role::DEVICE_VALUE:
+            device.emplace_back(std::string(name), std::string(XmlUtil::trimmed(capturedText)));
+            break;
+        case Role::CONTROL_VALUE: {
+            // Стек: ... controlMode / <режим> / camera / <налаштування>
+            const Frame& modeFrame = stack[stack.size() - 3];
+            std::string_view modeName = std::string_view(names).substr(modeFrame.nameOffset, stack[stack.size() - 2].nameOffset - modeFrame.nameOffset);
+            std::string key;
+            key.reserve(modeName.size() + 1 + name.size());
+            key.append(modeName.data(), modeName.size()).append(1, '/').append(name.data(), name.size());
+            control.emplace_back(std::move(key), std::string(XmlUtil::trimmed(capturedText)));
+            break;
+        }
+        case Role::GRAPHICS_VALUE:
+            graphicsSlots[frame.slot] = {true, std::string(XmlUtil::trimmed(capturedText))};
+            break;
+        case Role::ENTRY_LABEL:
+            entryLabel = capturedText;
+            break;
+        case Role::ENTRY_OPTION:
+            entryOption = capturedText;
+            break;
+        case Role::ENTRY: {
+            std::string label = std::string(XmlUtil::trimmed(entryLabel));
+            if (!label.empty()) graphicsEntries.emplace_back(std::move(label), std::string(XmlUtil::trimmed(entryOption)));
+            break;
+        }
+        default:
+            break;
+        }
+        names.resize(frame.nameOffset);
+        stack.pop_back();
+    }
+
+    // Текстовий вузол завершився (далі йде розмітка). Як і в pugixml, вузли лише з пробілів не враховуються.
+    void flushText() {
+        if (pendingText.empty()) return;
+        if (isCaptureRole(topRole()) && !hasCapturedText &&
+            !std::all_of(pendingText.begin(), pendingText.end(), isXmlSpace)) {
+            capturedText = decodeText(pendingText);
+            hasCapturedText = true;
+        }
+        pendingText.clear();
+    }
+
+    void cdata(std::string_view content) {
+        if (isCaptureRole(topRole()) && !hasCapturedText) {
+            capturedText.clear(); // CDATA не декодується, лише нормалізуються кінці рядків
+            for (std::size_t i = 0; i < content.size(); ++i) {
+                if (content[i] == '\r') {
+                    capturedText += '\n';
+                    if (i + 1 < content.size() && content[i + 1] == '\n') ++i;
+                } else {
+                    capturedText += content[i];
+                }
+            }
+            hasCapturedText = true;
+        }
+    }
+
+    // Кінець тегу '>' з урахуванням лапок в атрибутах; npos - тег ще не отримано повністю
+    std::size_t findTagEnd(std::size_t from) const {
+        // Швидкий шлях: атрибутів з лапками до першого '>' немає (типово для preferences.xml)
+        std::size_t gt = buffer.find('>', from);
+        if (gt == std::string::npos) return gt;
+        const char* begin = buffer.data() + from;
+        const std::size_t length = gt - from;
+        if (!std::memchr(begin, '"', length) && !std::memchr(begin, '\'', length)) return gt;
+
+        char quote = 0;
+        for (std::size_t i = from; i < buffer.size(); ++i) {
+            char c = buffer[i];
+            if (quote) {
+                if (c == quote) quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '>') {
+                return i;
+            }
+        }
+        return std::string::npos;
+    }
+
+    std::size_t findDoctypeEnd(std::size_t from) const {
+        int depth = 0;
+        char quote = 0;
+        for (std::size_t i = from; i < buffer.size(); ++i) {
+            char c = buffer[i];
+            if (quote) {
+                if (c == quote) quote = 0;
+            } else if (c == '"' || c == '\'') {
+                quote = c;
+            } else if (c == '[') {
+                ++depth;
+            } else if (c == ']') {
+                --depth;
+            } else if (c == '>' && depth <= 0) {
+                return i;
+            }
+        }
+        return std::string::npos;
+    }
+
+    // Розбирає одну конструкцію розмітки з позиції pos ('<'). Повертає false, якщо даних ще недостатньо.
+    bool parseMarkup(std::size_t& pos, bool final) {
+        const std::string_view rest = std::string_view(buffer).substr(pos);
+        auto startsWith = [&](const char* prefix) { return rest.compare(0, std::strlen(prefix), prefix) == 0; };
+        auto need = [&](std::size_t found) {
+            if (found != std::string::npos) return true;
+            if (final) fail("неочікуваний кінець документа", pos);
+            return false;
+        };
+
+        if (rest.size() < 2) return need(std::string::npos);
+
+        if (rest[1] == '?') {
+            std::size_t end = buffer.find("?>", pos + 2);
+            if (!need(end)) return false;
+            pos = end + 2;
+            return true;
+        }
+        if (rest[1] == '!') {
+            // Префікси "<!--" та "<![CDATA[" можна розрізнити лише маючи достатньо байтів
+            if (rest.size() < 9 && !final) return false;
+            if (startsWith("<!--")) {
+                std::size_t end = buffer.find("-->", pos + 4);
+                if (!need(end)) return false;
+                pos = end + 3;
+                return true;
+            }
+            if (startsWith("<![CDATA[")) {
+                std::size_t end = buffer.find("]]>", pos + 9);
+                if (!need(end)) return false;
+                cdata(std::string_view(buffer).substr(pos + 9, end - pos - 9));
+                pos = end + 3;
+                return true;
+            }
+            std::size_t end = findDoctypeEnd(pos + 2);
+            if (!need(end)) return false;
+            pos = end + 1;
+            return true;
+        }
+        if (rest[1] == '/') {
+            std::size_t end = buffer.find('>', pos + 2);
+            if (!need(end)) return false;
+            std::string_view name = std::string_view(buffer).substr(pos + 2, end - pos - 2);
+            while (!name.empty() && isXmlSpace(name.back())) name.remove_suffix(1);
+            const std::size_t nameEnd = name.find_first_of(" \t\r\n<");
+            if (nameEnd != std::string_view::npos) name = name.substr(0, nameEnd);
+            if (stack.empty() || topName() != name || nameEnd != std::string_view::npos) {
+                fail("неочікуваний закриваючий тег </" + std::string(name) + ">", pos);
+            }
+            closeElement();
+            pos = end + 1;
+            return true;
+        }
+
+        std::size_t end = findTagEnd(pos + 1);
+        if (!need(end)) return false;
+        std::size_t nameEnd = pos + 1;
+        while (nameEnd < end && !isXmlSpace(buffer[nameEnd]) && buffer[nameEnd] != '/') ++nameEnd;
+        if (nameEnd == pos + 1) fail("порожнє ім'я елемента", pos);
+        openElement(std::string_view(buffer).substr(pos + 1, nameEnd - pos - 1));
+        if (buffer[end - 1] == '/') closeElement(); // <tag/> або <tag attr="..."/>
+        pos = end + 1;
+        return true;
+    }
+
+    void process(bool final) {
+        std::size_t pos = 0;
+        while (pos < buffer.size()) {
+            if (buffer[pos] != '<') {
+                std::size_t lt = buffer.find('<', pos);
+                std::size_t textEnd = lt == std::string::npos ? buffer.size() : lt;
+                // Текст поза захоплюваними елементами відкидається одразу, не накопичуючись
+                if (isCaptureRole(topRole()) && !hasCapturedText) {
+                    pendingText.append(buffer, pos, textEnd - pos);
+                }
+                pos = textEnd;
+                if (lt == std::string::npos) break;
+            }
+            flushText();
+            if (!parseMarkup(pos, final)) break;
+        }
+        buffer.erase(0, pos);
+        consumed += pos;
+    }
+};
+
+FilteredSettingsReader::FilteredSettingsReader() : m_state(std::make_unique<State>()) {}
+
+FilteredSettingsReader::~FilteredSettingsReader() = default;
+
+void FilteredSettingsReader::feed(const char* data, std::size_t size) {
+    State& s = *m_state;
+    s.buffer.append(data, size);
+    s.peakBuffer = std::max(s.peakBuffer, s.buffer.size());
+    s.process(false);
+}
+
+FilteredSettingsMap FilteredSettingsReader::finish() {
+    State& s = *m_state;
+    s.process(true);
+    s.flushText();
+    if (!s.stack.empty()) {
+        s.fail("незакритий елемент <" + std::string(s.topName()) + ">", s.buffer.size());
+    }
+    if (!s.rootSeen) {
+        throw std::runtime_error("Відсутній кореневий елемент <root>");
+    }
+
+    // Той самий склад і порядок, що й у getFilteredSettings: прямі теги графіки в порядку схеми, потім записи <entry>
+    FilteredSettingsMap categorizedSettings;
+    if (!s.sound.empty()) categorizedSettings[SettingSchema::categoryName(ConfigSection::SOUND_PREFS)] = std::move(s.sound);
+    if (!s.control.empty()) categorizedSettings[SettingSchema::categoryName(ConfigSection::CONTROL_CAMERA)] = std::move(s.control);
+
+    std::vector<std::pair<std::string, std::string>> graphics;
+    for (std::size_t i = 0; i < s.graphicsSlots.size(); ++i) {
+        if (s.graphicsSlots[i].first) graphics.emplace_back(s.graphicsSpecs.first[i].tag, std::move(s.graphicsSlots[i].second));
+    }
+    graphics.insert(graphics.end(), std::make_move_iterator(s.graphicsEntries.begin()), std::make_move_iterator(s.graphicsEntries.end()));
+    if (!graphics.empty()) categorizedSettings[SettingSchema::categoryName(ConfigSection::GRAPHICS_PREFERENCES)] = std::move(graphics);
+
+    if (!s.device.empty()) categorizedSettings[SettingSchema::categoryName(ConfigSection::DEVICE_PREFERENCES)] = std::move(s.device);
+
+    return categorizedSettings;
+}
+
+std::size_t FilteredSettingsReader::peakBufferSize() const {
+    return m_state->peakBuffer;
+}
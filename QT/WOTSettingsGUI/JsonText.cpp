@@ -0,0 +1,31 @@
+#include "main.h" // Головний заголовок (містить оголошення JsonText)
+#include <cstdio>
+
+void JsonText::appendQuoted(std::string& out, std::string_view value) {
+    out += '"';
+    for (unsigned char c : value) {
+        switch (c) {
+        case '"':  out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if (c < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                out += escaped;
+            } else {
+                out += static_cast<char>(c); // UTF-8 лишається як є
+            }
+        }
+    }
+    out += '"';
+}
+
+std::string JsonText::quoted(std::string_view value) {
+    std::string out;
+    out.reserve(value.size() + 2);
+    appendQuoted(out, value);
+    return out;
+}
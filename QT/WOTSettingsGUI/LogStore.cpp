@@ -0,0 +1,468 @@
+#include "main.h" // Головний заголовок (містить оголошення LogStore, LogEntry)
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <fstream>
+#include <iostream> // Для std::cerr (як у ChangeTracker)
+#include <system_error>
+
+// Лог складається з сегментів logs.<N>.jsonl (один JSON-об'єкт на рядок) та розрідженого
+// індексу logs.idx: рядок "N \t зміщення \t час_мс \t порядковий_номер" на першому записі
+// сегмента і далі на кожному kIndexStride-му. Запит "останні N" чи "вікно дат" знаходить
+// у індексі найближчу точку і читає лише хвіст від неї, а не весь лог.
+
+namespace {
+
+const char* const kIndexFileName = "logs.idx";
+const std::size_t kIndexStride = 256;
+
+std::string segmentName(std::uint64_t seq) {
+    return "logs." + std::to_string(seq) + ".jsonl";
+}
+
+// "logs.<N>.jsonl" -> N; 0 - не сегмент логу
+std::uint64_t parseSegmentName(const std::string& name) {
+    const std::string prefix = "logs.", suffix = ".jsonl";
+    if (name.size() <= prefix.size() + suffix.size() || name.compare(0, prefix.size(), prefix) != 0 ||
+        name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0) {
+        return 0;
+    }
+    const std::string digits = name.substr(prefix.size(), name.size() - prefix.size() - suffix.size());
+    if (digits.find_first_not_of("0123456789") != std::string::npos || digits.size() > 18) return 0;
+    return std::stoull(digits);
+}
+
+std::FILE* openAppend(const fs::path& path) {
+#ifdef _WIN32
+    return _wfopen(path.wstring().c_str(), L"ab");
+#else
+    return std::fopen(path.c_str(), "ab");
+#endif
+}
+
+// --- Мінімальний розбір рядка логу: плаский об'єкт із рядками, числами і true/false ---
+void skipSpaces(std::string_view s, std::size_t& pos) {
+    while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t')) ++pos;
+}
+
+void appendUtf8(std::string& out, unsigned code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+bool parseJsonString(std::string_view s, std::size_t& pos, std::string& out) {
+    if (pos >= s.size() || s[pos] != '"') return false;
+    ++pos;
+    out.clear();
+    while (pos < s.size()) {
+        const char c = s[pos++];
+        if (c == '"') return true;
+        if (c != '\\') {
+            out += c;
+            continue;
+        }
+        if (pos >= s.size()) return false;
+        const char e = s[pos++];
+        switch (e) {
+        case '"': case '\\': case '/': out += e; break;
+        case 'n': out += '\n'; break;
+        case 'r': out += '\r'; break;
+        case 't': out += '\t'; break;
+        case 'b': out += '\b'; break;
+        case 'f': out += '\f'; break;
+        case 'u': {
+            if (s.size() - pos < 4) return false;
+            unsigned code = 0;
+            for (int i = 0; i < 4; ++i) {
+                const char h = s[pos++];
+                code <<= 4;
+                if (h >= '0' && h <= '9') code |= h - '0';
+                else if (h >= 'a' && h <= 'f') code |= h - 'a' + 10;
+                else if (h >= 'A' && h <= 'F') code |= h - 'A' + 10;
+                else return false;
+            }
+            appendUtf8(out, code);
+            break;
+        }
+        default: return false;
+        }
+    }
+    return false;
+}
+
+bool parseJsonScalar(std::string_view s, std::size_t& pos, std::string& out) {
+    const std::size_t start = pos;
+    while (pos < s.size() && s[pos] != ',' && s[pos] != '}' && s[pos] != ' ') ++pos;
+    out.assign(s.substr(start, pos - start));
+    return !out.empty();
+}
+
+}
+
+LogStore::LogStore(fs::path directory, const LogRotationPolicy& policy)
+    : m_directory(std::move(directory)), m_policy(policy) {}
+
+LogStore::~LogStore() {
+    flush();
+    closeFiles();
+}
+
+void LogStore::setPolicy(const LogRotationPolicy& policy) {
+    m_policy = policy;
+}
+
+void LogStore::closeFiles() {
+    if (m_segmentFile) std::fclose(m_segmentFile);
+    if (m_indexFile) std::fclose(m_indexFile);
+    m_segmentFile = nullptr;
+    m_indexFile = nullptr;
+}
+
+std::string LogStore::formatRecord(const LogEntry& entry) {
+    // {"ts":<мс від епохи>,"time":"<місцевий час>","fn":"...","ok":true,"details":"..."}
+    std::string line = "{\"ts\":" + std::to_string(entry.timeMs) + ",\"time\":";
+    const std::time_t seconds = static_cast<std::time_t>(entry.timeMs / 1000);
+    std::tm localTime;
+#ifdef _WIN32
+    localtime_s(&localTime, &seconds);
+#else
+    localtime_r(&seconds, &localTime);
+#endif
+    char stamp[32];
+    const std::size_t length = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d_%H:%M:%S", &localTime);
+    JsonText::appendQuoted(line, std::string_view(stamp, length));
+    line += ",\"fn\":";
+    JsonText::appendQuoted(line, entry.functionName);
+    line += entry.success ? ",\"ok\":true" : ",\"ok\":false";
+    if (!entry.details.empty()) {
+        line += ",\"details\":";
+        JsonText::appendQuoted(line, entry.details);
+    }
+    line += "}\n";
+    return line;
+}
+
+bool LogStore::parseRecord(std::string_view line, LogEntry& entry) {
+    std::size_t pos = 0;
+    skipSpaces(line, pos);
+    if (pos >= line.size() || line[pos++] != '{') return false;
+    entry = LogEntry();
+    bool hasTime = false;
+    std::string key, value;
+    for (;;) {
+        skipSpaces(line, pos);
+        if (pos < line.size() && line[pos] == '}') return hasTime;
+        if (!parseJsonString(line, pos, key)) return false;
+        skipSpaces(line, pos);
+        if (pos >= line.size() || line[pos++] != ':') return false;
+        skipSpaces(line, pos);
+        const bool isString = pos < line.size() && line[pos] == '"';
+        if (!(isString ? parseJsonString(line, pos, value) : parseJsonScalar(line, pos, value))) return false;
+
+        if (key == "ts" && !isString) {
+            try {
+                entry.timeMs = std::stoll(value);
+                hasTime = true;
+            } catch (const std::exception&) {
+                return false;
+            }
+        } else if (key == "fn" && isString) {
+            entry.functionName = value;
+        } else if (key == "ok" && !isString) {
+            entry.success = value == "true";
+        } else if (key == "details" && isString) {
+            entry.details = value;
+        } // Невідомі поля пропускаються
+
+        skipSpaces(line, pos);
+        if (pos < line.size() && line[pos] == ',') {
+            ++pos;
+            continue;
+        }
+        if (pos < line.size() && line[pos] == '}') return hasTime;
+        return false;
+    }
+}
+
+std::vector<LogStore::IndexPoint> LogStore::readIndex(const fs::path& directory) {
+    std::vector<IndexPoint> points;
+    std::ifstream index(directory / kIndexFileName, std::ios::binary);
+    std::string line;
+    while (std::getline(index, line)) {
+        if (index.eof()) break; // Незавершений останній рядок
+        IndexPoint point;
+        unsigned long long seq = 0, offset = 0, ordinal = 0;
+        long long timeMs = 0;
+        if (std::sscanf(line.c_str(), "%llu\t%llu\t%lld\t%llu", &seq, &offset, &timeMs, &ordinal) != 4) continue;
+        point.seq = seq;
+        point.offset = offset;
+        point.timeMs = timeMs;
+        point.ordinal = ordinal;
+        // Точки йдуть за зростанням номера запису; решта - залишки пошкодження
+        if (!points.empty() && point.ordinal <= points.back().ordinal) continue;
+        points.push_back(point);
+    }
+    return points;
+}
+
+std::string LogStore::formatIndexPoint(const IndexPoint& point) {
+    return std::to_string(point.seq) + '\t' + std::to_string(point.offset) + '\t' + std::to_string(point.timeMs) + '\t' +
+           std::to_string(point.ordinal) + '\n';
+}
+
+// Проходить сегмент від offset, викликаючи visit(зміщення рядка, запис) для кожного повного рядка.
+// Повертає зміщення кінця останнього повного рядка.
+std::uint64_t LogStore::scanSegment(const fs::path& path, std::uint64_t offset,
+                                    const std::function<bool(std::uint64_t, const LogEntry&)>& visit) {
+    std::ifstream segment(path, std::ios::binary);
+    if (!segment.is_open()) return offset;
+    segment.seekg(static_cast<std::streamoff>(offset));
+    std::string line;
+    LogEntry entry;
+    while (std::getline(segment, line)) {
+        if (segment.eof()) break; // Рядок без '\n' - запис обірвано
+        const std::uint64_t lineOffset = offset;
+        offset += line.size() + 1;
+        if (!parseRecord(line, entry)) continue;
+        if (!visit(lineOffset, entry)) break;
+    }
+    return offset;
+}
+
+// Стан при першому записі: індекс довіряється, якщо в ньому є початок кожного наявного
+// сегмента; інакше перебудовується проходом по сегментах (після збою чи видалення logs.idx).
+bool LogStore::open() {
+    std::error_code ec;
+    fs::create_directories(m_directory, ec);
+    if (ec) {
+        std::cerr << "CRITICAL ERROR: Could not create log directory '" << m_directory.string() << "'. Error: " << ec.message() << std::endl;
+        return false;
+    }
+
+    std::vector<std::uint64_t> segments;
+    for (const auto& item : fs::directory_iterator(m_directory, ec)) {
+        const std::uint64_t seq = parseSegmentName(item.path().filename().string());
+        if (seq > 0) segments.push_back(seq);
+    }
+    std::sort(segments.begin(), segments.end());
+
+    m_points = readIndex(m_directory);
+    m_points.erase(std::remove_if(m_points.begin(), m_points.end(), [&](const IndexPoint& p) {
+                       return !std::binary_search(segments.begin(), segments.end(), p.seq);
+                   }), m_points.end());
+    bool consistent = true;
+    for (std::uint64_t seq : segments) {
+        auto first = std::find_if(m_points.begin(), m_points.end(), [&](const IndexPoint& p) { return p.seq == seq; });
+        const bool empty = fs::file_size(m_directory / segmentName(seq), ec) == 0;
+        if (!empty && (first == m_points.end() || first->offset != 0)) consistent = false;
+    }
+
+    m_seq = segments.empty() ? 1 : segments.back();
+    m_segmentBytes = 0;
+    m_segmentRecords = 0;
+    m_nextOrdinal = 0;
+    m_lastPointMs = 0;
+    auto track = [&](std::uint64_t seq, std::uint64_t lineOffset, const LogEntry& entry, bool addPoints) {
+        if (m_segmentRecords == 0) m_segmentFirstMs = entry.timeMs;
+        if (addPoints && m_segmentRecords % kIndexStride == 0) {
+            m_lastPointMs = std::max(m_lastPointMs, entry.timeMs);
+            m_points.push_back({seq, lineOffset, m_lastPointMs, m_nextOrdinal});
+        }
+        ++m_segmentRecords;
+        ++m_nextOrdinal;
+        return true;
+    };
+
+    if (!consistent) {
+        m_points.clear();
+        for (std::uint64_t seq : segments) {
+            m_segmentRecords = 0;
+            m_segmentBytes = scanSegment(m_directory / segmentName(seq), 0, [&](std::uint64_t offset, const LogEntry& entry) {
+                return track(seq, offset, entry, true);
+            });
+        }
+        if (!rewriteIndex()) return false;
+    } else if (!m_points.empty()) {
+        // Довіряємо індексу; дочитуємо лише хвіст сегмента від останньої точки
+        const IndexPoint last = m_points.back();
+        m_nextOrdinal = last.ordinal;
+        m_lastPointMs = last.timeMs;
+        std::uint64_t recordsAfterPoint = 0;
+        const std::uint64_t tailEnd = scanSegment(m_directory / segmentName(last.seq), last.offset,
+                                                  [&](std::uint64_t, const LogEntry&) { ++recordsAfterPoint; return true; });
+        m_nextOrdinal += recordsAfterPoint;
+        if (last.seq == m_seq) {
+            const auto first = std::find_if(m_points.begin(), m_points.end(), [&](const IndexPoint& p) { return p.seq == m_seq; });
+            const std::size_t pointsInSegment = static_cast<std::size_t>(m_points.end() - first);
+            m_segmentFirstMs = first->timeMs;
+            m_segmentRecords = (pointsInSegment - 1) * kIndexStride + recordsAfterPoint;
+            m_segmentBytes = tailEnd;
+        } // Інакше активний сегмент порожній
+    }
+
+    // Обірваний останній рядок (збій посеред запису) лишається в старому сегменті
+    if (fs::file_size(m_directory / segmentName(m_seq), ec) != m_segmentBytes && !ec) {
+        ++m_seq;
+        m_segmentBytes = 0;
+        m_segmentRecords = 0;
+    }
+
+    m_segmentFile = openAppend(m_directory / segmentName(m_seq));
+    m_indexFile = openAppend(m_directory / kIndexFileName);
+    if (!m_segmentFile || !m_indexFile) {
+        std::cerr << "ERROR: Could not open log file for writing: " << (m_directory / segmentName(m_seq)).string() << std::endl;
+        closeFiles();
+        return false;
+    }
+    m_opened = true;
+    return true;
+}
+
+bool LogStore::rewriteIndex() {
+    std::string content;
+    for (const IndexPoint& point : m_points) content += formatIndexPoint(point);
+    if (m_indexFile) {
+        std::fclose(m_indexFile);
+        m_indexFile = nullptr;
+    }
+    try {
+        AtomicFile::writeBuffer(m_directory / kIndexFileName, content.data(), content.size());
+    } catch (const std::runtime_error& e) {
+        std::cerr << "ERROR: Could not rewrite log index: " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Новий сегмент; найстаріші понад maxSegments видаляються разом зі своїми точками індексу
+void LogStore::rotate() {
+    flush();
+    if (m_segmentFile) std::fclose(m_segmentFile);
+    m_segmentFile = nullptr;
+    ++m_seq;
+    m_segmentBytes = 0;
+    m_segmentRecords = 0;
+
+    const std::size_t keep = std::max<std::size_t>(m_policy.maxSegments, 1);
+    if (m_seq > keep) {
+        const std::uint64_t oldestKept = m_seq - keep + 1;
+        const auto firstKept = std::find_if(m_points.begin(), m_points.end(), [&](const IndexPoint& p) { return p.seq >= oldestKept; });
+        if (firstKept != m_points.begin()) {
+            std::vector<std::uint64_t> removed;
+            for (auto it = m_points.begin(); it != firstKept; ++it) {
+                if (removed.empty() || removed.back() != it->seq) removed.push_back(it->seq);
+            }
+            m_points.erase(m_points.begin(), firstKept);
+            rewriteIndex(); // Спершу індекс: збій між кроками лишає зайвий файл, а не точку на неіснуючий
+            for (std::uint64_t seq : removed) {
+                std::error_code ec;
+                fs::remove(m_directory / segmentName(seq), ec);
+            }
+        }
+    }
+
+    m_segmentFile = openAppend(m_directory / segmentName(m_seq));
+    if (!m_indexFile) m_indexFile = openAppend(m_directory / kIndexFileName);
+    if (!m_segmentFile || !m_indexFile) {
+        std::cerr << "ERROR: Could not open log file for writing: " << (m_directory / segmentName(m_seq)).string() << std::endl;
+        closeFiles();
+        m_opened = false;
+    }
+}
+
+void LogStore::append(const LogEntry& entry) {
+    if (!m_opened && !open()) return;
+
+    const bool tooBig = m_policy.maxSegmentBytes > 0 && m_segmentBytes + m_segmentBuffer.size() >= m_policy.maxSegmentBytes;
+    const bool tooOld = m_policy.maxSegmentAgeSeconds > 0 && m_segmentRecords > 0 &&
+                        entry.timeMs - m_segmentFirstMs >= m_policy.maxSegmentAgeSeconds * 1000;
+    if (m_segmentRecords > 0 && (tooBig || tooOld)) {
+        rotate();
+        if (!m_opened) return;
+    }
+
+    const std::uint64_t offset = m_segmentBytes + m_segmentBuffer.size();
+    if (m_segmentRecords == 0) m_segmentFirstMs = entry.timeMs;
+    if (m_segmentRecords % kIndexStride == 0) {
+        // Час точок не спадає, навіть якщо годинник перевели назад - пошук у індексі лишається коректним
+        m_lastPointMs = std::max(m_lastPointMs, entry.timeMs);
+        const IndexPoint point{m_seq, offset, m_lastPointMs, m_nextOrdinal};
+        m_points.push_back(point);
+        m_indexBuffer += formatIndexPoint(point);
+    }
+    m_segmentBuffer += formatRecord(entry);
+    ++m_segmentRecords;
+    ++m_nextOrdinal;
+}
+
+// Спершу дані, потім індекс: точка ніколи не вказує на ще не записаний рядок
+bool LogStore::flush() {
+    if (!m_opened || (m_segmentBuffer.empty() && m_indexBuffer.empty())) return true;
+    bool ok = std::fwrite(m_segmentBuffer.data(), 1, m_segmentBuffer.size(), m_segmentFile) == m_segmentBuffer.size() &&
+              std::fflush(m_segmentFile) == 0;
+    if (ok) {
+        m_segmentBytes += m_segmentBuffer.size();
+        ok = std::fwrite(m_indexBuffer.data(), 1, m_indexBuffer.size(), m_indexFile) == m_indexBuffer.size() &&
+             std::fflush(m_indexFile) == 0;
+    }
+    m_segmentBuffer.clear();
+    m_indexBuffer.clear();
+    if (!ok) {
+        // Стан файлів невідомий - наступний запис відкриє лог заново з перебудовою індексу за потреби
+        std::cerr << "ERROR: Could not write log file." << std::endl;
+        closeFiles();
+        m_opened = false;
+    }
+    return ok;
+}
+
+std::vector<LogEntry> LogStore::query(const fs::path& directory, const LogQuery& query) {
+    const std::vector<IndexPoint> points = readIndex(directory);
+    if (points.empty()) return {};
+
+    // Стартова точка: остання не пізніша за fromMs і така, щоб після неї було щонайменше lastCount записів
+    std::size_t start = 0;
+    if (query.fromMs != LogQuery().fromMs) {
+        auto after = std::upper_bound(points.begin(), points.end(), query.fromMs,
+                                      [](std::int64_t value, const IndexPoint& p) { return value < p.timeMs; });
+        start = after == points.begin() ? 0 : static_cast<std::size_t>(after - points.begin()) - 1;
+    }
+    if (query.lastCount > 0) {
+        const std::uint64_t lastOrdinal = points.back().ordinal;
+        std::size_t byCount = 0;
+        for (std::size_t i = points.size(); i-- > 0;) {
+            if (lastOrdinal - points[i].ordinal >= query.lastCount) {
+                byCount = i;
+                break;
+            }
+        }
+        start = std::max(start, byCount);
+    }
+
+    std::deque<LogEntry> result;
+    bool pastWindow = false;
+    std::uint64_t offset = points[start].offset;
+    for (std::uint64_t seq = points[start].seq; seq <= points.back().seq && !pastWindow; ++seq, offset = 0) {
+        scanSegment(directory / segmentName(seq), offset, [&](std::uint64_t, const LogEntry& entry) {
+            if (entry.timeMs < query.fromMs) return true;
+            if (entry.timeMs > query.toMs) { // Записи йдуть за часом - далі лише пізніші
+                pastWindow = true;
+                return false;
+            }
+            result.push_back(entry);
+            if (query.lastCount > 0 && result.size() > query.lastCount) result.pop_front();
+            return true;
+        });
+    }
+    return std::vector<LogEntry>(std::make_move_iterator(result.begin()), std::make_move_iterator(result.end()));
+}
@@ -0,0 +1,72 @@
+#include "main.h" // Головний заголовок (містить оголошення SettingNodeIndex)
+#include "pugixml/pugixml.hpp"
+#include <string>
+
+namespace {
+
+// Усі прямі дочірні елементи секції; за однакових імен лишається перше входження (як у xml_node::child)
+void indexChildren(const pugi::xml_node& sectionNode, SettingNodeIndex::NodeMap& map) {
+    for (const pugi::xml_node& child : sectionNode.children()) {
+        if (child.type() != pugi::node_element) continue;
+        map.emplace(child.name(), child.internal_object());
+    }
+}
+
+}
+
+std::shared_ptr<const SettingNodeIndex> SettingNodeIndex::build(const pugi::xml_document& doc) {
+    auto index = std::make_shared<SettingNodeIndex>();
+    const pugi::xml_node root = doc.child("root");
+    if (!root) return index;
+
+    const pugi::xml_node scriptsPreferences = root.child("scriptsPreferences");
+    indexChildren(scriptsPreferences.child("soundPrefs"), index->m_sound);
+
+    for (const pugi::xml_node& mode : scriptsPreferences.child("controlMode").children()) {
+        if (mode.type() != pugi::node_element) continue;
+        const std::string prefix = std::string(mode.name()) + "/";
+        for (const pugi::xml_node& setting : mode.child("camera").children()) {
+            if (setting.type() != pugi::node_element) continue;
+            index->m_control.emplace(prefix + setting.name(), setting.internal_object());
+        }
+    }
+
+    // Прямі теги мають пріоритет над <entry> з таким самим <label> - тому індексуються першими
+    const pugi::xml_node graphicsPreferences = root.child("graphicsPreferences");
+    indexChildren(graphicsPreferences, index->m_graphics);
+    for (const pugi::xml_node& entry : graphicsPreferences.children("entry")) {
+        std::string label = std::string(XmlUtil::trimmed(entry.child_value("label")));
+        if (label.empty()) continue;
+        index->m_graphics.emplace(std::move(label), entry.child("activeOption").internal_object());
+    }
+
+    indexChildren(root.child("devicePreferences"), index->m_device);
+    return index;
+}
+
+const SettingNodeIndex::NodeMap* SettingNodeIndex::sectionMap(ConfigSection section) const {
+    switch (section) {
+    case ConfigSection::SOUND_PREFS:          return &m_sound;
+    case ConfigSection::CONTROL_CAMERA:       return &m_control;
+    case ConfigSection::GRAPHICS_PREFERENCES:
+    case ConfigSection::GRAPHICS_ENTRY:       return &m_graphics;
+    case ConfigSection::DEVICE_PREFERENCES:   return &m_device;
+    default:                                  return nullptr;
+    }
+}
+
+pugi::xml_node SettingNodeIndex::find(ConfigSection section, const std::string& key) const {
+    const NodeMap* map = sectionMap(section);
+    if (!map) return pugi::xml_node();
+    auto it = map->find(key);
+    return it != map->end() ? pugi::xml_node(it->second) : pugi::xml_node();
+}
+
+bool SettingNodeIndex::hasSection(ConfigSection section) const {
+    const NodeMap* map = sectionMap(section);
+    return map && !map->empty();
+}
+
+std::size_t SettingNodeIndex::size() const {
+    return m_sound.size() + m_control.size() + m_graphics.size() + m_device.size();
+}
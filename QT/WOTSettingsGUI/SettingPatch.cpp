@@ -0,0 +1,177 @@
+#include "main.h" // Головний заголовок (містить оголошення SettingPatch)
+#include "pugixml/pugixml.hpp"
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+namespace {
+
+// Порядок секцій у плані - порядок обходу документа
+int sectionOrder(ConfigSection section) {
+    switch (section) {
+    case ConfigSection::SOUND_PREFS:          return 0;
+    case ConfigSection::CONTROL_CAMERA:       return 1;
+    case ConfigSection::GRAPHICS_PREFERENCES: return 2;
+    case ConfigSection::GRAPHICS_ENTRY:       return 3;
+    case ConfigSection::DEVICE_PREFERENCES:   return 4;
+    default:                                  return 5;
+    }
+}
+
+}
+
+SettingAssignment SettingPatch::parseAssignment(const std::string& text) {
+    const std::size_t eq = text.find('=');
+    if (eq == std::string::npos || eq == 0) {
+        throw std::runtime_error("Очікується 'ключ=значення', отримано '" + text + "'");
+    }
+    return {text.substr(0, eq), text.substr(eq + 1)};
+}
+
+SettingPatch SettingPatch::compile(const std::vector<SettingAssignment>& assignments) {
+    SettingPatch patch;
+    std::string errors;
+    std::unordered_map<std::string, std::size_t> seen;
+    for (const SettingAssignment& assignment : assignments) {
+        const SettingSpec* spec = SettingSchema::findKey(assignment.key);
+        std::string error;
+        if (!spec) {
+            error = "Невідомий ключ налаштування '" + assignment.key + "'";
+        } else if (spec->type == SettingType::NON_EDITABLE) {
+            error = "Налаштування '" + assignment.key + "' не редагується";
+        } else if (!SettingSchema::checkValue(*spec, assignment.key, assignment.value.c_str(), error)) {
+            // error заповнено checkValue
+        } else if (seen.count(assignment.key)) {
+            error = "Ключ '" + assignment.key + "' задано кілька разів";
+        }
+        if (!error.empty()) {
+            errors += (errors.empty() ? "" : "; ") + error;
+            continue;
+        }
+        seen.emplace(assignment.key, patch.m_operations.size());
+
+        Operation op{spec->section, assignment.key, "", "", std::string(XmlUtil::trimmed(assignment.value.c_str()))};
+        if (spec->section == ConfigSection::CONTROL_CAMERA) {
+            const std::size_t slash = assignment.key.find('/');
+            op.mode = assignment.key.substr(0, slash);
+            op.setting = assignment.key.substr(slash + 1);
+        }
+        patch.m_operations.push_back(std::move(op));
+    }
+    if (!errors.empty()) throw std::runtime_error(errors);
+
+    std::stable_sort(patch.m_operations.begin(), patch.m_operations.end(), [](const Operation& a, const Operation& b) {
+        return sectionOrder(a.section) < sectionOrder(b.section);
+    });
+    return patch;
+}
+
+PatchFileResult SettingPatch::apply(const fs::path& filePath, const PatchOptions& options) const {
+    TraceScope trace("SettingPatch::apply");
+    PatchFileResult result;
+    result.path = filePath;
+    try {
+        std::shared_ptr<const ParsedDocument> parsed = DocumentCache::parseFile(filePath);
+        if (!parsed->ok) {
+            result.error = "Помилка XML: " + parsed->errorDescription + " (позиція " + std::to_string(parsed->errorOffset) + ")";
+            return result;
+        }
+        pugi::xml_document& doc = *parsed->doc;
+        const pugi::xml_node root = doc.child("root");
+        if (!root) {
+            result.error = "Не знайдено <root> елемент";
+            return result;
+        }
+        const pugi::xml_node scripts = root.child("scriptsPreferences");
+        const pugi::xml_node graphics = root.child("graphicsPreferences");
+
+        // Записи <entry> потрібні лише для ключів без прямого тегу: один прохід по записах на файл,
+        // перше входження <label> виграє (як у SettingNodeIndex)
+        std::unordered_map<std::string_view, pugi::xml_node> entries;
+        bool entriesScanned = false;
+        auto findEntry = [&](const std::string& label) {
+            if (!entriesScanned) {
+                entriesScanned = true;
+                for (const pugi::xml_node& entry : graphics.children("entry")) {
+                    const std::string_view entryLabel = XmlUtil::trimmed(entry.child_value("label"));
+                    if (!entryLabel.empty()) entries.emplace(entryLabel, entry.child("activeOption"));
+                }
+            }
+            auto it = entries.find(label);
+            return it != entries.end() ? it->second : pugi::xml_node();
+        };
+
+        for (const Operation& op : m_operations) {
+            pugi::xml_node node;
+            switch (op.section) {
+            case ConfigSection::SOUND_PREFS:
+                node = scripts.child("soundPrefs").child(op.key.c_str());
+                break;
+            case ConfigSection::CONTROL_CAMERA:
+                node = scripts.child("controlMode").child(op.mode.c_str()).child("camera").child(op.setting.c_str());
+                break;
+            case ConfigSection::GRAPHICS_PREFERENCES:
+            case ConfigSection::GRAPHICS_ENTRY:
+                // Прямий тег має пріоритет над <entry> з таким самим <label>
+                node = graphics.child(op.key.c_str());
+                if (!node) node = findEntry(op.key);
+                break;
+            case ConfigSection::DEVICE_PREFERENCES:
+                node = root.child("devicePreferences").child(op.key.c_str());
+                break;
+            default:
+                break;
+            }
+            if (!node) {
+                result.missingKeys.push_back(op.key);
+                continue;
+            }
+            const std::string_view current = XmlUtil::trimmed(node.text().as_string());
+            if (current == op.value) continue; // Значення вже таке - вузол не чіпаємо
+            std::string oldValue(current);
+            if (!node.text().set(op.value.c_str())) {
+                result.error = "Не вдалося змінити значення '" + op.key + "'";
+                return result;
+            }
+            result.applied.push_back({SettingSchema::categoryName(op.section), op.key, std::move(oldValue), op.value});
+        }
+
+        FileValidator validator;
+        result.valueErrors = validator.checkValues(doc);
+        if (options.rejectInvalid && !result.valueErrors.empty()) {
+            result.error = "Після змін у файлі лишаються недопустимі значення (" + std::to_string(result.valueErrors.size()) + ")";
+            return result;
+        }
+
+        if (!result.applied.empty() && !options.dryRun) {
+            AtomicFile::saveDocument(filePath, doc);
+            result.written = true;
+            DocumentCache::instance().invalidate(filePath); // Кешована версія (якщо є) застаріла
+        }
+        result.ok = true;
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+PatchReport SettingPatch::applyAll(const std::vector<fs::path>& filePaths, const PatchOptions& options) const {
+    TraceScope trace("SettingPatch::applyAll");
+    PatchReport report;
+    report.threadCount = options.threadCount > 0 ? options.threadCount : WorkerPool::defaultThreadCount();
+    report.results.resize(filePaths.size());
+
+    const auto start = std::chrono::steady_clock::now();
+    // Кожен потік пише лише у свою комірку results; apply не кидає винятків
+    WorkerPool::forEach(filePaths.size(), report.threadCount, [&](std::size_t i) {
+        report.results[i] = apply(filePaths[i], options);
+    });
+    report.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (const PatchFileResult& result : report.results) {
+        if (!result.ok) ++report.failedCount;
+        else if (!result.applied.empty()) ++report.modifiedCount;
+        else ++report.unchangedCount;
+    }
+    return report;
+}
@@ -0,0 +1,328 @@
+#include "main.h" // Головний заголовок (містить SettingSpec, SettingSchema, SettingRule)
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr double kNoMin = -std::numeric_limits<double>::max();
+constexpr double kNoMax = std::numeric_limits<double>::max();
+constexpr unsigned kEditor = SettingSpec::EDITOR;
+
+// Таблиця відсортована за (section, tag) побайтово - так само, як порівнює std::string_view.
+// Порядок перевіряється під час компіляції (див. static_assert нижче).
+// kEditor - налаштування потрапляє у відфільтрований вид (getFilteredSettings) і редактор;
+// для GRAPHICS_ENTRY відфільтрований вид показує всі записи з <label>, тож прапорець там лише довідковий.
+constexpr SettingSpec kSpecs[] = {
+    {ConfigSection::SOUND_PREFS, "bass_boost", SettingType::STRING, kNoMin, kNoMax, 0, nullptr, kEditor},
+    {ConfigSection::SOUND_PREFS, "masterVolume", SettingType::FLOAT, 0.0, 1.0, 6, "Загальна гучність", kEditor},
+    {ConfigSection::SOUND_PREFS, "soundMode", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Режим звуку", kEditor},
+    {ConfigSection::SOUND_PREFS, "volume_ambient", SettingType::FLOAT, 0.0, 1.0, 6, "Гучність: Оточення", kEditor},
+    {ConfigSection::SOUND_PREFS, "volume_effects", SettingType::FLOAT, 0.0, 1.0, 6, "Гучність: Ефекти", kEditor},
+    {ConfigSection::SOUND_PREFS, "volume_ev_ambient", SettingType::FLOAT, 0.0, 1.0, 6, nullptr, 0},
+    {ConfigSection::SOUND_PREFS, "volume_ev_effects", SettingType::FLOAT, 0.0, 1.0, 6, nullptr, 0},
+    {ConfigSection::SOUND_PREFS, "volume_ev_gui", SettingType::FLOAT, 0.0, 1.0, 6, nullptr, 0},
+    {ConfigSection::SOUND_PREFS, "volume_ev_music", SettingType::FLOAT, 0.0, 1.0, 6, nullptr, 0},
+    {ConfigSection::SOUND_PREFS, "volume_ev_vehicles", SettingType::FLOAT, 0.0, 1.0, 6, nullptr, 0},
+    {ConfigSection::SOUND_PREFS, "volume_ev_voice", SettingType::FLOAT, 0.0, 1.0, 6, nullptr, 0},
+    {ConfigSection::SOUND_PREFS, "volume_gui", SettingType::FLOAT, 0.0, 1.0, 6, "Гучність: Інтерфейс", kEditor},
+    {ConfigSection::SOUND_PREFS, "volume_masterFadeVivox", SettingType::FLOAT, 0.0, 1.0, 6, nullptr, 0},
+    {ConfigSection::SOUND_PREFS, "volume_masterVivox", SettingType::FLOAT, 0.0, 1.0, 6, nullptr, 0},
+    {ConfigSection::SOUND_PREFS, "volume_micVivox", SettingType::FLOAT, 0.0, 1.0, 6, "Гучність мікрофону (Vivox)", kEditor},
+    {ConfigSection::SOUND_PREFS, "volume_music", SettingType::FLOAT, 0.0, 1.0, 6, "Гучність: Музика", kEditor},
+    {ConfigSection::SOUND_PREFS, "volume_music_hangar", SettingType::FLOAT, 0.0, 1.0, 6, nullptr, 0},
+    {ConfigSection::SOUND_PREFS, "volume_vehicles", SettingType::FLOAT, 0.0, 1.0, 6, "Гучність: Техніка", kEditor},
+    {ConfigSection::SOUND_PREFS, "volume_voice", SettingType::FLOAT, 0.0, 1.0, 6, "Гучність: Голосові повідомлення", kEditor},
+
+    {ConfigSection::SCRIPTS_PREFERENCES, "fov", SettingType::FLOAT, 50.0, 130.0, 6, nullptr, 0},
+
+    {ConfigSection::CONTROL_CAMERA, "arcadeMode/horzInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Аркадний: Інверсія по горизонталі", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "arcadeMode/keySensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Аркадний: Чутливість клавіатури", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "arcadeMode/scrollSensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Аркадний: Чутливість прокрутки", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "arcadeMode/sensitivity", SettingType::FLOAT, 0.01, 3.0, 2, "Аркадний: Чутливість миші", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "arcadeMode/vertInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Аркадний: Інверсія по вертикалі", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "artyMode/horzInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Арт-САУ: Інверсія по горизонталі", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "artyMode/keySensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Арт-САУ: Чутливість клавіатури", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "artyMode/scrollSensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Арт-САУ: Чутливість прокрутки", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "artyMode/sensitivity", SettingType::FLOAT, 0.01, 3.0, 2, "Арт-САУ: Чутливість миші", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "artyMode/vertInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Арт-САУ: Інверсія по вертикалі", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "freeVideoMode/horzInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Вільна камера: Інверсія по горизонталі", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "freeVideoMode/keySensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Вільна камера: Чутливість клавіатури", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "freeVideoMode/scrollSensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Вільна камера: Чутливість прокрутки", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "freeVideoMode/sensitivity", SettingType::FLOAT, 0.01, 3.0, 2, "Вільна камера: Чутливість миші", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "freeVideoMode/vertInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Вільна камера: Інверсія по вертикалі", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "sniperMode/horzInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Снайперський: Інверсія по горизонталі", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "sniperMode/keySensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Снайперський: Чутливість клавіатури", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "sniperMode/scrollSensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Снайперський: Чутливість прокрутки", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "sniperMode/sensitivity", SettingType::FLOAT, 0.01, 3.0, 2, "Снайперський: Чутливість миші", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "sniperMode/vertInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Снайперський: Інверсія по вертикалі", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "strategicMode/horzInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Стратегічний: Інверсія по горизонталі", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "strategicMode/keySensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Стратегічний: Чутливість клавіатури", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "strategicMode/scrollSensitivity", SettingType::FLOAT, 0.01, 1.0, 2, "Стратегічний: Чутливість прокрутки", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "strategicMode/sensitivity", SettingType::FLOAT, 0.01, 3.0, 2, "Стратегічний: Чутливість миші", kEditor},
+    {ConfigSection::CONTROL_CAMERA, "strategicMode/vertInvert", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Стратегічний: Інверсія по вертикалі", kEditor},
+
+    {ConfigSection::GRAPHICS_PREFERENCES, "ParticlSystemNoRenderGroup", SettingType::INT, 65535, 65535, 0, "Група невидимих часток", kEditor},
+    {ConfigSection::GRAPHICS_PREFERENCES, "brightnessDeferred", SettingType::FLOAT, 0.0, 1.5, 6, "Яскравість", kEditor},
+    {ConfigSection::GRAPHICS_PREFERENCES, "colorGradingStrength", SettingType::FLOAT, 0.0, 1.5, 6, "Сила корекції кольору", kEditor},
+    {ConfigSection::GRAPHICS_PREFERENCES, "contrastDeferred", SettingType::FLOAT, 0.0, 1.5, 6, "Контрастність", kEditor},
+    {ConfigSection::GRAPHICS_PREFERENCES, "distributionLevel", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Рівень дистрибуції", kEditor},
+    {ConfigSection::GRAPHICS_PREFERENCES, "graphicsSettingsStatus", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Статус налаштувань графіки", kEditor},
+    {ConfigSection::GRAPHICS_PREFERENCES, "graphicsSettingsVersion", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Версія налаштувань графіки", kEditor},
+    {ConfigSection::GRAPHICS_PREFERENCES, "graphicsSettingsVersionMaintainance", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Патч версія нал. графіки", kEditor},
+    {ConfigSection::GRAPHICS_PREFERENCES, "graphicsSettingsVersionMinor", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Мінорна версія нал. графіки", kEditor},
+    {ConfigSection::GRAPHICS_PREFERENCES, "saturationDeferred", SettingType::FLOAT, 0.0, 1.5, 6, "Насиченість", kEditor},
+
+    {ConfigSection::GRAPHICS_ENTRY, "COLOR_GRADING_TECHNIQUE", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Техніка корекції кольору", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "CUSTOM_AA_MODE", SettingType::INT, 0, 2, 0, "Режим згладжування", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "DECOR_LEVEL", SettingType::INT, 0, 5, 0, "Якість ефектів (дрібні об'єкти)", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "DRR_AUTOSCALER_ENABLED", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Динамічна роздільна здатність", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "EFFECTS_QUALITY", SettingType::INT, 0, 4, 0, "Якість ефектів (вибухи, дим)", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "FAR_PLANE", SettingType::INT, 0, 3, 0, "Дальність промальовки", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "FLORA_QUALITY", SettingType::INT, 0, 4, 0, "Якість трави та рослинності", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "HAVOK_ENABLED", SettingType::BOOL_01, kNoMin, kNoMax, 0, "Фізика руйнувань Havok", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "HAVOK_QUALITY", SettingType::INT, 0, 2, 0, "Якість фізики Havok", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "LIGHTING_QUALITY", SettingType::INT, 0, 4, 0, "Якість освітлення", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "MOTION_BLUR_QUALITY", SettingType::INT, 0, 3, 0, "Якість розмиття в русі", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "MSAA_QUALITY", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Якість MSAA", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "OBJECT_LOD", SettingType::INT, 0, 4, 0, "Деталізація об'єктів", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "POST_PROCESSING_QUALITY", SettingType::INT, 0, 4, 0, "Якість постобробки", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "RENDER_PIPELINE", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Тип рендеру", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "SEMITRANSPARENT_LEAVES_ENABLED", SettingType::BOOL_01, kNoMin, kNoMax, 0, "Прозорість листя", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "SHADER_DEBUG", SettingType::NON_EDITABLE, kNoMin, kNoMax, 0, "Відладка шейдерів", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "SHADOWS_QUALITY", SettingType::INT, 0, 2, 0, "Якість тіней", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "SNIPER_MODE_EFFECTS_QUALITY", SettingType::INT, 0, 3, 0, "Якість ефектів (снайп. режим)", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "SNIPER_MODE_GRASS_ENABLED", SettingType::BOOL_01, kNoMin, kNoMax, 0, "Трава в снайп. режимі", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "SNIPER_MODE_SWINGING_ENABLED", SettingType::BOOL_01, kNoMin, kNoMax, 0, "Хитання камери (снайп. режим)", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "SNIPER_MODE_TERRAIN_TESSELLATION_ENABLED", SettingType::BOOL_01, kNoMin, kNoMax, 0, "Теселяція ландшафту (снайп. режим)", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "SPEEDTREE_QUALITY", SettingType::INT, 0, 3, 0, "Якість дерев", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "TERRAIN_QUALITY", SettingType::INT, 0, 5, 0, "Якість ландшафту", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "TERRAIN_TESSELLATION_ENABLED", SettingType::BOOL_01, kNoMin, kNoMax, 0, "Теселяція ландшафту", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "TEXTURE_QUALITY", SettingType::INT, 0, 4, 0, "Якість текстур", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "TRACK_PHYSICS_QUALITY", SettingType::INT, 0, 3, 0, "Фізика гусениць", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "VEHICLE_DUST_ENABLED", SettingType::BOOL_01, kNoMin, kNoMax, 0, "Пил з-під техніки", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "VEHICLE_TRACES_ENABLED", SettingType::BOOL_01, kNoMin, kNoMax, 0, "Сліди техніки", kEditor},
+    {ConfigSection::GRAPHICS_ENTRY, "WATER_QUALITY", SettingType::INT, 0, 3, 0, "Якість води", kEditor},
+
+    {ConfigSection::DEVICE_PREFERENCES, "aspectRatio", SettingType::FLOAT, 0.1, 10.0, 6, "Співвідношення сторін", kEditor},
+    {ConfigSection::DEVICE_PREFERENCES, "fullscreenHeight", SettingType::INT, 600, 4320, 0, "Висота (повний екран)", kEditor},
+    {ConfigSection::DEVICE_PREFERENCES, "fullscreenRefresh", SettingType::INT, 10, 400, 0, "Частота оновлення", kEditor},
+    {ConfigSection::DEVICE_PREFERENCES, "fullscreenWidth", SettingType::INT, 800, 7680, 0, "Ширина (повний екран)", kEditor},
+    {ConfigSection::DEVICE_PREFERENCES, "gamma", SettingType::FLOAT, 0.5, 2.5, 2, "Гамма", kEditor},
+    {ConfigSection::DEVICE_PREFERENCES, "tripleBuffering", SettingType::BOOL_TF, kNoMin, kNoMax, 0, "Потрійна буферизація", kEditor},
+    {ConfigSection::DEVICE_PREFERENCES, "windowMode", SettingType::INT, 0, 2, 0, "Режим вікна", kEditor},
+    {ConfigSection::DEVICE_PREFERENCES, "windowedHeight", SettingType::INT, 480, 4320, 0, "Висота (вікно)", kEditor},
+    {ConfigSection::DEVICE_PREFERENCES, "windowedWidth", SettingType::INT, 640, 7680, 0, "Ширина (вікно)", kEditor},
+};
+
+constexpr int compareTags(const char* a, const char* b) {
+    while (*a && *a == *b) { ++a; ++b; }
+    return static_cast<int>(static_cast<unsigned char>(*a)) - static_cast<int>(static_cast<unsigned char>(*b));
+}
+
+constexpr bool isSortedTable() {
+    for (std::size_t i = 1; i < std::size(kSpecs); ++i) {
+        const SettingSpec& prev = kSpecs[i - 1];
+        const SettingSpec& cur = kSpecs[i];
+        if (prev.section > cur.section) return false;
+        if (prev.section == cur.section && compareTags(prev.tag, cur.tag) >= 0) return false;
+    }
+    return true;
+}
+static_assert(isSortedTable(), "kSpecs must be sorted by (section, tag) without duplicates");
+
+// Порівнює tag з віртуальним рядком mode + "/" + setting, не створюючи його
+int compareComposite(std::string_view tag, std::string_view mode, std::string_view setting) {
+    const std::size_t total = mode.size() + 1 + setting.size();
+    const std::size_t n = std::min(tag.size(), total);
+    for (std::size_t i = 0; i < n; ++i) {
+        char c = i < mode.size() ? mode[i] : (i == mode.size() ? '/' : setting[i - mode.size() - 1]);
+        if (tag[i] != c) {
+            return static_cast<unsigned char>(tag[i]) < static_cast<unsigned char>(c) ? -1 : 1;
+        }
+    }
+    if (tag.size() == total) return 0;
+    return tag.size() < total ? -1 : 1;
+}
+
+struct SectionLess {
+    bool operator()(const SettingSpec& spec, ConfigSection section) const { return spec.section < section; }
+    bool operator()(ConfigSection section, const SettingSpec& spec) const { return section < spec.section; }
+};
+
+std::string_view trimView(const char* text) {
+    std::string_view v = text ? std::string_view(text) : std::string_view();
+    const char* ws = " \t\r\n";
+    std::size_t first = v.find_first_not_of(ws);
+    if (first == std::string_view::npos) return {};
+    std::size_t last = v.find_last_not_of(ws);
+    return v.substr(first, last - first + 1);
+}
+
+// Розбір числа без алокацій; як і раніше, весь текст (без пробілів по краях) має бути числом
+template <typename T>
+bool parseNumber(std::string_view text, T& out) {
+    if (text.empty()) return false;
+    const char* first = text.data();
+    const char* last = text.data() + text.size();
+    if (*first == '+') ++first; // istringstream приймав "+1", зберігаємо сумісність
+    auto res = std::from_chars(first, last, out);
+    if (res.ec != std::errc() || res.ptr != last) return false;
+    // from_chars приймає "nan" та "inf", які istringstream відхиляв; NaN до того ж проходить будь-яку перевірку діапазону
+    if constexpr (std::is_floating_point_v<T>) return std::isfinite(out);
+    return true;
+}
+
+std::string formatBound(double value) {
+    std::ostringstream ss;
+    ss << value;
+    return ss.str();
+}
+
+std::string errorPrefix(std::string_view key, std::string_view text) {
+    std::string prefix = "<";
+    prefix.append(key.data(), key.size());
+    prefix += ">: '";
+    prefix.append(text.data(), text.size());
+    prefix += "'. ";
+    return prefix;
+}
+
+} // namespace
+
+std::pair<const SettingSpec*, const SettingSpec*> SettingSchema::sectionSpecs(ConfigSection section) {
+    auto range = std::equal_range(std::begin(kSpecs), std::end(kSpecs), section, SectionLess());
+    return {range.first, range.second};
+}
+
+const SettingSpec* SettingSchema::find(ConfigSection section, std::string_view tag) {
+    auto range = sectionSpecs(section);
+    auto it = std::lower_bound(range.first, range.second, tag,
+                               [](const SettingSpec& spec, std::string_view t) { return std::string_view(spec.tag) < t; });
+    if (it != range.second && std::string_view(it->tag) == tag) return it;
+    return nullptr;
+}
+
+const SettingSpec* SettingSchema::findControl(std::string_view mode, std::string_view setting) {
+    auto range = sectionSpecs(ConfigSection::CONTROL_CAMERA);
+    auto it = std::lower_bound(range.first, range.second, 0,
+                               [&](const SettingSpec& spec, int) { return compareComposite(spec.tag, mode, setting) < 0; });
+    if (it != range.second && compareComposite(it->tag, mode, setting) == 0) return it;
+    return nullptr;
+}
+
+const SettingSpec* SettingSchema::findKey(std::string_view key) {
+    // Індекс будується один раз; ключі - string_view на літерали kSpecs, тож копій рядків немає.
+    // Ключі різних секцій не перетинаються. SCRIPTS_PREFERENCES не має ключів у FilteredSettingsMap.
+    static const std::unordered_map<std::string_view, const SettingSpec*> index = [] {
+        std::unordered_map<std::string_view, const SettingSpec*> map;
+        map.reserve(std::size(kSpecs));
+        for (const SettingSpec& spec : kSpecs) {
+            if (spec.section != ConfigSection::SCRIPTS_PREFERENCES) map.emplace(spec.tag, &spec);
+        }
+        return map;
+    }();
+    auto it = index.find(key);
+    return it != index.end() ? it->second : nullptr;
+}
+
+const SettingRule* SettingSchema::rule(std::string_view key) {
+    // Правила редактора паралельні kSpecs (той самий індекс), створюються при першому зверненні
+    static const std::vector<SettingRule> rules = [] {
+        std::vector<SettingRule> list;
+        list.reserve(std::size(kSpecs));
+        for (const SettingSpec& spec : kSpecs) {
+            std::string name = spec.displayName ? spec.displayName : ""; // Порожня назва - UI показує ключ
+            if (spec.type == SettingType::INT || spec.type == SettingType::FLOAT) {
+                list.emplace_back(spec.type, spec.minValue, spec.maxValue, spec.decimals, std::move(name));
+            } else {
+                list.emplace_back(spec.type, std::move(name));
+            }
+        }
+        return list;
+    }();
+    const SettingSpec* spec = findKey(key);
+    return spec ? &rules[static_cast<std::size_t>(spec - kSpecs)] : nullptr;
+}
+
+const char* SettingSchema::displayName(std::string_view key) {
+    const SettingSpec* spec = findKey(key);
+    return spec ? spec->displayName : nullptr;
+}
+
+bool SettingSchema::isEditorSetting(ConfigSection section, std::string_view tag) {
+    const SettingSpec* spec = find(section, tag);
+    return spec && (spec->flags & SettingSpec::EDITOR);
+}
+
+bool SettingSchema::isEditorControlSetting(std::string_view setting) {
+    // Набір налаштувань камери однаковий для всіх режимів, тож достатньо перевірити перший режим
+    auto range = sectionSpecs(ConfigSection::CONTROL_CAMERA);
+    if (range.first == range.second) return false;
+    const std::string_view firstKey = range.first->tag;
+    const std::string_view mode = firstKey.substr(0, firstKey.find('/'));
+    const SettingSpec* spec = findControl(mode, setting);
+    return spec && (spec->flags & SettingSpec::EDITOR);
+}
+
+const char* SettingSchema::categoryName(ConfigSection section) {
+    switch (section) {
+    case ConfigSection::SOUND_PREFS:          return "Sound Settings";
+    case ConfigSection::CONTROL_CAMERA:       return "Control Settings";
+    case ConfigSection::GRAPHICS_PREFERENCES:
+    case ConfigSection::GRAPHICS_ENTRY:       return "Graphics Settings";
+    case ConfigSection::DEVICE_PREFERENCES:   return "Device Settings";
+    default:                                  return nullptr;
+    }
+}
+
+bool SettingSchema::checkValue(const SettingSpec& spec, std::string_view key, const char* text, std::string& error) {
+    std::string_view value = trimView(text);
+
+    switch (spec.type) {
+    case SettingType::FLOAT: {
+        double number = 0.0;
+        if (!parseNumber(value, number)) {
+            error = errorPrefix(key, value) + "Очікується число.";
+            return false;
+        }
+        if (number < spec.minValue || number > spec.maxValue) {
+            error = errorPrefix(key, value) + "Очікується [" + formatBound(spec.minValue) + ", " + formatBound(spec.maxValue) + "].";
+            return false;
+        }
+        return true;
+    }
+    case SettingType::INT: {
+        int number = 0;
+        if (!parseNumber(value, number)) {
+            error = errorPrefix(key, value) + "Очікується ціле число.";
+            return false;
+        }
+        if (number < spec.minValue || number > spec.maxValue) {
+            error = errorPrefix(key, value) + "Очікується [" + formatBound(spec.minValue) + ", " + formatBound(spec.maxValue) + "].";
+            return false;
+        }
+        return true;
+    }
+    case SettingType::BOOL_TF:
+        if (value == "true" || value == "false") return true;
+        error = errorPrefix(key, value) + "Очікується true або false.";
+        return false;
+    case SettingType::BOOL_01:
+        if (value == "0" || value == "1") return true;
+        error = errorPrefix(key, value) + "Очікується 0 або 1.";
+        return false;
+    case SettingType::STRING:
+    case SettingType::NON_EDITABLE:
+    default:
+        return true;
+    }
+}
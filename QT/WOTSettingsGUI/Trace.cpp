@@ -0,0 +1,125 @@
+#include "main.h" // Головний заголовок (містить оголошення Trace, TraceScope)
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+
+struct TraceSpan {
+    const char* name = nullptr;
+    std::int64_t startNs = 0;
+    std::int64_t durationNs = 0;
+    std::uint32_t threadId = 0;
+};
+
+// Кільцевий буфер: нові проміжки витісняють найстаріші, пам'ять не росте
+struct TraceBuffer {
+    std::mutex mutex;
+    std::vector<TraceSpan> spans;
+    std::size_t next = 0;     // Куди писати наступний проміжок
+    std::uint64_t total = 0;  // Скільки записано за весь час (для кількості втрачених)
+    std::size_t capacity = Trace::kDefaultCapacity;
+};
+
+TraceBuffer& buffer() {
+    static TraceBuffer instance;
+    return instance;
+}
+
+// Короткі номери потоків для trace-event "tid" (у порядку першого запису)
+std::uint32_t currentThreadId() {
+    static std::atomic<std::uint32_t> counter{0};
+    thread_local const std::uint32_t id = ++counter;
+    return id;
+}
+
+const std::chrono::steady_clock::time_point& traceEpoch() {
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return epoch;
+}
+
+}
+
+void Trace::setEnabled(bool enabled) {
+    traceEpoch(); // Відлік часу - з першого ввімкнення
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Trace::setCapacity(std::size_t capacity) {
+    TraceBuffer& b = buffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.capacity = capacity > 0 ? capacity : 1;
+    b.spans.clear();
+    b.next = 0;
+    b.total = 0;
+}
+
+std::int64_t Trace::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - traceEpoch()).count();
+}
+
+void Trace::record(const char* name, std::int64_t startNs, std::int64_t endNs) {
+    TraceSpan span{name, startNs, endNs - startNs, currentThreadId()};
+    TraceBuffer& b = buffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    if (b.spans.size() < b.capacity) {
+        b.spans.push_back(span);
+    } else {
+        b.spans[b.next] = span;
+    }
+    b.next = (b.next + 1) % b.capacity;
+    ++b.total;
+}
+
+void Trace::clear() {
+    TraceBuffer& b = buffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.spans.clear();
+    b.next = 0;
+    b.total = 0;
+}
+
+std::size_t Trace::spanCount() {
+    TraceBuffer& b = buffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    return b.spans.size();
+}
+
+std::uint64_t Trace::droppedCount() {
+    TraceBuffer& b = buffer();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    return b.total - b.spans.size();
+}
+
+// Формат Trace Event (chrome://tracing, Perfetto): повні події "X" з часом у мікросекундах
+std::string Trace::exportChromeJson() {
+    std::vector<TraceSpan> spans;
+    {
+        TraceBuffer& b = buffer();
+        std::lock_guard<std::mutex> lock(b.mutex);
+        spans.reserve(b.spans.size());
+        // Від найстарішого до найновішого
+        const std::size_t start = b.spans.size() < b.capacity ? 0 : b.next;
+        for (std::size_t i = 0; i < b.spans.size(); ++i) spans.push_back(b.spans[(start + i) % b.spans.size()]);
+    }
+
+    std::string json = "{\"traceEvents\":[";
+    char numbers[96];
+    for (std::size_t i = 0; i < spans.size(); ++i) {
+        if (i > 0) json += ',';
+        json += "\n{\"name\":";
+        JsonText::appendQuoted(json, spans[i].name);
+        std::snprintf(numbers, sizeof(numbers), ",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u}",
+                      spans[i].startNs / 1000.0, spans[i].durationNs / 1000.0, static_cast<unsigned>(spans[i].threadId));
+        json += numbers;
+    }
+    json += "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return json;
+}
+
+void Trace::exportChromeTrace(const fs::path& target) {
+    const std::string json = exportChromeJson();
+    AtomicFile::writeBuffer(target, json.data(), json.size());
+}
@@ -0,0 +1,50 @@
+# Бекенд конфігуратора як статична бібліотека без залежності від Qt.
+# Підключається з головного CMakeLists.txt і з bench/ (include() цього файлу)
+if(NOT TARGET WOTSettingsCore)
+    find_package(Threads REQUIRED)
+
+    set(WOT_CORE_DIR ${CMAKE_CURRENT_LIST_DIR})
+
+    add_library(WOTSettingsCore STATIC
+        ${WOT_CORE_DIR}/AppInitializer.cpp
+        ${WOT_CORE_DIR}/AtomicFile.cpp
+        ${WOT_CORE_DIR}/BackupArchive.cpp
+        ${WOT_CORE_DIR}/BackupDelta.cpp
+        ${WOT_CORE_DIR}/BackupManager.cpp
+        ${WOT_CORE_DIR}/BackupStore.cpp
+        ${WOT_CORE_DIR}/ChangeTracker.cpp
+        ${WOT_CORE_DIR}/ConfigDiff.cpp
+        ${WOT_CORE_DIR}/ConfigEditor.cpp
+        ${WOT_CORE_DIR}/ConfigManager.cpp
+        ${WOT_CORE_DIR}/ConfigMerge.cpp
+        ${WOT_CORE_DIR}/ConfigWatcher.cpp
+        ${WOT_CORE_DIR}/DocumentCache.cpp
+        ${WOT_CORE_DIR}/FileLock.cpp
+        ${WOT_CORE_DIR}/FileValidator.cpp
+        ${WOT_CORE_DIR}/FilteredSettingsReader.cpp
+        ${WOT_CORE_DIR}/JsonText.cpp
+        ${WOT_CORE_DIR}/LogStore.cpp
+        ${WOT_CORE_DIR}/ProfileManager.cpp
+        ${WOT_CORE_DIR}/SettingNodeIndex.cpp
+        ${WOT_CORE_DIR}/SettingPatch.cpp
+        ${WOT_CORE_DIR}/SettingSchema.cpp
+        ${WOT_CORE_DIR}/Trace.cpp
+        ${WOT_CORE_DIR}/WorkerPool.cpp
+        ${WOT_CORE_DIR}/XmlUtil.cpp
+        ${WOT_CORE_DIR}/main.h             # Головний заголовок бекенду
+        ${WOT_CORE_DIR}/preferences_data.h # Дані XML за замовчуванням (AppInitializer.cpp)
+
+        # Pugixml
+        ${WOT_CORE_DIR}/pugixml/pugixml.cpp
+        ${WOT_CORE_DIR}/pugixml/pugixml.hpp
+        ${WOT_CORE_DIR}/pugixml/pugiconfig.hpp
+    )
+
+    # Споживачі бібліотеки бачать main.h та pugixml так само, як сам бекенд
+    target_include_directories(WOTSettingsCore PUBLIC
+        ${WOT_CORE_DIR}
+        ${WOT_CORE_DIR}/pugixml
+    )
+    target_compile_features(WOTSettingsCore PUBLIC cxx_std_17)
+    target_link_libraries(WOTSettingsCore PUBLIC Threads::Threads)
+endif()
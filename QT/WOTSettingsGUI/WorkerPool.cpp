@@ -0,0 +1,54 @@
+#include "main.h" // Головний заголовок (містить оголошення WorkerPool)
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+unsigned WorkerPool::defaultThreadCount() {
+    unsigned hw = std::thread::hardware_concurrency();
+    return hw > 0 ? hw : 1;
+}
+
+void WorkerPool::forEach(std::size_t count, unsigned threadCount, const std::function<void(std::size_t)>& task) {
+    if (count == 0) return;
+    if (threadCount == 0) threadCount = defaultThreadCount();
+    if (threadCount > count) threadCount = static_cast<unsigned>(count);
+
+    // Один потік - без накладних витрат на створення потоків
+    if (threadCount == 1) {
+        for (std::size_t i = 0; i < count; ++i) task(i);
+        return;
+    }
+
+    // Потоки забирають наступний індекс з атомарного лічильника: нерівномірні за часом
+    // завдання (великі/малі файли) самі розподіляються між потоками
+    std::atomic<std::size_t> nextIndex{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr firstError;
+    std::mutex errorMutex;
+
+    auto worker = [&]() {
+        for (;;) {
+            if (failed.load(std::memory_order_relaxed)) return;
+            std::size_t i = nextIndex.fetch_add(1, std::memory_order_relaxed);
+            if (i >= count) return;
+            try {
+                task(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!firstError) firstError = std::current_exception();
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned t = 1; t < threadCount; ++t) {
+        threads.emplace_back(worker);
+    }
+    worker(); // Поточний потік теж працює
+    for (auto& thread : threads) thread.join();
+
+    if (firstError) std::rethrow_exception(firstError);
+}
@@ -0,0 +1,14 @@
+#include "main.h" // Головний заголовок (містить оголошення XmlUtil)
+#include "pugixml/pugixml.hpp"
+
+pugi::xml_node XmlUtil::firstElement(const pugi::xml_node& parent) {
+    pugi::xml_node child = parent.first_child();
+    while (child && child.type() != pugi::node_element) child = child.next_sibling();
+    return child;
+}
+
+pugi::xml_node XmlUtil::nextElement(const pugi::xml_node& node) {
+    pugi::xml_node next = node.next_sibling();
+    while (next && next.type() != pugi::node_element) next = next.next_sibling();
+    return next;
+}
@@ -0,0 +1,781 @@
+// Бенчмарки бекенду (без Qt): розбір, валідація, фільтрація, збереження, резервні копії,
+// відновлення, лог і трасування на вбудованому еталонному конфігу (preferences_data.h) та на
+// синтетично збільшених копіях. Результати - JSON (stdout або --output), зведення - у stderr.
+//
+//   WOTSettingsBench [--output results.json] [--scales 1,4,16] [--min-time 0.3]
+//                    [--max-iterations 10000] [--history 1000] [--batch-files 64] [--prune-entries 30000]
+//                    [--filter підрядок]
+//
+// prune.check - не лише вимір: очищення синтетичного сховища звіряється з незалежною моделлю
+// політики, і розбіжність завершує програму з кодом 1. prune.check.failed_write (не на Windows)
+// перевіряє, що очищення, чий запис індексу не вдався, не псує наступне. Так само filter.streaming і
+// filter.memory на кожному вході звіряються з DOM-фільтром (getFilteredSettings).
+
+#include "main.h"
+#include "preferences_data.h"
+#include "pugixml/pugixml.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#ifndef _WIN32
+#include <csignal>      // Для SIGXFSZ
+#include <sys/resource.h> // Для setrlimit (збій запису індексу)
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    fs::path output;
+    std::vector<int> scales{1, 4, 16};
+    double minTime = 0.3;
+    std::size_t maxIterations = 10000;
+    std::size_t history = 1000;
+    std::size_t batchFiles = 64;
+    std::size_t pruneEntries = 30000;
+    std::string filter;
+};
+
+struct Result {
+    std::string name;
+    std::string input;
+    std::uintmax_t bytes = 0; // Обсяг даних за ітерацію (0 - не має сенсу)
+    std::size_t iterations = 0;
+    double meanNs = 0, medianNs = 0, minNs = 0, p95Ns = 0;
+    std::vector<std::pair<std::string, double>> metrics; // Додаткові величини (розмір, коефіцієнт тощо)
+};
+
+std::vector<Result> g_results;
+Options g_options;
+
+bool selected(const std::string& name) {
+    return g_options.filter.empty() || name.find(g_options.filter) != std::string::npos;
+}
+
+// Ітерації до min-time (щонайменше 5, не більше max-iterations); setup не входить у час
+Result& runCase(const std::string& name, const std::string& input, std::uintmax_t bytes,
+                const std::function<void()>& body, const std::function<void()>& setup = nullptr) {
+    static Result skipped;
+    if (!selected(name)) return skipped;
+
+    if (setup) setup();
+    body(); // Прогрів
+    std::vector<double> samples;
+    const auto start = Clock::now();
+    while (samples.size() < g_options.maxIterations &&
+           (samples.size() < 5 || std::chrono::duration<double>(Clock::now() - start).count() < g_options.minTime)) {
+        if (setup) setup();
+        const auto t0 = Clock::now();
+        body();
+        samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count());
+    }
+
+    Result result;
+    result.name = name;
+    result.input = input;
+    result.bytes = bytes;
+    result.iterations = samples.size();
+    std::sort(samples.begin(), samples.end());
+    double sum = 0;
+    for (double s : samples) sum += s;
+    result.meanNs = sum / samples.size();
+    result.medianNs = samples[samples.size() / 2];
+    result.minNs = samples.front();
+    result.p95Ns = samples[std::min(samples.size() - 1, samples.size() * 95 / 100)];
+
+    std::cerr << std::left << std::setw(28) << name << std::setw(14) << input << std::right << std::setw(12)
+              << std::fixed << std::setprecision(1) << result.medianNs / 1000.0 << " us";
+    if (bytes > 0) std::cerr << std::setw(10) << std::setprecision(1) << (bytes / 1e6) / (result.medianNs / 1e9) << " MB/s";
+    std::cerr << "  (" << result.iterations << " it)\n";
+    g_results.push_back(std::move(result));
+    return g_results.back();
+}
+
+// Однократний вимір (руйнівні операції, напр. очищення сховища)
+Result& recordOnce(const std::string& name, const std::string& input, double ns) {
+    Result result;
+    result.name = name;
+    result.input = input;
+    result.iterations = 1;
+    result.meanNs = result.medianNs = result.minNs = result.p95Ns = ns;
+    std::cerr << std::left << std::setw(28) << name << std::setw(14) << input << std::right << std::setw(12)
+              << std::fixed << std::setprecision(1) << ns / 1000.0 << " us  (1 it)\n";
+    g_results.push_back(std::move(result));
+    return g_results.back();
+}
+
+void writeFile(const fs::path& path, const std::string& content) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(content.data(), static_cast<std::streamsize>(content.size()));
+    if (!file) throw std::runtime_error("Не вдалося записати " + path.string());
+}
+
+std::uintmax_t directorySize(const fs::path& directory) {
+    std::uintmax_t total = 0;
+    for (const auto& entry : fs::recursive_directory_iterator(directory)) {
+        if (entry.is_regular_file()) total += entry.file_size();
+    }
+    return total;
+}
+
+// Збільшений конфіг: вміст <root> повторюється (factor - 1) разів у додаткових секціях.
+// Фільтр і перевірка структури дивляться лише на відомі секції, тож результат лишається коректним.
+std::string scaleConfig(const std::string& reference, int factor) {
+    const std::size_t open = reference.find("<root>");
+    const std::size_t close = reference.rfind("</root>");
+    if (factor <= 1 || open == std::string::npos || close == std::string::npos) return reference;
+    const std::string inner = reference.substr(open + 6, close - open - 6);
+    std::string scaled = reference.substr(0, close);
+    for (int i = 1; i < factor; ++i) {
+        scaled += "\t<benchCopy" + std::to_string(i) + ">" + inner + "</benchCopy" + std::to_string(i) + ">\n";
+    }
+    scaled += reference.substr(close);
+    return scaled;
+}
+
+// Позиції цифр у текстових вузлах: їх зміна дає нову коректну версію файлу
+std::vector<std::size_t> textDigitPositions(const std::string& xml) {
+    std::vector<std::size_t> positions;
+    bool inText = false;
+    for (std::size_t i = 0; i < xml.size(); ++i) {
+        if (xml[i] == '>') inText = true;
+        else if (xml[i] == '<') inText = false;
+        else if (inText && xml[i] >= '0' && xml[i] <= '9') positions.push_back(i);
+    }
+    return positions;
+}
+
+void mutate(std::string& xml, const std::vector<std::size_t>& digits, std::mt19937& rng, int count) {
+    if (digits.empty()) return;
+    for (int i = 0; i < count; ++i) {
+        const std::size_t pos = digits[rng() % digits.size()];
+        xml[pos] = static_cast<char>('0' + (xml[pos] - '0' + 1 + rng() % 9) % 10);
+    }
+}
+
+// Попередня синхронна реалізація ChangeTracker::logAction - еталон для порівняння
+void synchronousLogBaseline(const fs::path& logDir, const std::string& functionName, bool success, const std::string& details) {
+    if (!fs::exists(logDir)) fs::create_directory(logDir);
+    std::ofstream logFile(logDir / "logs.txt", std::ios::app);
+    auto now_c = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm now_tm;
+#ifdef _WIN32
+    localtime_s(&now_tm, &now_c);
+#else
+    localtime_r(&now_c, &now_tm);
+#endif
+    logFile << std::put_time(&now_tm, "%Y-%m-%d_%H:%M:%S") << " | " << functionName << " | Result: ["
+            << (success ? "OK" : "NOK") << "]";
+    if (!details.empty()) logFile << " | Details: " << details;
+    logFile << std::endl;
+}
+
+// Перша відмінність результату фільтра від еталону (DOM-фільтра); порожній рядок - результати однакові
+std::string filterMismatch(const FilteredSettingsMap& expected, const FilteredSettingsMap& actual) {
+    if (expected.size() != actual.size()) {
+        return "категорій " + std::to_string(actual.size()) + " замість " + std::to_string(expected.size());
+    }
+    for (auto e = expected.begin(), a = actual.begin(); e != expected.end(); ++e, ++a) {
+        if (e->first != a->first) return "категорія '" + a->first + "' замість '" + e->first + "'";
+        const auto& want = e->second;
+        const auto& got = a->second;
+        for (std::size_t i = 0; i < std::max(want.size(), got.size()); ++i) {
+            if (i >= got.size()) return e->first + ": бракує '" + want[i].first + "'";
+            if (i >= want.size()) return e->first + ": зайве '" + got[i].first + "'";
+            if (want[i] != got[i]) {
+                return e->first + ": '" + got[i].first + "'='" + got[i].second + "' замість '" + want[i].first + "'='" +
+                       want[i].second + "'";
+            }
+        }
+    }
+    return "";
+}
+
+// --- Набори бенчмарків ---
+
+void benchDocument(const std::string& input, const std::string& xml, const fs::path& dir) {
+    const fs::path path = dir / (input + ".xml");
+    writeFile(path, xml);
+    const std::uintmax_t bytes = xml.size();
+    FileValidator validator;
+    ConfigEditor editor;
+    DocumentCache& cache = DocumentCache::instance();
+
+    runCase("parse", input, bytes, [&] { DocumentCache::parseFile(path); });
+    runCase("validate", input, bytes, [&] { validator.validateFile(path); }, [&] { cache.clear(); });
+    runCase("validate.cached", input, bytes, [&] { validator.validateFile(path); });
+    runCase("filter", input, bytes, [&] { editor.getFilteredSettings(path); }, [&] { cache.clear(); });
+    runCase("filter.cached", input, bytes, [&] { editor.getFilteredSettings(path); });
+    // Потоковий і in-memory фільтри мають давати те саме, що DOM-фільтр; розбіжність завершує програму з кодом 1
+    if (selected("filter.streaming") || selected("filter.memory")) {
+        const FilteredSettingsMap expected = editor.getFilteredSettings(path);
+        std::string mismatch = filterMismatch(expected, editor.getFilteredSettingsStreaming(path));
+        if (!mismatch.empty()) throw std::runtime_error("filter.streaming (" + input + "): " + mismatch);
+        mismatch = filterMismatch(expected, ConfigEditor::extractFilteredSettings(xml.data(), xml.size()));
+        if (!mismatch.empty()) throw std::runtime_error("filter.memory (" + input + "): " + mismatch);
+    }
+    runCase("filter.streaming", input, bytes, [&] { editor.getFilteredSettingsStreaming(path); });
+    runCase("filter.memory", input, bytes, [&] { ConfigEditor::extractFilteredSettings(xml.data(), xml.size()); });
+
+    // Структурна різниця: копія з іншим порядком записів <entry> і кількома зміненими значеннями
+    {
+        std::shared_ptr<const ParsedDocument> base = DocumentCache::parseFile(path);
+        std::shared_ptr<const ParsedDocument> other = DocumentCache::parseFile(path);
+        pugi::xml_node graphics = other->doc->child("root").child("graphicsPreferences");
+        std::vector<pugi::xml_node> entries;
+        for (pugi::xml_node entry : graphics.children("entry")) entries.push_back(entry);
+        std::reverse(entries.begin(), entries.end());
+        for (pugi::xml_node entry : entries) {
+            graphics.append_move(entry);
+            entry.child("activeOption").text().set("1");
+        }
+        runCase("diff.identical", input, bytes, [&] { ConfigDiff::compare(*base->doc, *base->doc); });
+        const std::size_t count = ConfigDiff::compare(*base->doc, *other->doc).differences.size();
+        runCase("diff.reordered", input, bytes, [&] { ConfigDiff::compare(*base->doc, *other->doc); })
+            .metrics.emplace_back("differences", static_cast<double>(count));
+
+        // Тристороннє злиття: base - вихідний файл, theirs - змінені записи; ours відновлюється перед кожним прогоном
+        pugi::xml_document ours;
+        std::size_t applied = 0;
+        runCase("merge", input, bytes, [&] { applied = ConfigMerge::merge(base->doc.get(), ours, *other->doc).applied.size(); },
+                [&] { ours.reset(*base->doc); })
+            .metrics.emplace_back("applied", static_cast<double>(applied));
+    }
+
+    // Збереження: одна зміна і зміна всіх значень (масове редагування)
+    const FilteredSettingsMap original = editor.getFilteredSettings(path);
+    SettingChangeSet single;
+    for (const auto& category : original) {
+        if (!category.second.empty()) {
+            single.push_back({category.first, category.second.front().first, "", category.second.front().second});
+            break;
+        }
+    }
+    bool flip = false;
+    runCase("save.single", input, bytes, [&] {
+        flip = !flip;
+        SettingChangeSet change = single;
+        change.front().newValue = flip ? single.front().newValue + "1" : single.front().newValue;
+        editor.saveSettingChanges(path, change);
+    });
+
+    // Розширений режим: запис одного елемента за шляхом (останній елемент-значення документа, без правила)
+    {
+        std::shared_ptr<const ParsedDocument> parsed = DocumentCache::parseFile(path);
+        pugi::xml_node leaf = parsed->doc->child("root");
+        for (;;) {
+            pugi::xml_node child = leaf.last_child();
+            while (child && child.type() != pugi::node_element) child = child.previous_sibling();
+            if (!child) break;
+            leaf = child;
+        }
+        std::string key;
+        if (leaf && !ConfigEditor::nodeSpec(leaf, key)) {
+            const std::string nodePath = ConfigDiff::nodePath(leaf);
+            std::string nodeValue = leaf.text().as_string();
+            nodeValue.erase(0, nodeValue.find_first_not_of(" \t\r\n"));
+            nodeValue.erase(nodeValue.find_last_not_of(" \t\r\n") + 1);
+            std::string current = nodeValue;
+            runCase("save.node", input, bytes, [&] {
+                const std::string next = current == nodeValue ? nodeValue + "1" : nodeValue;
+                editor.saveNodeValue(path, nodePath, current, next);
+                current = next;
+            });
+        }
+    }
+
+    FilteredSettingsMap changed = original;
+    std::size_t settingCount = 0;
+    for (auto& category : changed) {
+        for (auto& setting : category.second) {
+            setting.second += "_b";
+            ++settingCount;
+        }
+    }
+    runCase("save.bulk", input, bytes, [&] {
+        flip = !flip;
+        editor.saveFilteredSettings(path, flip ? changed : original);
+    }).metrics.emplace_back("settings", static_cast<double>(settingCount));
+
+    // Масовий патч (SettingPatch): розбір + пошук вузлів + перевірка значень; dry_run - без запису
+    const SettingPatch patchA = SettingPatch::compile({{"SHADOWS_QUALITY", "2"}, {"fullscreenRefresh", "144"}, {"masterVolume", "0.5"}});
+    const SettingPatch patchB = SettingPatch::compile({{"SHADOWS_QUALITY", "1"}, {"fullscreenRefresh", "60"}, {"masterVolume", "0.25"}});
+    PatchOptions dryRun;
+    dryRun.dryRun = true;
+    runCase("patch.dry_run", input, bytes, [&] { patchA.apply(path, dryRun); });
+    runCase("patch.apply", input, bytes, [&] {
+        flip = !flip;
+        (flip ? patchA : patchB).apply(path);
+    });
+
+    // Атомарний запис (temp + fsync + rename) проти простого перезапису
+    const fs::path target = dir / (input + ".write.xml");
+    runCase("write.atomic", input, bytes, [&] { AtomicFile::writeBuffer(target, xml.data(), xml.size()); });
+    runCase("write.plain", input, bytes, [&] { writeFile(target, xml); });
+    runCase("copy.atomic", input, bytes, [&] { AtomicFile::copy(path, target); });
+}
+
+void benchBackups(const std::string& input, const std::string& xml, const fs::path& dir) {
+    const std::vector<std::size_t> digits = textDigitPositions(xml);
+    std::mt19937 rng(42);
+    const fs::path source = dir / (input + ".source.xml");
+    std::string current = xml;
+    const std::uintmax_t bytes = xml.size();
+
+    for (unsigned interval : {0u, 32u}) {
+        const std::string mode = interval == 0 ? "full" : "delta";
+        const fs::path storeDir = dir / ("store-" + input + "-" + mode);
+        BackupStore store(storeDir);
+        store.setKeyframeInterval(interval);
+        std::int64_t timestamp = 1700000000;
+        runCase("backup.add." + mode, input, bytes, [&] { store.add(source, timestamp++, "bench.xml"); },
+                [&] {
+                    mutate(current, digits, rng, 3);
+                    writeFile(source, current);
+                });
+        if (store.list().empty()) { // backup.add відфільтровано - для відновлення потрібна хоча б одна копія
+            writeFile(source, current);
+            store.add(source, timestamp++, "bench.xml");
+        }
+        const std::vector<BackupEntry> entries = store.list();
+        std::size_t next = 0;
+        const fs::path restored = dir / (input + ".restored.xml");
+        runCase("backup.restore." + mode, input, bytes, [&] { store.restore(entries[next++ % entries.size()], restored); });
+    }
+
+    // Дельта між двома сусідніми версіями
+    std::string changedVersion = xml;
+    mutate(changedVersion, digits, rng, 3);
+    std::string delta;
+    runCase("delta.encode", input, bytes, [&] { delta = BackupDelta::encode(xml, changedVersion); })
+        .metrics.emplace_back("delta_bytes", static_cast<double>(BackupDelta::encode(xml, changedVersion).size()));
+    runCase("delta.apply", input, bytes, [&] { BackupDelta::apply(xml, delta); });
+}
+
+// Синтетична історія з N версій: обсяг сховища і час відновлення в обох режимах, потім очищення
+void benchHistory(const std::string& input, const std::string& xml, const fs::path& dir) {
+    if (!selected("history")) return;
+    const std::vector<std::size_t> digits = textDigitPositions(xml);
+    const fs::path source = dir / "history.source.xml";
+    for (unsigned interval : {0u, 32u}) {
+        const std::string mode = interval == 0 ? "full" : "delta";
+        const fs::path storeDir = dir / ("history-" + mode);
+        std::mt19937 rng(7);
+        std::string current = xml;
+        std::uintmax_t rawBytes = 0;
+        BackupStore store(storeDir);
+        store.setKeyframeInterval(interval);
+        const std::int64_t start = 1700000000;
+        const auto addStart = Clock::now();
+        for (std::size_t i = 0; i < g_options.history; ++i) {
+            mutate(current, digits, rng, 3);
+            writeFile(source, current);
+            store.add(source, start + static_cast<std::int64_t>(i) * 3600, "history.xml");
+            rawBytes += current.size();
+        }
+        const double addNs = std::chrono::duration<double, std::nano>(Clock::now() - addStart).count();
+        const std::uintmax_t storedBytes = directorySize(storeDir);
+        Result& add = recordOnce("history.build." + mode, input, addNs);
+        add.metrics.emplace_back("versions", static_cast<double>(g_options.history));
+        add.metrics.emplace_back("raw_bytes", static_cast<double>(rawBytes));
+        add.metrics.emplace_back("stored_bytes", static_cast<double>(storedBytes));
+        add.metrics.emplace_back("storage_ratio", static_cast<double>(rawBytes) / static_cast<double>(storedBytes));
+
+        const std::vector<BackupEntry> entries = store.list();
+        std::size_t next = 0;
+        runCase("history.restore." + mode, input, xml.size(), [&] { store.read(entries[(next += 7919) % entries.size()]); });
+
+        RetentionPolicy policy; // Політика програми за замовчуванням
+        const auto pruneStart = Clock::now();
+        const RetentionReport report = store.prune(policy, start + static_cast<std::int64_t>(g_options.history) * 3600);
+        Result& prune = recordOnce("history.prune." + mode, input,
+                                   std::chrono::duration<double, std::nano>(Clock::now() - pruneStart).count());
+        prune.metrics.emplace_back("kept_entries", static_cast<double>(report.keptEntries));
+        prune.metrics.emplace_back("removed_entries", static_cast<double>(report.removedEntries));
+        prune.metrics.emplace_back("reclaimed_bytes", static_cast<double>(report.reclaimedBytes));
+    }
+}
+
+// Пакетна валідація (FileValidator::validateFiles): файлів за секунду залежно від кількості потоків
+void benchBatchValidation(const std::string& input, const std::string& xml, const fs::path& dir) {
+    if (!selected("validate.batch")) return;
+    const fs::path batchDir = dir / "batch";
+    fs::create_directories(batchDir);
+    const std::vector<std::size_t> digits = textDigitPositions(xml);
+    std::mt19937 rng(11);
+    std::vector<fs::path> files;
+    for (std::size_t i = 0; i < g_options.batchFiles; ++i) {
+        std::string version = xml;
+        mutate(version, digits, rng, 3);
+        files.push_back(batchDir / ("config" + std::to_string(i) + ".xml"));
+        writeFile(files.back(), version);
+    }
+
+    // 1, 2, 4, ... до подвоєної кількості апаратних потоків (видно і ефект перевантаження) та сама кількість ядер
+    const unsigned hardware = WorkerPool::defaultThreadCount();
+    std::vector<unsigned> threadCounts{hardware};
+    for (unsigned threads = 1; threads <= 2 * hardware; threads *= 2) {
+        if (threads != hardware) threadCounts.push_back(threads);
+    }
+    std::sort(threadCounts.begin(), threadCounts.end());
+
+    FileValidator validator;
+    for (unsigned threads : threadCounts) {
+        std::size_t valid = 0;
+        Result& result = runCase("validate.batch", input + "/t" + std::to_string(threads), xml.size() * files.size(),
+                                 [&] { valid = validator.validateFiles(files, threads).validCount; });
+        result.metrics.emplace_back("threads", threads);
+        result.metrics.emplace_back("files", static_cast<double>(files.size()));
+        result.metrics.emplace_back("files_per_s", static_cast<double>(files.size()) / (result.medianNs / 1e9));
+        result.metrics.emplace_back("valid", static_cast<double>(valid));
+    }
+    fs::remove_all(batchDir);
+}
+
+void check(bool condition, const std::string& what) {
+    if (!condition) throw std::runtime_error("prune.check: " + what);
+}
+
+// Еталон RetentionPolicy, записаний окремо від BackupStore::prune: номери записів, що мають лишитися
+std::vector<std::size_t> expectedRetention(const std::vector<BackupEntry>& entries, const RetentionPolicy& policy,
+                                           std::int64_t now) {
+    const std::size_t count = entries.size();
+    std::vector<bool> keep(count, false);
+    for (std::size_t i = count - std::min(count, std::max<std::size_t>(policy.keepLast, 1)); i < count; ++i) keep[i] = true;
+    for (const auto& rule : {std::make_pair<std::int64_t, int>(86400, int(policy.keepDailyDays)),
+                             std::make_pair<std::int64_t, int>(7 * 86400, int(policy.keepWeeklyWeeks))}) {
+        if (rule.second <= 0) continue;
+        std::map<std::int64_t, std::size_t> newest; // Кошик -> найновіший запис у ньому
+        for (std::size_t i = 0; i < count; ++i) {
+            if (entries[i].timestamp >= now - rule.first * rule.second) newest[entries[i].timestamp / rule.first] = i;
+        }
+        for (const auto& bucket : newest) keep[bucket.second] = true;
+    }
+    if (policy.maxTotalBytes > 0) {
+        auto uniqueBytes = [&] {
+            std::map<std::string, std::uintmax_t> objects;
+            for (std::size_t i = 0; i < count; ++i) {
+                if (keep[i]) objects[entries[i].hash] = entries[i].size;
+            }
+            std::uintmax_t total = 0;
+            for (const auto& object : objects) total += object.second;
+            return total;
+        };
+        for (std::size_t i = 0; i + 1 < count && uniqueBytes() > policy.maxTotalBytes; ++i) keep[i] = false;
+    }
+    std::vector<std::size_t> kept;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (keep[i]) kept.push_back(i);
+    }
+    return kept;
+}
+
+bool sameEntries(const std::vector<BackupEntry>& a, const std::vector<BackupEntry>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const BackupEntry& x, const BackupEntry& y) {
+        return x.id == y.id && x.timestamp == y.timestamp && x.hash == y.hash && x.size == y.size && x.name == y.name;
+    });
+}
+
+// Синтетичне сховище: копія кожні 10 хвилин (pruneEntries записів), вміст змінюється кожну 10-ту копію.
+// Перевіряються залишені записи, звільнені об'єкти й байти, повторне читання індексу і вміст записів.
+void benchPruneCheck(const std::string& input, const std::string& xml, const fs::path& dir) {
+    if (!selected("prune.check")) return;
+    const fs::path storeDir = dir / "prune-check";
+    const fs::path source = dir / "prune-check.source.xml";
+    std::string base = xml.substr(0, std::min<std::size_t>(xml.size(), 4096)); // Малий вміст - швидке наповнення
+    const std::vector<std::size_t> digits = textDigitPositions(base);
+    std::string current;
+    std::mt19937 rng(3);
+    const std::int64_t start = 1700000000;
+    const std::int64_t step = 600;
+
+    BackupStore store(storeDir);
+    const auto buildStart = Clock::now();
+    for (std::size_t i = 0; i < g_options.pruneEntries; ++i) {
+        if (i % 10 == 0) {
+            mutate(base, digits, rng, 1);
+            current = base + "<!--" + std::to_string(i) + "-->"; // Гарантовано новий вміст
+            writeFile(source, current);
+        }
+        store.add(source, start + static_cast<std::int64_t>(i) * step, "prune.xml");
+    }
+    recordOnce("prune.check.build", input, std::chrono::duration<double, std::nano>(Clock::now() - buildStart).count())
+        .metrics.emplace_back("entries", static_cast<double>(g_options.pruneEntries));
+
+    const std::vector<BackupEntry> before = store.list();
+    check(before.size() == g_options.pruneEntries, "кількість записів після наповнення");
+    const std::int64_t now = before.back().timestamp + 1;
+
+    auto runAndCheck = [&](const std::string& name, const RetentionPolicy& policy) {
+        const std::vector<BackupEntry> entries = store.list();
+        const BackupArchive::Stats archiveBefore = store.archiveStats();
+        std::vector<BackupEntry> expected;
+        for (std::size_t i : expectedRetention(entries, policy, now)) expected.push_back(entries[i]);
+        std::set<std::string> hashesBefore, hashesAfter;
+        for (const BackupEntry& entry : entries) hashesBefore.insert(entry.hash);
+        std::uintmax_t expectedTotal = 0;
+        for (const BackupEntry& entry : expected) {
+            if (hashesAfter.insert(entry.hash).second) expectedTotal += entry.size;
+        }
+
+        const auto pruneStart = Clock::now();
+        const RetentionReport report = store.prune(policy, now);
+        Result& result = recordOnce(name, input, std::chrono::duration<double, std::nano>(Clock::now() - pruneStart).count());
+        result.metrics.emplace_back("kept_entries", static_cast<double>(report.keptEntries));
+        result.metrics.emplace_back("removed_objects", static_cast<double>(report.removedObjects));
+        result.metrics.emplace_back("reclaimed_bytes", static_cast<double>(report.reclaimedBytes));
+
+        const BackupArchive::Stats archiveAfter = store.archiveStats();
+        check(report.keptEntries == expected.size() && report.removedEntries == entries.size() - expected.size(),
+              name + ": кількість залишених записів " + std::to_string(report.keptEntries) + ", очікувалось " + std::to_string(expected.size()));
+        check(sameEntries(store.list(), expected), name + ": залишені записи не збігаються з моделлю");
+        check(report.totalBytes == expectedTotal, name + ": обсяг унікального вмісту");
+        check(report.removedObjects == hashesBefore.size() - hashesAfter.size(), name + ": кількість звільнених об'єктів");
+        check(archiveAfter.blocks == hashesAfter.size(), name + ": блоки архіву після очищення");
+        check(report.reclaimedBytes == archiveBefore.blockBytes - archiveAfter.blockBytes, name + ": звільнені байти");
+
+        // Новий екземпляр читає індекси з диска
+        BackupStore reloaded(storeDir);
+        check(sameEntries(reloaded.list(), expected), name + ": перечитаний індекс не збігається");
+        check(reloaded.archiveStats().blockBytes == archiveAfter.blockBytes, name + ": перечитаний індекс архіву");
+        for (const BackupEntry& entry : expected) reloaded.read(entry); // Хеш вмісту перевіряється в read
+        check(store.prune(policy, now).removedEntries == 0, name + ": повторне очищення щось видалило");
+    };
+
+    runAndCheck("prune.check.policy", RetentionPolicy());
+    // Межа обсягу, менша за залишений вміст: витісняються найстаріші записи
+    RetentionPolicy capped;
+    capped.maxTotalBytes = current.size() * 5;
+    runAndCheck("prune.check.cap", capped);
+    check(store.list().back().id == before.back().id, "найновіший запис видалено");
+}
+
+#ifndef _WIN32
+// Обмеження розміру файлів процесу: запис тимчасового індексу впирається в нього (EFBIG), як у заповнений диск
+class FileSizeLimit {
+public:
+    explicit FileSizeLimit(rlim_t bytes) {
+        m_signal = std::signal(SIGXFSZ, SIG_IGN);
+        getrlimit(RLIMIT_FSIZE, &m_previous);
+        rlimit limit = m_previous;
+        limit.rlim_cur = bytes;
+        setrlimit(RLIMIT_FSIZE, &limit);
+    }
+    ~FileSizeLimit() {
+        setrlimit(RLIMIT_FSIZE, &m_previous);
+        std::signal(SIGXFSZ, m_signal);
+    }
+private:
+    rlimit m_previous{};
+    void (*m_signal)(int) = SIG_DFL;
+};
+
+// Очищення, чий запис індексу не вдався, не має лишати в пам'яті зменшені лічильники: наступне очищення
+// з іншою політикою інакше видалить вміст, на який ще посилаються записи. Вміст a, a, b, a (дельти ввімкнено):
+// перше очищення лишає лише останній запис і падає на записі індексу; друге (денні кошики) лишає 2, 3 і 4.
+void benchFailedPruneWrite(const std::string& input, const std::string& xml, const fs::path& dir) {
+    if (!selected("prune.check")) return;
+    const fs::path storeDir = dir / "prune-failed-write";
+    const fs::path source = dir / "prune-failed-write.source.xml";
+    const std::string base = xml.substr(0, std::min<std::size_t>(xml.size(), 4096));
+    const std::int64_t day = 24 * 60 * 60;
+    const std::int64_t start = 1700000000 - 1700000000 % day;
+    const std::vector<std::pair<std::string, std::int64_t>> versions = {
+        {"a", start}, {"a", start + 3600}, {"b", start + day}, {"a", start + 2 * day}};
+
+    BackupStore store(storeDir);
+    store.setKeyframeInterval(4);
+    for (const auto& version : versions) {
+        writeFile(source, base + "<!--" + version.first + "-->");
+        store.add(source, version.second, "prune.xml");
+    }
+    const std::int64_t now = start + 2 * day + 3600;
+
+    RetentionPolicy lastOnly;
+    lastOnly.keepLast = 1;
+    lastOnly.keepDailyDays = 0;
+    lastOnly.keepWeeklyWeeks = 0;
+    bool failed = false;
+    {
+        FileSizeLimit limit(16); // Менше за будь-який індекс
+        try {
+            store.prune(lastOnly, now);
+        } catch (const std::runtime_error&) {
+            failed = true;
+        }
+    }
+    check(failed, "failed_write: запис індексу мав завершитися помилкою");
+    check(store.list().size() == versions.size(), "failed_write: записи зникли після невдалого очищення");
+
+    RetentionPolicy daily = lastOnly;
+    daily.keepDailyDays = 7;
+    const auto pruneStart = Clock::now();
+    const RetentionReport report = store.prune(daily, now);
+    Result& result = recordOnce("prune.check.failed_write", input,
+                                std::chrono::duration<double, std::nano>(Clock::now() - pruneStart).count());
+    result.metrics.emplace_back("kept_entries", static_cast<double>(report.keptEntries));
+    result.metrics.emplace_back("removed_objects", static_cast<double>(report.removedObjects));
+    check(report.keptEntries == 3 && report.removedObjects == 0, "failed_write: друге очищення видалило забагато");
+
+    BackupStore reloaded(storeDir);
+    const std::vector<BackupEntry> kept = reloaded.list();
+    check(kept.size() == 3 && kept.front().id == 2, "failed_write: перечитаний індекс");
+    for (const BackupEntry& entry : kept) reloaded.read(entry); // Хеш вмісту перевіряється в read
+}
+#endif
+
+void benchLogging(const fs::path& dir) {
+    const std::string details = "preferences.xml | Graphics Settings/TEXTURE_QUALITY: '1' -> '2'";
+    ChangeTracker tracker;
+    runCase("log.async", "-", 0, [&] { tracker.logAction("ConfigEditor::saveSettingChanges", true, details); });
+    const auto flushStart = Clock::now();
+    ChangeTracker::flush();
+    recordOnce("log.async.flush", "-", std::chrono::duration<double, std::nano>(Clock::now() - flushStart).count());
+    runCase("log.sync_baseline", "-", 0, [&] { synchronousLogBaseline(dir / "baseline", "ConfigEditor::saveSettingChanges", true, details); });
+    runCase("log.history.last100", "-", 0, [&] { ChangeTracker::readHistory(LogQuery{100}); });
+
+    runCase("trace.disabled", "-", 0, [] {
+        for (int i = 0; i < 1000; ++i) TraceScope scope("bench");
+    }).metrics.emplace_back("spans_per_iteration", 1000);
+    Trace::setEnabled(true);
+    runCase("trace.enabled", "-", 0, [] {
+        for (int i = 0; i < 1000; ++i) TraceScope scope("bench");
+    }).metrics.emplace_back("spans_per_iteration", 1000);
+    Trace::setEnabled(false);
+    Trace::clear();
+}
+
+// {"schema":1,"timestamp":...,"compiler":...,"config":{...},"results":[{...}]}
+void writeJson(std::ostream& out) {
+    out << std::setprecision(10);
+    out << "{\n  \"schema\": 1,\n  \"timestamp\": " << std::time(nullptr) << ",\n  \"compiler\": ";
+#if defined(__clang__)
+    out << JsonText::quoted(std::string("clang ") + __clang_version__);
+#elif defined(__GNUC__)
+    out << JsonText::quoted(std::string("gcc ") + __VERSION__);
+#elif defined(_MSC_VER)
+    out << JsonText::quoted("msvc " + std::to_string(_MSC_VER));
+#else
+    out << JsonText::quoted("unknown");
+#endif
+    out << ",\n  \"config\": {\"min_time\": " << g_options.minTime << ", \"max_iterations\": " << g_options.maxIterations
+        << ", \"history\": " << g_options.history << ", \"batch_files\": " << g_options.batchFiles
+        << ", \"prune_entries\": " << g_options.pruneEntries
+        << ", \"reference_bytes\": " << preferences_xml_len << "},\n";
+    out << "  \"results\": [";
+    for (std::size_t i = 0; i < g_results.size(); ++i) {
+        const Result& r = g_results[i];
+        out << (i ? ",\n" : "\n") << "    {\"name\": ";
+        out << JsonText::quoted(r.name);
+        out << ", \"input\": ";
+        out << JsonText::quoted(r.input);
+        out << ", \"bytes\": " << r.bytes << ", \"iterations\": " << r.iterations << ", \"mean_ns\": " << r.meanNs
+            << ", \"median_ns\": " << r.medianNs << ", \"min_ns\": " << r.minNs << ", \"p95_ns\": " << r.p95Ns;
+        if (r.bytes > 0) out << ", \"mb_per_s\": " << (r.bytes / 1e6) / (r.medianNs / 1e9);
+        for (const auto& metric : r.metrics) {
+            out << ", ";
+            out << JsonText::quoted(metric.first);
+            out << ": " << (std::isfinite(metric.second) ? metric.second : 0.0);
+        }
+        out << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+bool parseOptions(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--output" && hasValue) {
+            g_options.output = argv[++i];
+        } else if (arg == "--scales" && hasValue) {
+            g_options.scales.clear();
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                if (std::atoi(item.c_str()) > 0) g_options.scales.push_back(std::atoi(item.c_str()));
+            }
+        } else if (arg == "--min-time" && hasValue) {
+            g_options.minTime = std::atof(argv[++i]);
+        } else if (arg == "--max-iterations" && hasValue) {
+            g_options.maxIterations = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--history" && hasValue) {
+            g_options.history = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--batch-files" && hasValue) {
+            g_options.batchFiles = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--prune-entries" && hasValue) {
+            g_options.pruneEntries = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--filter" && hasValue) {
+            g_options.filter = argv[++i];
+        } else {
+            std::cerr << "Usage: WOTSettingsBench [--output file.json] [--scales 1,4,16] [--min-time seconds]\n"
+                         "                        [--max-iterations N] [--history N] [--batch-files N]\n"
+                         "                        [--prune-entries N] [--filter substring]\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    if (!parseOptions(argc, argv)) return 2;
+    if (!g_options.output.empty()) g_options.output = fs::absolute(g_options.output);
+
+    // Усі файли (зокрема "User Data" логу) - у тимчасовій директорії, що видаляється в кінці
+    const fs::path workDir = fs::temp_directory_path() /
+                             ("wot-bench-" + std::to_string(Clock::now().time_since_epoch().count()));
+    fs::create_directories(workDir);
+    const fs::path previousDir = fs::current_path();
+    fs::current_path(workDir);
+
+    int exitCode = 0;
+    try {
+        const std::string reference(reinterpret_cast<const char*>(preferences_xml), preferences_xml_len);
+        for (int scale : g_options.scales) {
+            const std::string input = scale == 1 ? "reference" : "scaled_x" + std::to_string(scale);
+            const std::string xml = scaleConfig(reference, scale);
+            benchDocument(input, xml, workDir);
+            benchBackups(input, xml, workDir);
+        }
+        benchBatchValidation("reference", reference, workDir);
+        benchHistory("reference", reference, workDir);
+        benchPruneCheck("reference", reference, workDir);
+#ifndef _WIN32
+        benchFailedPruneWrite("reference", reference, workDir);
+#endif
+        benchLogging(workDir);
+        ChangeTracker::flush();
+    } catch (const std::exception& e) {
+        std::cerr << "Benchmark failed: " << e.what() << std::endl;
+        exitCode = 1;
+    }
+
+    fs::current_path(previousDir);
+    std::error_code ec;
+    fs::remove_all(workDir, ec);
+
+    if (g_options.output.empty()) {
+        writeJson(std::cout);
+    } else {
+        std::ofstream out(g_options.output, std::ios::trunc);
+        writeJson(out);
+        if (!out) {
+            std::cerr << "Не вдалося записати " << g_options.output.string() << std::endl;
+            return 1;
+        }
+    }
+    return exitCode;
+}
@@ -0,0 +1,438 @@
+// Неінтерактивний консольний інструмент для масових операцій з конфігами (без Qt).
+// Результат кожної команди - один JSON-документ у stdout; діагностика - у stderr.
+//
+//   WOTSettingsCli [--workdir DIR] [--jobs N] <команда> ...
+//     validate [--no-recursive] <вхід>...        Валідація файлів (паралельно)
+//     backup [--list] [--no-prune]               Резервна копія поточного preferences.xml гри
+//     apply [--accept-warnings] [--no-backup] [--merge [--prefer-game]] <config.xml>
+//                                                Застосування конфігу (з копією поточного);
+//                                                --merge - лише керовані налаштування (ConfigMerge)
+//     diff [--settings-only] <a.xml> <b.xml>     Структурна різниця (ConfigDiff)
+//     set [--dry-run] [--strict] <ключ=значення>... -- <вхід>...
+//                                                Зміна налаштувань у багатьох файлах (SettingPatch)
+//
+// Вхід - файл, директорія (усі *.xml, рекурсивно) або шаблон з * і ? в імені файлу.
+// Код виходу: 0 - успіх, 1 - хоча б один файл/дія з помилкою, 2 - неправильні аргументи.
+
+#include "main.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <set>
+#include <sstream>
+
+namespace {
+
+struct UsageError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+struct Options {
+    unsigned jobs = 0; // 0 - усі ядра
+    fs::path baseDir;  // Директорія запуску, якщо --workdir її змінив (відносні входи - від неї)
+    std::vector<std::string> args; // Аргументи після назви команди
+};
+
+std::string jsonPath(const fs::path& path) {
+    return JsonText::quoted(path.generic_u8string());
+}
+
+std::string jsonStringArray(const std::vector<std::string>& values) {
+    std::string out = "[";
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        if (i > 0) out += ", ";
+        out += JsonText::quoted(values[i]);
+    }
+    out += "]";
+    return out;
+}
+
+std::string jsonBackupEntry(const BackupEntry& entry) {
+    std::ostringstream out;
+    out << "{\"id\": " << entry.id << ", \"timestamp\": " << entry.timestamp << ", \"name\": " << JsonText::quoted(entry.name)
+        << ", \"hash\": " << JsonText::quoted(entry.hash) << ", \"size\": " << entry.size << "}";
+    return out.str();
+}
+
+// Очищення старих копій за політикою зберігання. Як і в GUI, помилка тут не скасовує вже створену копію:
+// її текст повертається у warning, а результатом стає null
+std::string jsonPruneBackups(BackupManager& backupManager, ChangeTracker& logger, std::string& warning) {
+    RetentionReport report;
+    try {
+        report = backupManager.manageBackupSpace();
+    } catch (const std::exception& e) {
+        warning = e.what();
+        logger.logAction("BackupManager::manageBackupSpace", false, warning);
+        std::cerr << "WARNING: " << warning << '\n';
+        return "null";
+    }
+    logger.logAction("BackupManager::manageBackupSpace", true,
+                     "kept: " + std::to_string(report.keptEntries) + ", removed: " + std::to_string(report.removedEntries) +
+                         ", reclaimed bytes: " + std::to_string(report.reclaimedBytes));
+    std::ostringstream out;
+    out << "{\"kept\": " << report.keptEntries << ", \"removed\": " << report.removedEntries
+        << ", \"reclaimed_bytes\": " << report.reclaimedBytes << "}";
+    return out.str();
+}
+
+std::string jsonChanges(const SettingChangeSet& changes) {
+    std::string out = "[";
+    for (std::size_t i = 0; i < changes.size(); ++i) {
+        if (i > 0) out += ", ";
+        out += "{\"category\": " + JsonText::quoted(changes[i].category) + ", \"key\": " + JsonText::quoted(changes[i].key) +
+               ", \"old\": " + JsonText::quoted(changes[i].oldValue) + ", \"new\": " + JsonText::quoted(changes[i].newValue) + "}";
+    }
+    out += "]";
+    return out;
+}
+
+// Шаблон імені файлу: * - будь-яка послідовність, ? - один символ
+bool wildcardMatch(const std::string& pattern, const std::string& name) {
+    std::size_t p = 0, n = 0, starP = std::string::npos, starN = 0;
+    while (n < name.size()) {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == name[n])) {
+            ++p;
+            ++n;
+        } else if (p < pattern.size() && pattern[p] == '*') {
+            starP = p++;
+            starN = n;
+        } else if (starP != std::string::npos) {
+            p = starP + 1;
+            n = ++starN;
+        } else {
+            return false;
+        }
+    }
+    while (p < pattern.size() && pattern[p] == '*') ++p;
+    return p == pattern.size();
+}
+
+fs::path inputPath(const Options& options, const std::string& input) {
+    const fs::path path(input);
+    return options.baseDir.empty() || path.is_absolute() ? path : options.baseDir / path;
+}
+
+// Розгортає входи у список файлів (без повторів, у порядку входів)
+std::vector<fs::path> expandInputs(const Options& options, const std::vector<std::string>& inputs, bool recursive) {
+    std::vector<fs::path> files;
+    for (const std::string& input : inputs) {
+        const fs::path path = inputPath(options, input);
+        const std::string name = path.filename().string();
+        if (name.find_first_of("*?") != std::string::npos) {
+            const fs::path dir = path.has_parent_path() ? path.parent_path() : fs::path(".");
+            std::vector<fs::path> matched;
+            std::error_code ec;
+            for (const auto& entry : fs::directory_iterator(dir, fs::directory_options::skip_permission_denied, ec)) {
+                if (entry.is_regular_file(ec) && wildcardMatch(name, entry.path().filename().string())) {
+                    matched.push_back(entry.path());
+                }
+            }
+            if (ec) throw std::runtime_error("Не вдалося прочитати директорію: " + dir.string() + " (" + ec.message() + ")");
+            std::sort(matched.begin(), matched.end());
+            files.insert(files.end(), matched.begin(), matched.end());
+        } else if (fs::is_directory(path)) {
+            std::vector<fs::path> found = FileValidator::collectXmlFiles(path, recursive);
+            files.insert(files.end(), found.begin(), found.end());
+        } else {
+            files.push_back(path); // Відсутній файл потрапить у звіт як помилка
+        }
+    }
+    std::vector<fs::path> unique;
+    unique.reserve(files.size());
+    std::set<fs::path> seen;
+    for (const fs::path& file : files) {
+        if (seen.insert(file.lexically_normal()).second) unique.push_back(file);
+    }
+    return unique;
+}
+
+int runValidate(const Options& options) {
+    bool recursive = true;
+    std::vector<std::string> inputs;
+    for (const std::string& arg : options.args) {
+        if (arg == "--no-recursive") recursive = false;
+        else inputs.push_back(arg);
+    }
+    if (inputs.empty()) throw UsageError("validate: не вказано жодного файлу або директорії");
+
+    FileValidator validator;
+    const BatchValidationReport report = validator.validateFiles(expandInputs(options, inputs, recursive), options.jobs);
+
+    std::ostringstream out;
+    out << "{\"command\": \"validate\", \"ok\": " << (report.invalidCount == 0 ? "true" : "false")
+        << ", \"summary\": {\"files\": " << report.results.size() << ", \"valid\": " << report.validCount
+        << ", \"warnings\": " << report.warningCount << ", \"invalid\": " << report.invalidCount
+        << ", \"threads\": " << report.threadCount << ", \"elapsed_s\": " << report.elapsedSeconds << "},\n \"files\": [";
+    for (std::size_t i = 0; i < report.results.size(); ++i) {
+        const fs::path& path = report.results[i].first;
+        const ValidationResult& result = report.results[i].second;
+        const char* status = !result.isValid() ? "invalid" : (result.hasWarnings() ? "warning" : "valid");
+        out << (i > 0 ? ",\n  " : "\n  ") << "{\"path\": " << jsonPath(path) << ", \"status\": \"" << status << "\"";
+        if (!result.isValid()) {
+            out << ", \"error\": " << JsonText::quoted(result.wellFormedError);
+        } else {
+            out << ", \"structure\": " << JsonText::quoted(result.structureInfo)
+                << ", \"value_errors\": " << jsonStringArray(result.valueErrors);
+        }
+        out << "}";
+    }
+    out << "\n]}\n";
+    std::cout << out.str();
+    return report.invalidCount == 0 ? 0 : 1;
+}
+
+int runBackup(const Options& options) {
+    bool list = false;
+    bool prune = true;
+    for (const std::string& arg : options.args) {
+        if (arg == "--list") list = true;
+        else if (arg == "--no-prune") prune = false;
+        else throw UsageError("backup: невідомий аргумент '" + arg + "'");
+    }
+
+    BackupManager backupManager;
+    if (list) {
+        const std::vector<BackupEntry> entries = backupManager.listBackups();
+        std::string out = "{\"command\": \"backup\", \"ok\": true, \"backups\": [";
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            out += (i > 0 ? ",\n  " : "\n  ") + jsonBackupEntry(entries[i]);
+        }
+        out += "\n]}\n";
+        std::cout << out;
+        return 0;
+    }
+
+    ChangeTracker logger;
+    const BackupEntry entry = backupManager.createBackup();
+    logger.logAction("BackupManager::createBackup", true, entry.name + " (" + entry.hash.substr(0, 12) + ")");
+    std::ostringstream out;
+    out << "{\"command\": \"backup\", \"ok\": true, \"backup\": " << jsonBackupEntry(entry);
+    if (prune) {
+        std::string warning;
+        out << ", \"prune\": " << jsonPruneBackups(backupManager, logger, warning);
+        if (!warning.empty()) out << ", \"warning\": " << JsonText::quoted(warning);
+    }
+    out << "}\n";
+    std::cout << out.str();
+    return 0;
+}
+
+int runApply(const Options& options) {
+    bool acceptWarnings = false;
+    bool backup = true;
+    bool merge = false;
+    ConfigMerge::ConflictPolicy policy = ConfigMerge::ConflictPolicy::THEIRS;
+    std::vector<std::string> inputs;
+    for (const std::string& arg : options.args) {
+        if (arg == "--accept-warnings") acceptWarnings = true;
+        else if (arg == "--no-backup") backup = false;
+        else if (arg == "--merge") merge = true;
+        else if (arg == "--prefer-game") policy = ConfigMerge::ConflictPolicy::OURS;
+        else inputs.push_back(arg);
+    }
+    if (policy == ConfigMerge::ConflictPolicy::OURS && !merge) throw UsageError("apply: --prefer-game працює лише з --merge");
+    if (inputs.size() != 1) throw UsageError("apply: потрібен рівно один файл конфігу");
+    const fs::path source = inputPath(options, inputs.front());
+
+    // Перевірка джерела й атомарна заміна — як у GUI. На відміну від GUI, CLI спершу копіює поточний файл гри
+    // у сховище резервних копій і чистить старі копії (вимикається --no-backup)
+    FileValidator validator;
+    ChangeTracker logger;
+    const ValidationResult validation = validator.validateFile(source);
+    std::string rejection;
+    if (!validation.isValid()) {
+        rejection = validation.wellFormedError;
+    } else if (validation.hasWarnings() && !acceptWarnings) {
+        rejection = "Файл має попередження валідації (--accept-warnings, щоб застосувати): " + validation.structureInfo;
+        for (const std::string& error : validation.valueErrors) rejection += "; " + error;
+    }
+    if (!rejection.empty()) {
+        logger.logAction("ConfigManager::changeCurrentConfig", false, "Validation failed: " + source.string());
+        std::cout << "{\"command\": \"apply\", \"ok\": false, \"source\": " << jsonPath(source)
+                  << ", \"error\": " << JsonText::quoted(rejection) << "}\n";
+        return 1;
+    }
+
+    ConfigManager configManager;
+    const fs::path target = configManager.getCurrentGameConfigPath();
+    std::string backupJson = "null";
+    std::string pruneJson = "null";
+    std::string warning;
+    if (backup && fs::exists(target)) {
+        BackupManager backupManager;
+        const BackupEntry entry = backupManager.createBackup();
+        logger.logAction("BackupManager::createBackup", true, entry.name + " (" + entry.hash.substr(0, 12) + ")");
+        backupJson = jsonBackupEntry(entry);
+        pruneJson = jsonPruneBackups(backupManager, logger, warning);
+    }
+
+    std::string mergeJson = "null";
+    if (merge && fs::exists(target)) {
+        const ConfigMergeResult result = configManager.mergeIntoCurrentConfig(source, policy);
+        logger.logChanges("ConfigManager::mergeIntoCurrentConfig", target, result.applied);
+        mergeJson = std::string("{\"had_base\": ") + (result.hadBase ? "true" : "false") +
+                    ", \"managed_keys\": " + std::to_string(result.managedKeys) +
+                    ", \"applied\": " + jsonChanges(result.applied) + ", \"kept\": " + jsonChanges(result.kept) +
+                    ", \"conflicts\": " + jsonChanges(result.conflicts) + ", \"missing_keys\": " + jsonStringArray(result.missingKeys) + "}";
+    } else {
+        configManager.changeCurrentConfig(source);
+    }
+    logger.logAction(merge ? "ConfigManager::mergeIntoCurrentConfig" : "ConfigManager::changeCurrentConfig", true, source.string());
+    std::cout << "{\"command\": \"apply\", \"ok\": true, \"source\": " << jsonPath(source) << ", \"target\": " << jsonPath(target)
+              << ", \"backup\": " << backupJson << ", \"prune\": " << pruneJson << ", \"merge\": " << mergeJson;
+    if (!warning.empty()) std::cout << ", \"warning\": " << JsonText::quoted(warning);
+    std::cout << "}\n";
+    return 0;
+}
+
+int runDiff(const Options& options) {
+    bool settingsOnly = false;
+    std::vector<std::string> inputs;
+    for (const std::string& arg : options.args) {
+        if (arg == "--settings-only") settingsOnly = true;
+        else inputs.push_back(arg);
+    }
+    if (inputs.size() != 2) throw UsageError("diff: потрібно два файли");
+    const fs::path first = inputPath(options, inputs[0]);
+    const fs::path second = inputPath(options, inputs[1]);
+
+    const ConfigDiffResult diff = ConfigDiff::compareFiles(first, second);
+
+    std::ostringstream out;
+    out << "{\"command\": \"diff\", \"ok\": true, \"identical\": " << (diff.identical() ? "true" : "false")
+        << ", \"a\": " << jsonPath(first) << ", \"b\": " << jsonPath(second)
+        << ", \"summary\": {\"added\": " << diff.addedCount << ", \"removed\": " << diff.removedCount
+        << ", \"changed\": " << diff.changedCount << ", \"compared_elements\": " << diff.comparedElements << "},\n \"differences\": [";
+    bool firstEntry = true;
+    for (const ConfigDifference& difference : diff.differences) {
+        if (settingsOnly && difference.key.empty()) continue;
+        const char* kind = difference.kind == ConfigDifference::Kind::ADDED ? "added"
+                           : difference.kind == ConfigDifference::Kind::REMOVED ? "removed" : "changed";
+        out << (firstEntry ? "\n  " : ",\n  ") << "{\"kind\": \"" << kind << "\", \"path\": " << JsonText::quoted(difference.path);
+        if (!difference.key.empty()) out << ", \"key\": " << JsonText::quoted(difference.key);
+        if (difference.kind != ConfigDifference::Kind::ADDED) out << ", \"old\": " << JsonText::quoted(difference.oldValue);
+        if (difference.kind != ConfigDifference::Kind::REMOVED) out << ", \"new\": " << JsonText::quoted(difference.newValue);
+        out << "}";
+        firstEntry = false;
+    }
+    out << "\n]}\n";
+    std::cout << out.str();
+    return 0;
+}
+
+int runSet(const Options& options) {
+    auto separator = std::find(options.args.begin(), options.args.end(), "--");
+    if (separator == options.args.end()) throw UsageError("set: очікується 'ключ=значення ... -- файли'");
+    const std::vector<std::string> inputs(separator + 1, options.args.end());
+    if (inputs.empty()) throw UsageError("set: не вказано жодного файлу або директорії");
+
+    PatchOptions patchOptions;
+    patchOptions.threadCount = options.jobs;
+    std::vector<SettingAssignment> assignments;
+    for (auto it = options.args.begin(); it != separator; ++it) {
+        if (*it == "--dry-run") patchOptions.dryRun = true;
+        else if (*it == "--strict") patchOptions.rejectInvalid = true;
+        else {
+            try {
+                assignments.push_back(SettingPatch::parseAssignment(*it));
+            } catch (const std::runtime_error& e) {
+                throw UsageError(std::string("set: ") + e.what());
+            }
+        }
+    }
+    if (assignments.empty()) throw UsageError("set: не вказано жодного присвоєння");
+
+    // Присвоєння перевіряються за схемою один раз, до відкриття файлів
+    std::unique_ptr<SettingPatch> patch;
+    try {
+        patch = std::make_unique<SettingPatch>(SettingPatch::compile(assignments));
+    } catch (const std::runtime_error& e) {
+        throw UsageError(std::string("set: ") + e.what());
+    }
+
+    const PatchReport report = patch->applyAll(expandInputs(options, inputs, true), patchOptions);
+
+    ChangeTracker logger;
+    std::ostringstream out;
+    out << "{\"command\": \"set\", \"dry_run\": " << (patchOptions.dryRun ? "true" : "false") << ", \"files\": [";
+    for (std::size_t i = 0; i < report.results.size(); ++i) {
+        const PatchFileResult& result = report.results[i];
+        out << (i > 0 ? ",\n  " : "\n  ") << "{\"path\": " << jsonPath(result.path) << ", \"ok\": " << (result.ok ? "true" : "false");
+        if (!result.ok) {
+            out << ", \"error\": " << JsonText::quoted(result.error);
+            if (!patchOptions.dryRun) logger.logAction("SettingPatch::apply", false, result.path.string() + ": " + result.error);
+        } else if (result.written) {
+            logger.logChanges("SettingPatch::apply", result.path, result.applied);
+        }
+        out << ", \"written\": " << (result.written ? "true" : "false") << ", \"changes\": " << jsonChanges(result.applied)
+            << ", \"missing_keys\": " << jsonStringArray(result.missingKeys)
+            << ", \"value_errors\": " << jsonStringArray(result.valueErrors) << "}";
+    }
+    out << "\n], \"ok\": " << (report.failedCount == 0 ? "true" : "false") << ", \"summary\": {\"files\": " << report.results.size()
+        << ", \"modified\": " << report.modifiedCount << ", \"unchanged\": " << report.unchangedCount
+        << ", \"failed\": " << report.failedCount << ", \"threads\": " << report.threadCount
+        << ", \"elapsed_s\": " << report.elapsedSeconds << "}}\n";
+    std::cout << out.str();
+    return report.failedCount == 0 ? 0 : 1;
+}
+
+void printUsage(std::ostream& out) {
+    out << "Usage: WOTSettingsCli [--workdir DIR] [--jobs N] <command> ...\n"
+           "  validate [--no-recursive] <input>...\n"
+           "  backup [--list] [--no-prune]\n"
+           "  apply [--accept-warnings] [--no-backup] [--merge [--prefer-game]] <config.xml>\n"
+           "  diff [--settings-only] <a.xml> <b.xml>\n"
+           "  set [--dry-run] [--strict] <key=value>... -- <input>...\n"
+           "Input: file, directory (*.xml, recursive) or a file-name pattern with * and ?.\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    std::string command;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (!command.empty()) {
+                options.args.push_back(arg);
+            } else if (arg == "--workdir" && i + 1 < argc) {
+                // Папка програми: "User Data" (лог) і "Restored Configs" (сховище копій) - відносно неї
+                if (options.baseDir.empty()) options.baseDir = fs::current_path();
+                fs::current_path(argv[++i]);
+            } else if (arg == "--jobs" && i + 1 < argc) {
+                options.jobs = static_cast<unsigned>(std::max(0, std::atoi(argv[++i])));
+            } else if (arg == "--help" || arg == "-h") {
+                printUsage(std::cout);
+                return 0;
+            } else if (!arg.empty() && arg[0] == '-') {
+                throw UsageError("невідомий параметр '" + arg + "'");
+            } else {
+                command = arg;
+            }
+        }
+        if (command.empty()) throw UsageError("не вказано команду");
+
+        // Без інтерактивних підтверджень: попередження приймаються лише там, де це явно дозволено
+        FileValidator::setDefaultPrompt(std::make_shared<HeadlessValidationPrompt>(true, true));
+
+        int exitCode = 2;
+        if (command == "validate") exitCode = runValidate(options);
+        else if (command == "backup") exitCode = runBackup(options);
+        else if (command == "apply") exitCode = runApply(options);
+        else if (command == "diff") exitCode = runDiff(options);
+        else if (command == "set") exitCode = runSet(options);
+        else throw UsageError("невідома команда '" + command + "'");
+        ChangeTracker::flush();
+        return exitCode;
+    } catch (const UsageError& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        printUsage(std::cerr);
+        return 2;
+    } catch (const std::exception& e) {
+        ChangeTracker::flush();
+        std::cout << "{\"command\": " << JsonText::quoted(command) << ", \"ok\": false, \"error\": " << JsonText::quoted(e.what()) << "}\n";
+        return 1;
+    }
+}
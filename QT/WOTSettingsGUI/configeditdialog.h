@@ -5,46 +5,50 @@
 #include <map>
 #include <string>
 #include <filesystem>
-#include "main.h" // Для FilteredSettingsMap та SettingRule
+#include "main.h" // Для FilteredSettingsMap
 // #include "settingdelegate.h" // Не включаємо тут, щоб уникнути циклічної залежності, використаємо попереднє оголошення
 
 namespace fs = std::filesystem;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class ConfigEditDialog; }
-class QTreeWidgetItem;
 class SettingDelegate; // <-- Попереднє оголошення делегата
+class SettingsTreeModel;
 class QBrush;          // <-- Попереднє оголошення QBrush
 QT_END_NAMESPACE
 
-using SettingRulesMap = std::map<std::string, SettingRule>;
-
 class ConfigEditDialog : public QDialog
 {
     Q_OBJECT
 
 public:
+    // Результат exec(): користувач перейшов до розширеного режиму (весь XML, XmlTreeDialog)
+    enum { AdvancedModeRequested = 2 };
+
     explicit ConfigEditDialog(const FilteredSettingsMap& currentSettings,
                               const fs::path& filePath,
                               QWidget *parent = nullptr);
     ~ConfigEditDialog();
 
     FilteredSettingsMap getUpdatedSettings() const;
+    // Лише змінені користувачем значення (старе -> нове), у порядку дерева
+    SettingChangeSet getChangedSettings() const;
 
 private slots:
     void onSaveClicked();
+    void onAdvancedClicked();
 
 private:
     Ui::ConfigEditDialog *ui;
     fs::path m_filePath;
+    const FilteredSettingsMap m_originalSettings; // Значення на момент відкриття діалогу
     FilteredSettingsMap m_currentSettings; // Оновлюється при збереженні
-    SettingRulesMap m_rules;           // Мапа з правилами валідації
     SettingDelegate *m_settingDelegate; // Вказівник на делегат
+    SettingsTreeModel *m_model; // Налаштування діалогу (значення редагуються в ній)
 
     // Допоміжні функції
-    void initializeValidationRules(); // Ініціалізує мапу m_rules
     void populateTree();
-    bool collectSettingsFromTree(); // Збирає дані з дерева БЕЗ валідації
+    bool collectSettingsFromTree(); // Збирає дані з моделі БЕЗ валідації
     bool finalValidationCheck();    // <-- Фінальна перевірка перед збереженням
 };
 
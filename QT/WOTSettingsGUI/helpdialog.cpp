@@ -58,8 +58,8 @@ void HelpDialog::populateHelpText()
         <h2>Як користуватися програмою:</h2>
         <ul>
             <li><b>Перевірити папки:</b> Натисніть цю кнопку при першому запуску, щоб створити необхідні директорії.</li>
-            <li><b>Створити резервну копію:</b> Зберігає поточний файл налаштувань гри (`preferences.xml`) у папку `Restored Configs` з датою та часом у назві. Рекомендується робити перед будь-якими змінами.</li>
-            <li><b>Відновити з копії:</b> Дозволяє вибрати раніше створену резервну копію з папки `Restored Configs` і замінити нею поточний файл налаштувань гри.</li>
+            <li><b>Створити резервну копію:</b> Зберігає поточний файл налаштувань гри (`preferences.xml`) у сховище в папці `Restored Configs` з датою та часом створення. Однаковий вміст зберігається лише один раз. Рекомендується робити перед будь-якими змінами.</li>
+            <li><b>Відновити з копії:</b> Дозволяє вибрати раніше створену резервну копію зі списку (або окремий XML-файл) і замінити нею поточний файл налаштувань гри.</li>
             <li><b>Встановити нікнейм:</b> Зберігає ваш ігровий нікнейм (використовується для ідентифікації, але не впливає на гру).</li>
             <li><b>Показати нікнейм:</b> Відображає збережений нікнейм.</li>
             <li><b>Показати конфіг користувача:</b> Дозволяє вибрати конфігураційний файл `.xml` з папки `User Configs` (або з будь-якої іншої директорії) та переглянути його відфільтровані налаштування (тільки для читання).</li>
@@ -1,13 +1,29 @@
 #include "mainwindow.h"
 #include <QApplication>
 #include <QStyleFactory>
+#include <cstdlib> // Для std::getenv
+#include <cstring> // Для std::strcmp
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
     QApplication::setStyle(QStyleFactory::create("Fusion"));
+    // WOT_TRACE=1 вмикає трасування основних операцій (запис у User Data/trace.json при виході)
+    const char* traceEnv = std::getenv("WOT_TRACE");
+    const bool tracing = traceEnv && std::strcmp(traceEnv, "1") == 0;
+    Trace::setEnabled(tracing);
+    // Валідація перед діями в GUI питає користувача через QMessageBox
+    FileValidator::setDefaultPrompt(std::make_shared<MessageBoxValidationPrompt>());
     MainWindow w;
     w.setWindowTitle("WOT Configurator");
     w.show();
-    return a.exec();
+    const int exitCode = a.exec();
+    if (tracing) {
+        try {
+            Trace::exportChromeTrace(fs::path("User Data") / "trace.json");
+        } catch (const std::runtime_error&) {
+            // Траса - лише діагностика: помилка запису не впливає на вихід з програми
+        }
+    }
+    return exitCode;
 }
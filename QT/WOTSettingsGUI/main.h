@@ -8,6 +8,16 @@
 #include <map>        // Для std::map
 #include <utility>    // Для std::pair, std::move
 #include <limits>     // Для std::numeric_limits
+#include <memory>     // Для std::shared_ptr
+#include <mutex>      // Для std::mutex (DocumentCache)
+#include <cstdint>    // Для std::uint64_t, std::uintmax_t
+#include <functional> // Для std::function (WorkerPool)
+#include <string_view> // Для пошуку в таблиці правил без алокацій
+#include <unordered_map> // Для SettingNodeIndex
+#include <cstdio>     // Для std::FILE (AtomicFile)
+#include <atomic>     // Для Trace
+#include <chrono>     // Для ConfigWatcher (інтервал дебаунсу)
+#include <cctype>     // Для std::isspace (XmlUtil)
 
 // Використовуємо простір імен filesystem
 namespace fs = std::filesystem;
@@ -60,31 +70,326 @@ struct SettingRule {
 };
 // --- Кінець визначення SettingRule ---
 
+// --- Схема налаштувань preferences.xml ---
+// Секції, до яких прив'язані налаштування. Для GRAPHICS_ENTRY ключем є <label> запису <entry>,
+// для CONTROL_CAMERA - "режим/налаштування" (controlMode/<режим>/camera/<налаштування>).
+enum class ConfigSection {
+    SOUND_PREFS,          // scriptsPreferences/soundPrefs
+    SCRIPTS_PREFERENCES,  // scriptsPreferences (прямі теги, напр. fov)
+    CONTROL_CAMERA,       // scriptsPreferences/controlMode/*/camera
+    GRAPHICS_PREFERENCES, // graphicsPreferences (прямі теги)
+    GRAPHICS_ENTRY,       // graphicsPreferences/entry (за <label>)
+    DEVICE_PREFERENCES    // devicePreferences
+};
+
+struct SettingSpec {
+    enum : unsigned { EDITOR = 1u }; // Налаштування показується у відфільтрованому виді/редакторі
+
+    ConfigSection section;
+    const char* tag;
+    SettingType type;
+    double minValue;
+    double maxValue;
+    int decimals;
+    const char* displayName; // Назва для UI (UTF-8), nullptr - показується сам ключ
+    unsigned flags;
+};
+
+// Єдиний незмінний реєстр налаштувань процесу: типи, діапазони, назви для UI та фільтри
+// відфільтрованого виду. Таблиця статична й відсортована за (section, tag); ключі - string_view
+// на літерали таблиці, тож запити не створюють рядків. Користуються нею FileValidator,
+// ConfigEditor, ConfigEditDialog, SettingDelegate та MainWindow.
+class SettingSchema {
+public:
+    // Налаштування однієї секції як діапазон [first, second)
+    static std::pair<const SettingSpec*, const SettingSpec*> sectionSpecs(ConfigSection section);
+    static const SettingSpec* find(ConfigSection section, std::string_view tag);
+    // Пошук ключа CONTROL_CAMERA без складання рядка "режим/налаштування"
+    static const SettingSpec* findControl(std::string_view mode, std::string_view setting);
+    // O(1) пошук за ключем FilteredSettingsMap ("masterVolume", "arcadeMode/sensitivity", "SHADOWS_QUALITY")
+    static const SettingSpec* findKey(std::string_view key);
+    // Правило редактора для ключа (nullptr - ключ невідомий). Об'єкти SettingRule створюються один раз на процес.
+    static const SettingRule* rule(std::string_view key);
+    static const char* displayName(std::string_view key);
+
+    // Фільтри відфільтрованого виду (getFilteredSettings)
+    static bool isEditorSetting(ConfigSection section, std::string_view tag);
+    static bool isEditorControlSetting(std::string_view setting); // Для будь-якого режиму controlMode
+    // Назва категорії у FilteredSettingsMap ("Sound Settings", ...); nullptr для секцій без категорії
+    static const char* categoryName(ConfigSection section);
+
+    // Перевіряє текст значення; при помилці записує опис у error (з префіксом "<key>: '...'")
+    static bool checkValue(const SettingSpec& spec, std::string_view key, const char* text, std::string& error);
+};
+
 // Тип для передачі даних між діалогом та ConfigEditor
 using FilteredSettingsMap = std::map<std::string, std::vector<std::pair<std::string, std::string>>>;
 
+// Одна зміна налаштування (категорія і ключ - як у FilteredSettingsMap)
+struct SettingChange {
+    std::string category;
+    std::string key;
+    std::string oldValue;
+    std::string newValue;
+};
+using SettingChangeSet = std::vector<SettingChange>;
+
 
 // --- Оголошення Класів Логіки ---
 
+namespace pugi { class xml_document; class xml_node; struct xml_node_struct; }
+
+// XmlUtil (спільні помічники: обрізка значень і обхід дочірніх елементів)
+#ifndef XMLUTIL_H
+#define XMLUTIL_H
+class XmlUtil {
+public:
+    // Значення без пробільних символів на краях (std::isspace); nullptr - порожній рядок
+    static std::string_view trimmed(std::string_view text) {
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) text.remove_prefix(1);
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) text.remove_suffix(1);
+        return text;
+    }
+    static std::string_view trimmed(const char* text) { return trimmed(std::string_view(text ? text : "")); }
+    // Дочірні елементи без коментарів, тексту та інструкцій обробки; порожній вузол - елементів більше немає
+    static pugi::xml_node firstElement(const pugi::xml_node& parent);
+    static pugi::xml_node nextElement(const pugi::xml_node& node);
+};
+#endif // XMLUTIL_H
+
+// SettingNodeIndex (індекс вузлів налаштувань розібраного документа)
+#ifndef SETTINGNODEINDEX_H
+#define SETTINGNODEINDEX_H
+// Ключ FilteredSettingsMap -> вузол, текст якого містить значення: прямі теги секцій, "режим/налаштування"
+// для controlMode/*/camera і <label> записів <entry> (вузол <activeOption>). Будується один раз при
+// завантаженні документа; вузли лишаються дійсними, поки живе документ і змінюються лише значення.
+class SettingNodeIndex {
+public:
+    using NodeMap = std::unordered_map<std::string, pugi::xml_node_struct*>;
+
+    static std::shared_ptr<const SettingNodeIndex> build(const pugi::xml_document& doc);
+    // Порожній вузол, якщо ключа немає. GRAPHICS_ENTRY і GRAPHICS_PREFERENCES - один простір ключів.
+    pugi::xml_node find(ConfigSection section, const std::string& key) const;
+    bool hasSection(ConfigSection section) const;
+    std::size_t size() const;
+private:
+    const NodeMap* sectionMap(ConfigSection section) const;
+    NodeMap m_sound;
+    NodeMap m_control;
+    NodeMap m_graphics; // Прямі теги і потім <entry> за <label>
+    NodeMap m_device;
+};
+#endif // SETTINGNODEINDEX_H
+
+// DocumentCache (спільний кеш розібраних preferences.xml)
+#ifndef DOCUMENTCACHE_H
+#define DOCUMENTCACHE_H
+// Результат розбору однієї версії файлу (версія = шлях + час зміни + розмір)
+struct ParsedDocument {
+    std::shared_ptr<pugi::xml_document> doc; // Розібраний документ (порожній, якщо розбір не вдався)
+    std::shared_ptr<const SettingNodeIndex> index; // Лише для документів з DocumentCache::load
+    bool ok = false;
+    std::string errorDescription = "";
+    std::ptrdiff_t errorOffset = 0;
+    fs::file_time_type writeTime{};
+    std::uintmax_t fileSize = 0;
+};
+class DocumentCache {
+public:
+    static DocumentCache& instance();
+    // Розбирає файл без участі кешу (для пакетної обробки, щоб не витісняти робочі документи GUI)
+    static std::shared_ptr<const ParsedDocument> parseFile(const fs::path& filePath);
+    // Повертає розібраний документ; файл розбирається лише якщо його версія змінилась.
+    // Документ спільний для всіх власників і не змінюється: для змін - copyDocument.
+    std::shared_ptr<const ParsedDocument> load(const fs::path& filePath);
+    // Приватна копія документа (копіювання замість повторного розбору файлу)
+    static std::shared_ptr<pugi::xml_document> copyDocument(const ParsedDocument& parsed);
+    // Після запису зміненої копії на диск прив'язує її до нової версії файлу (без повторного розбору).
+    // Індекс вузлів має бути побудований для цієї копії; без нього будується заново.
+    void store(const fs::path& filePath, std::shared_ptr<pugi::xml_document> doc,
+               std::shared_ptr<const SettingNodeIndex> index = nullptr);
+    void invalidate(const fs::path& filePath);
+    void clear();
+    void setCapacity(std::size_t capacity);
+private:
+    DocumentCache() = default;
+    static std::shared_ptr<const ParsedDocument> parseDocument(const fs::path& filePath, bool buildIndex);
+    struct Slot { std::shared_ptr<const ParsedDocument> entry; std::uint64_t lastUse = 0; };
+    void insertLocked(const fs::path& key, std::shared_ptr<const ParsedDocument> entry);
+    std::mutex m_mutex;
+    std::map<fs::path, Slot> m_slots;
+    std::uint64_t m_useCounter = 0;
+    std::size_t m_capacity = 8;
+};
+#endif // DOCUMENTCACHE_H
+
+// WorkerPool (паралельне виконання незалежних завдань на всіх ядрах)
+#ifndef WORKERPOOL_H
+#define WORKERPOOL_H
+class WorkerPool {
+public:
+    // Кількість апаратних потоків (щонайменше 1)
+    static unsigned defaultThreadCount();
+    // Викликає task(i) для кожного i з [0, count); threadCount == 0 - використати всі ядра.
+    // Перший виняток із завдань перекидається після завершення всіх потоків.
+    static void forEach(std::size_t count, unsigned threadCount, const std::function<void(std::size_t)>& task);
+};
+#endif // WORKERPOOL_H
+
+// JsonText (екранування рядків для JSON-виводу: лог, траса, консольний інструмент, бенчмарк)
+#ifndef JSONTEXT_H
+#define JSONTEXT_H
+class JsonText {
+public:
+    // Рядок у лапках; керівні символи - \n, \r, \t або \u00XX, UTF-8 лишається як є
+    static void appendQuoted(std::string& out, std::string_view value);
+    static std::string quoted(std::string_view value);
+};
+#endif // JSONTEXT_H
+
+// Trace (вимірювання часу операцій бекенду)
+#ifndef TRACE_H
+#define TRACE_H
+// Проміжки часу TraceScope пишуться в кільцевий буфер (найстаріші витісняються) і експортуються
+// у формат Chrome trace-event (chrome://tracing, Perfetto). За замовчуванням вимкнено: тоді
+// TraceScope - одне атомарне читання, без годинника і блокувань. У програмі вмикається
+// змінною середовища WOT_TRACE=1; при виході трасу записано в "User Data/trace.json".
+class Trace {
+public:
+    static constexpr std::size_t kDefaultCapacity = 65536;
+    static bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+    static void setEnabled(bool enabled);
+    static void setCapacity(std::size_t capacity); // Очищає буфер
+    static std::int64_t nowNs();
+    // name має жити до експорту (рядковий літерал)
+    static void record(const char* name, std::int64_t startNs, std::int64_t endNs);
+    static void clear();
+    static std::size_t spanCount();
+    static std::uint64_t droppedCount(); // Витіснені з буфера
+    static std::string exportChromeJson();
+    static void exportChromeTrace(const fs::path& target);
+private:
+    static inline std::atomic<bool> s_enabled{false};
+};
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : m_name(name), m_startNs(Trace::enabled() ? Trace::nowNs() : -1) {}
+    ~TraceScope() {
+        if (m_startNs >= 0) Trace::record(m_name, m_startNs, Trace::nowNs());
+    }
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+private:
+    const char* m_name;
+    std::int64_t m_startNs; // -1 - трасування було вимкнене на вході
+};
+#endif // TRACE_H
+
+// AtomicFile (безпечний запис файлів конфігурації)
+#ifndef ATOMICFILE_H
+#define ATOMICFILE_H
+// Вміст пишеться у тимчасовий файл поруч із цільовим, скидається на диск (fsync) і перейменовується
+// поверх цільового. Збій чи заповнений диск посеред запису лишають попередню версію файлу цілою.
+// Помилки - std::runtime_error; тимчасовий файл при цьому видаляється.
+class AtomicFile {
+public:
+    // writeContent повертає false, якщо запис не вдався
+    static void write(const fs::path& target, const std::function<bool(std::FILE*)>& writeContent);
+    static void writeBuffer(const fs::path& target, const char* data, std::size_t size);
+    // XML-документ з тими самими параметрами, що й у xml_document::save_file
+    static void saveDocument(const fs::path& target, const pugi::xml_document& doc);
+    static void copy(const fs::path& source, const fs::path& target);
+};
+#endif // ATOMICFILE_H
+
+// FileLock (міжпроцесне блокування сховищ на диску)
+#ifndef FILELOCK_H
+#define FILELOCK_H
+// Рекомендаційний замок на окремому файлі (flock / LockFileEx), діє і між екземплярами в одному процесі.
+// Спільний - для читання, виключний - для змін. Утримується до знищення об'єкта; файл-замок не видаляється.
+// Якщо директорії ще немає, замок порожній: захищати нічого. Інші помилки - std::runtime_error.
+class FileLock {
+public:
+    enum class Mode { Shared, Exclusive };
+    FileLock(const fs::path& lockPath, Mode mode);
+    ~FileLock();
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+private:
+#ifdef _WIN32
+    void* m_handle = nullptr;
+#else
+    int m_fd = -1;
+#endif
+};
+#endif // FILELOCK_H
+
 // FileValidator (з ValidationResult)
 #ifndef FILEVALIDATOR_H
 #define FILEVALIDATOR_H
-namespace pugi { class xml_document; }
 struct ValidationResult {
     bool isWellFormed = false; std::string wellFormedError = "";
     bool hasStructure = false; std::string structureInfo = "";
     std::vector<std::string> valueErrors;
     bool isValid() const { return isWellFormed; } // Основна перевірка - чи валідний XML
+    bool hasWarnings() const { return isWellFormed && (!hasStructure || !valueErrors.empty()); }
+};
+// Зведений звіт пакетної валідації (без жодних викликів UI)
+struct BatchValidationReport {
+    std::vector<std::pair<fs::path, ValidationResult>> results; // У порядку вхідного списку файлів
+    std::size_t validCount = 0;   // Коректний XML без попереджень
+    std::size_t warningCount = 0; // Коректний XML з попередженнями структури/значень
+    std::size_t invalidCount = 0; // Некоректний XML або файл недоступний
+    unsigned threadCount = 0;
+    double elapsedSeconds = 0.0;
+};
+// Інтерактивне підтвердження для validateBeforeAction. Бекенд не знає про UI:
+// GUI встановлює реалізацію з QMessageBox, пакетні інструменти - HeadlessValidationPrompt
+class ValidationPrompt {
+public:
+    virtual ~ValidationPrompt() = default;
+    // Файл коректний, але має попередження: true - продовжити дію
+    virtual bool confirmWarnings(const fs::path& filePath, const std::string& actionName, const std::string& summary) = 0;
+    virtual void reportSuccess(const fs::path& /*filePath*/, const std::string& /*actionName*/) {}
+    virtual void reportFailure(const fs::path& /*filePath*/, const std::string& /*actionName*/, const std::string& /*error*/) {}
+};
+// Без взаємодії з користувачем: попередження приймаються (або ні) за політикою, повідомлення - у std::cerr
+class HeadlessValidationPrompt : public ValidationPrompt {
+public:
+    explicit HeadlessValidationPrompt(bool acceptWarnings = true, bool verbose = false)
+        : m_acceptWarnings(acceptWarnings), m_verbose(verbose) {}
+    bool confirmWarnings(const fs::path& filePath, const std::string& actionName, const std::string& summary) override;
+    void reportFailure(const fs::path& filePath, const std::string& actionName, const std::string& error) override;
+private:
+    bool m_acceptWarnings;
+    bool m_verbose;
 };
 class FileValidator {
 public:
     ValidationResult validateFile(const fs::path& filePath);
-    // Метод для інтерактивної перевірки перед дією (показує QMessageBox)
+    // Пакетна валідація списку файлів у пулі потоків (threadCount == 0 - усі ядра)
+    BatchValidationReport validateFiles(const std::vector<fs::path>& filePaths, unsigned threadCount = 0);
+    // Пакетна валідація всіх *.xml у директорії
+    BatchValidationReport validateDirectory(const fs::path& directory, bool recursive = true, unsigned threadCount = 0);
+    static std::vector<fs::path> collectXmlFiles(const fs::path& directory, bool recursive = true);
+    // Перевірка значень уже розібраного документа за SettingSchema (те саме, що valueErrors у validateFile)
+    std::vector<std::string> checkValues(const pugi::xml_document& doc);
+    // Перевірка перед дією з підтвердженням через ValidationPrompt
     bool validateBeforeAction(const fs::path& filePath, const std::string& actionNameStd, bool showSuccess = false);
+    // Те саме для результату validateFile, отриманого раніше (напр. у фоновому потоці); лише підтвердження
+    bool confirmBeforeAction(const fs::path& filePath, const ValidationResult& result, const std::string& actionNameStd,
+                             bool showSuccess = false);
+    // Підтвердження для цього екземпляра (nullptr - використовувати спільне за замовчуванням)
+    void setPrompt(std::shared_ptr<ValidationPrompt> prompt) { m_prompt = std::move(prompt); }
+    // Спільне для всіх валідаторів (GUI встановлює при старті); без нього діє HeadlessValidationPrompt
+    static void setDefaultPrompt(std::shared_ptr<ValidationPrompt> prompt);
+    static std::shared_ptr<ValidationPrompt> defaultPrompt();
 private:
-    bool isXmlWellFormedInternal(const fs::path& filePath, pugi::xml_document& doc, std::string& errorMsg);
+    ValidationResult validateFileInternal(const fs::path& filePath, bool useCache);
+    bool isXmlWellFormedInternal(const ParsedDocument& parsed, std::string& errorMsg);
     bool hasExpectedStructureInternal(const pugi::xml_document& doc, std::string& warnings);
     std::vector<std::string> findInvalidSimpleValuesInternal(const pugi::xml_document& doc);
+    std::shared_ptr<ValidationPrompt> m_prompt;
 };
 #endif // FILEVALIDATOR_H
 
@@ -97,26 +402,459 @@ public:
     std::string readConfigContent(const fs::path& configPath);
     // Отримує відфільтровані налаштування для показу/редагування
     FilteredSettingsMap getFilteredSettings(const fs::path& configPath);
-    // Зберігає змінені (відфільтровані) налаштування назад у файл
-    void saveFilteredSettings(const fs::path& configPath, const FilteredSettingsMap& settings);
+    // Те саме без побудови DOM: файл читається блоками через FilteredSettingsReader (пам'ять не залежить
+    // від розміру файлу). Документ не потрапляє в DocumentCache - для файлів, які далі не редагуються.
+    FilteredSettingsMap getFilteredSettingsStreaming(const fs::path& configPath);
+    // Потоковий розбір XML, що вже є в пам'яті (напр. вбудований preferences_xml)
+    static FilteredSettingsMap extractFilteredSettings(const char* data, std::size_t size);
+    // Зберігає відфільтровані налаштування назад у файл; записуються лише значення, що відрізняються
+    // від документа. Повертає фактично застосовані зміни (порожньо - файл не перезаписувався).
+    SettingChangeSet saveFilteredSettings(const fs::path& configPath, const FilteredSettingsMap& settings);
+    // Застосовує лише передані зміни; oldValue у результаті - значення з документа до зміни
+    SettingChangeSet saveSettingChanges(const fs::path& configPath, const SettingChangeSet& changes);
+    // Зміни між двома станами відфільтрованих налаштувань (ключі, яких немає в after, ігноруються)
+    static SettingChangeSet diffSettings(const FilteredSettingsMap& before, const FilteredSettingsMap& after);
+
+    // Розширений режим (будь-який елемент документа). Правило SettingSchema для елемента-значення
+    // (без дочірніх елементів); nullptr - правила немає. key - ключ налаштування ("fov" для scriptsPreferences).
+    static const SettingSpec* nodeSpec(const pugi::xml_node& node, std::string& key);
+    // Значення перевіряється за правилом, якщо воно є; без правила приймається будь-який текст
+    static bool checkNodeValue(const pugi::xml_node& node, const std::string& value, std::string& error);
+    // Записує значення одного елемента (шлях ConfigDiff::nodePath) у поточну версію файлу; решта документа
+    // не змінюється. expectedValue - значення, яке бачив редактор: якщо у файлі вже інше (файл змінено
+    // ззовні), нічого не записується. Помилки - std::runtime_error. category результату - "XML", key - шлях.
+    SettingChange saveNodeValue(const fs::path& configPath, const std::string& nodePath,
+                                const std::string& expectedValue, const std::string& newValue);
 };
 #endif // CONFIGEDITOR_H
 
+// SettingPatch (масове застосування присвоєнь "ключ=значення" до багатьох конфігів)
+#ifndef SETTINGPATCH_H
+#define SETTINGPATCH_H
+struct SettingAssignment {
+    std::string key;   // Ключ як у FilteredSettingsMap ("SHADOWS_QUALITY", "arcadeMode/sensitivity")
+    std::string value;
+};
+struct PatchOptions {
+    unsigned threadCount = 0;   // 0 - усі ядра
+    bool dryRun = false;        // Лише звіт: файли не записуються
+    bool rejectInvalid = false; // Не записувати файл, якщо після змін у ньому лишаються недопустимі значення
+};
+struct PatchFileResult {
+    fs::path path;
+    bool ok = false;      // Файл оброблено (записано або змін не потрібно)
+    bool written = false;
+    SettingChangeSet applied;              // Фактичні зміни (oldValue - значення з файлу)
+    std::vector<std::string> missingKeys;  // Ключі, яких немає у файлі (вузли не створюються)
+    std::vector<std::string> valueErrors;  // Недопустимі значення в документі після змін
+    std::string error;
+};
+struct PatchReport {
+    std::vector<PatchFileResult> results; // У порядку вхідного списку файлів
+    std::size_t modifiedCount = 0;
+    std::size_t unchangedCount = 0;
+    std::size_t failedCount = 0;
+    unsigned threadCount = 0;
+    double elapsedSeconds = 0.0;
+};
+// Присвоєння перевіряються за SettingSchema один раз при компіляції й перетворюються на план пошуку
+// вузлів за секціями. Кожен файл розбирається один раз (без DocumentCache), вузли знаходяться прямим
+// шляхом без побудови SettingNodeIndex, документ записується атомарно лише за наявності змін.
+class SettingPatch {
+public:
+    // Усі помилки ключів/значень повідомляються разом одним std::runtime_error
+    static SettingPatch compile(const std::vector<SettingAssignment>& assignments);
+    // Розбір "ключ=значення" (std::runtime_error, якщо немає '=' або ключ порожній)
+    static SettingAssignment parseAssignment(const std::string& text);
+
+    PatchFileResult apply(const fs::path& filePath, const PatchOptions& options = PatchOptions()) const;
+    // Файли обробляються паралельно (WorkerPool); помилка одного файлу не зупиняє інші
+    PatchReport applyAll(const std::vector<fs::path>& filePaths, const PatchOptions& options = PatchOptions()) const;
+    std::size_t size() const { return m_operations.size(); }
+private:
+    struct Operation {
+        ConfigSection section;
+        std::string key;     // Ключ FilteredSettingsMap
+        std::string mode;    // CONTROL_CAMERA: режим і налаштування окремо
+        std::string setting;
+        std::string value;
+    };
+    SettingPatch() = default;
+    std::vector<Operation> m_operations; // Впорядковано за секціями
+};
+#endif // SETTINGPATCH_H
+
+// ConfigDiff (структурне порівняння двох preferences.xml)
+#ifndef CONFIGDIFF_H
+#define CONFIGDIFF_H
+struct ConfigDifference {
+    enum class Kind { ADDED, REMOVED, CHANGED };
+    Kind kind = Kind::CHANGED;
+    // Шлях від <root>: "scriptsPreferences/soundPrefs/masterVolume", "graphicsPreferences/entry[SHADOWS_QUALITY]/activeOption";
+    // повторювані елементи з однаковим ім'ям - "name[2]" (з другого входження)
+    std::string path;
+    std::string key;      // Ключ FilteredSettingsMap, якщо шлях - відоме налаштування SettingSchema (інакше порожній)
+    std::string oldValue; // Текст елемента (обрізаний); для доданих/видалених піддерев з дочірніми елементами - порожній
+    std::string newValue;
+};
+struct ConfigDiffResult {
+    std::vector<ConfigDifference> differences; // У порядку документа
+    std::size_t addedCount = 0;
+    std::size_t removedCount = 0;
+    std::size_t changedCount = 0;
+    std::size_t comparedElements = 0;
+    bool identical() const { return differences.empty(); }
+};
+// Дочірні елементи зіставляються за ім'ям і номером входження, записи <entry> з <label> - за міткою
+// (порядок записів не важливий). Спершу діти порівнюються попарно по порядку; хеш-таблиця будується
+// лише для вузла, де порядок розійшовся, тож час лінійний від розміру документів.
+// Додане/видалене піддерево - одна відмінність (без рекурсії всередину).
+class ConfigDiff {
+public:
+    static ConfigDiffResult compare(const pugi::xml_document& before, const pugi::xml_document& after);
+    // Файли беруться з DocumentCache; помилки читання/розбору - std::runtime_error
+    static ConfigDiffResult compareFiles(const fs::path& before, const fs::path& after);
+    // Шлях елемента у форматі ConfigDifference::path і ключ FilteredSettingsMap (порожній - не відоме налаштування)
+    static std::string nodePath(const pugi::xml_node& node);
+    static std::string settingKey(const pugi::xml_node& node);
+    // Елемент за шляхом nodePath (порожній вузол, якщо такого немає); порожній шлях - <root>
+    static pugi::xml_node findNode(const pugi::xml_document& doc, std::string_view path);
+};
+#endif // CONFIGDIFF_H
+
+// ConfigMerge (тристороннє злиття керованих налаштувань)
+#ifndef CONFIGMERGE_H
+#define CONFIGMERGE_H
+struct ConfigMergeResult {
+    SettingChangeSet applied;   // Записані у файл гри значення користувача (oldValue - значення гри)
+    SettingChangeSet kept;      // Гра змінила після останнього застосування, користувач - ні (oldValue - користувача, newValue - гри)
+    SettingChangeSet conflicts; // Змінили обидві сторони (oldValue - гри, newValue - користувача); переможець - за політикою
+    std::vector<std::string> missingKeys; // Є в конфігу користувача, немає у файлі гри (вузли не створюються)
+    bool hadBase = false;       // false - бази немає, керовані налаштування беруться з конфігу користувача
+    std::size_t managedKeys = 0; // Скільки налаштувань SettingSchema порівнювалось
+};
+// base - стан файлу гри після останнього застосування, ours - поточний файл гри, theirs - конфіг користувача.
+// Зливаються лише керовані налаштування (SettingSchema поза scriptsPreferences, крім NON_EDITABLE);
+// решта ours (прив'язки клавіш, дані входу, intro тощо) лишається як є. ours змінюється на місці - лише
+// тексти значень, тож структура документа не змінюється. Вузли шукаються через SettingNodeIndex трьох
+// документів: час лінійний від їх розміру.
+class ConfigMerge {
+public:
+    enum class ConflictPolicy { THEIRS, OURS };
+    static ConfigMergeResult merge(const pugi::xml_document* base, pugi::xml_document& ours, const pugi::xml_document& theirs,
+                                   ConflictPolicy policy = ConflictPolicy::THEIRS);
+};
+#endif // CONFIGMERGE_H
+
+// ConfigWatcher (стеження за змінами конфігів на диску)
+#ifndef CONFIGWATCHER_H
+#define CONFIGWATCHER_H
+// Фоновий потік стежить за окремими файлами і за *.xml у директоріях (без вкладених). Спостерігаються
+// директорії, тож атомарна заміна файлу (rename - як у AtomicFile) не обриває стеження.
+// Події дебаунсяться: шлях передається в callback, коли він не змінювався debounce після останньої
+// події, тож файл не перечитується посеред запису. Linux - inotify; інші системи - опитування часу
+// зміни і розміру. callback виконується в потоці спостерігача (шляхи абсолютні, зокрема видалені файли).
+class ConfigWatcher {
+public:
+    using Callback = std::function<void(const std::vector<fs::path>& changedFiles)>;
+    explicit ConfigWatcher(std::chrono::milliseconds debounce = std::chrono::milliseconds(500));
+    ~ConfigWatcher();
+    ConfigWatcher(const ConfigWatcher&) = delete;
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    // Шляхи додаються до start(); директорії, яких немає, пропускаються з попередженням у std::cerr
+    void addFile(const fs::path& filePath);
+    void addDirectory(const fs::path& directory);
+    void start(Callback callback);
+    // Зупиняє потік і чекає завершення поточного callback; події, що ще дебаунсяться, відкидаються
+    void stop();
+private:
+    struct State;
+    std::unique_ptr<State> m_state;
+};
+#endif // CONFIGWATCHER_H
+
+// FilteredSettingsReader (потоковий однопрохідний витяг відфільтрованих налаштувань)
+#ifndef FILTEREDSETTINGSREADER_H
+#define FILTEREDSETTINGSREADER_H
+// Дані подаються довільними блоками через feed(); вузли поза фільтром SettingSchema не створюються,
+// зберігаються лише стек імен відкритих елементів і поточні значення. Результат finish() збігається
+// з ConfigEditor::getFilteredSettings. Очікується UTF-8 (як у файлах гри); перевіряється лише
+// парність тегів - повну перевірку XML виконує FileValidator. Помилки - std::runtime_error.
+class FilteredSettingsReader {
+public:
+    FilteredSettingsReader();
+    ~FilteredSettingsReader();
+    FilteredSettingsReader(const FilteredSettingsReader&) = delete;
+    FilteredSettingsReader& operator=(const FilteredSettingsReader&) = delete;
+
+    void feed(const char* data, std::size_t size);
+    // Завершує розбір; після finish() читач більше не використовується
+    FilteredSettingsMap finish();
+    // Найбільший розмір внутрішнього буфера за час розбору (байти)
+    std::size_t peakBufferSize() const;
+private:
+    struct State;
+    std::unique_ptr<State> m_state;
+};
+#endif // FILTEREDSETTINGSREADER_H
+
 #ifndef APPINITIALIZER_H
 #define APPINITIALIZER_H
 class AppInitializer { public: void loadInitialSettings(); void checkFolders(); void initializeComponents(); };
 #endif // APPINITIALIZER_H
+// BackupStore (сховище резервних копій з адресацією за вмістом)
+#ifndef BACKUPSTORE_H
+#define BACKUPSTORE_H
+// Дельта між двома версіями файлу: рядки копіюються з бази (C<зміщення> <довжина>) або
+// вставляються як є (I<довжина> і байти). Помилки apply - std::runtime_error.
+class BackupDelta {
+public:
+    static std::string encode(std::string_view base, std::string_view target);
+    static std::string apply(std::string_view base, std::string_view delta);
+};
+struct BackupEntry {
+    std::uint64_t id = 0;        // Порядковий номер запису (зростає)
+    std::int64_t timestamp = 0;  // Час створення, секунди від епохи
+    std::string hash;            // SHA-256 вмісту (hex) - ім'я об'єкта у сховищі
+    std::uintmax_t size = 0;     // Розмір вмісту в байтах
+    std::string name;            // Ім'я для показу (preferences_YYYY_MM_DD_HHMMSS.xml)
+};
+// Архів резервних копій: один файл, що лише дописується, зі стисненим блоком на кожен об'єкт
+// і індексом у кінці файлу. Пошук блоку - за індексом у пам'яті; читання - один seek і одна
+// розпаковка. Видалені блоки лише вилучаються з індексу, місце повертає ущільнення.
+// Помилки - std::runtime_error.
+class BackupArchive {
+public:
+    static const std::uint8_t kKindMask = 0x01; // Вид вмісту блоку (значення задає власник архіву)
+    struct Stats {
+        std::size_t blocks = 0;
+        std::uint64_t rawBytes = 0;    // Розмір вмісту до стиснення
+        std::uint64_t storedBytes = 0; // Після стиснення
+        std::uint64_t blockBytes = 0;  // Живі блоки разом із заголовками (те, що звільняє remove)
+        std::uint64_t deadBytes = 0;   // Видалені блоки, що ще займають місце
+        std::uint64_t fileBytes = 0;
+    };
+    explicit BackupArchive(fs::path path);
+    bool contains(const std::string& hash);
+    // Блок з таким хешем уже в архіві - нічого не робить
+    void append(const std::string& hash, std::uint8_t kind, std::string_view payload);
+    // false - блоку немає в архіві
+    bool read(const std::string& hash, std::uint8_t& kind, std::string& payload);
+    // Повертає кількість байтів вилучених блоків
+    std::uint64_t remove(const std::vector<std::string>& hashes);
+    Stats stats();
+    const fs::path& path() const { return m_path; }
+private:
+    struct Block {
+        std::uint8_t flags = 0;
+        std::uint64_t offset = 0;
+        std::uint32_t rawSize = 0;
+        std::uint32_t storedSize = 0;
+    };
+    static std::uint64_t blockSize(const Block& block);
+    static std::string serializeFooter(std::uint64_t indexOffset, const std::string& index);
+    std::string serializeIndexLocked() const;
+    void refreshLocked();
+    bool loadIndexLocked(std::FILE* file, std::uintmax_t size);
+    void recoverLocked(std::FILE* file, std::uintmax_t size);
+    void compactLocked();
+    fs::path m_path;
+    fs::path m_lockPath; // <архів>.lock - замок між процесами (FileLock); береться після замка BackupStore
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Block> m_blocks; // Хеш (hex) -> розташування блоку
+    std::uint64_t m_dataEnd = 8;   // Кінець останнього блоку = початок індексу
+    std::uint64_t m_deadBytes = 0;
+    std::uintmax_t m_loadedSize = 0; // Розмір, час зміни та ідентичність файлу на момент читання індексу
+    fs::file_time_type m_loadedTime;
+    std::uint64_t m_loadedIdentity = 0;
+};
+// Політика зберігання копій. Копія лишається, якщо її утримує хоч одне правило; найновіша - завжди.
+// Денні/тижневі кошики рахуються за UTC від епохи.
+struct RetentionPolicy {
+    std::size_t keepLast = 20;        // Останні N копій
+    int keepDailyDays = 30;           // Найновіша копія кожного дня за останні N днів
+    int keepWeeklyWeeks = 26;         // Найновіша копія кожного тижня за останні N тижнів
+    std::uintmax_t maxTotalBytes = 256ull * 1024 * 1024; // Межа обсягу унікального вмісту (0 - без межі); витісняє найстаріші
+};
+struct RetentionReport {
+    std::size_t keptEntries = 0;
+    std::size_t removedEntries = 0;
+    std::size_t removedObjects = 0;
+    std::uintmax_t reclaimedBytes = 0;
+    std::uintmax_t totalBytes = 0;    // Обсяг унікального вмісту після очищення
+    double elapsedSeconds = 0.0;
+};
+// Кожен унікальний вміст зберігається один раз стисненим блоком архіву backups.pack; записи з часом створення
+// дописуються в індекс backups.idx. Повторна копія незміненого файлу - хеш і один рядок індексу.
+// Опційно новий вміст зберігається дельтою від попередньої версії з
+// повною копією (ключовим кадром) щонайменше кожні keyframeInterval версій, тож відновлення
+// застосовує не більше keyframeInterval - 1 дельт. Кілька процесів можуть працювати з однією директорією:
+// зміни йдуть під виключним FileLock (backups.lock), читання - під спільним. Помилки - std::runtime_error.
+class BackupStore {
+public:
+    explicit BackupStore(fs::path directory);
+    // 0 або 1 - лише повні копії (за замовчуванням); N > 1 - дельти з ключовим кадром кожні N версій
+    void setKeyframeInterval(unsigned interval);
+    BackupEntry add(const fs::path& sourceFile, std::int64_t timestamp, const std::string& name);
+    std::vector<BackupEntry> list(); // У порядку створення
+    bool find(std::uint64_t id, BackupEntry& entry);
+    // Вміст запису з перевіркою хешу (дельти застосовуються до найближчого ключового кадру)
+    std::string read(const BackupEntry& entry);
+    // Атомарно записує вміст запису у target
+    void restore(const BackupEntry& entry, const fs::path& target);
+    // Видаляє записи поза політикою і об'єкти без посилань (бази живих дельт лишаються). Працює
+    // за індексом у пам'яті, без сканування директорії; індекс переписується атомарно лише якщо щось видалено.
+    RetentionReport prune(const RetentionPolicy& policy, std::int64_t now);
+    const fs::path& directory() const { return m_directory; }
+    BackupArchive::Stats archiveStats() { return m_archive.stats(); }
+    static std::string hashContent(const std::string& content);
+private:
+    struct DeltaInfo { std::string base; unsigned depth = 0; };
+    fs::path objectPath(const std::string& hash) const;
+    fs::path deltaPath(const std::string& hash) const;
+    std::string readObject(const std::string& hash, unsigned depthLimit);
+    void refreshLocked();
+    void resetLocked();
+    void noteDeltaLocked(const std::string& hash, const std::string& base, unsigned depth);
+    fs::path m_directory;
+    std::mutex m_mutex;
+    std::vector<BackupEntry> m_entries;
+    std::unordered_map<std::string, std::size_t> m_refCounts; // Хеш -> кількість записів
+    std::unordered_map<std::string, DeltaInfo> m_deltaObjects; // Дельта-об'єкти -> база
+    std::unordered_map<std::string, std::size_t> m_dependents; // Хеш -> кількість дельт від нього
+    std::uintmax_t m_indexOffset = 0; // Скільки байтів індексу вже прочитано
+    std::string m_indexGeneration;    // Покоління прочитаного індексу (змінюється, коли prune його переписує)
+    BackupArchive m_archive; // Вміст об'єктів (backups.pack)
+    unsigned m_keyframeInterval = 0;
+    std::string m_lastHash;    // Вміст останньої доданої версії - база наступної дельти
+    std::string m_lastContent;
+};
+#endif // BACKUPSTORE_H
+
 #ifndef BACKUPMANAGER_H
 #define BACKUPMANAGER_H
-class BackupManager { private: FileValidator m_validator; fs::path getGameConfigPath(); public: fs::path createBackup(); void restoreFromBackup(const fs::path& backupPath); void manageBackupSpace(); };
+class BackupManager {
+private:
+    FileValidator m_validator;
+    BackupStore m_store{"Restored Configs"};
+    fs::path getGameConfigPath();
+public:
+    // Знімок поточного preferences.xml у сховищі (незмінений вміст - лише новий запис індексу)
+    BackupEntry createBackup();
+    std::vector<BackupEntry> listBackups();
+    void restoreBackup(const BackupEntry& entry);
+    // Відновлення з окремого XML-файлу (копії, створені до появи сховища, або будь-який інший файл)
+    void restoreFromBackup(const fs::path& backupPath);
+    // Дельта-режим сховища: 0 - повні копії; N > 1 - ключовий кадр кожні N версій
+    void setDeltaStorage(unsigned keyframeInterval);
+    // Очищення сховища за політикою зберігання (викликається після кожного createBackup)
+    RetentionReport manageBackupSpace(const RetentionPolicy& policy = RetentionPolicy());
+};
 #endif // BACKUPMANAGER_H
+// LogStore (структурований лог з ротацією та індексом за часом)
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+struct LogEntry {
+    std::int64_t timeMs = 0; // Мілісекунди від епохи
+    std::string functionName;
+    bool success = false;
+    std::string details;
+};
+struct LogRotationPolicy {
+    std::uintmax_t maxSegmentBytes = 4 * 1024 * 1024; // Розмір сегмента до ротації (0 - без межі)
+    std::int64_t maxSegmentAgeSeconds = 7 * 24 * 60 * 60; // Вік першого запису сегмента до ротації (0 - без межі)
+    std::size_t maxSegments = 8;                       // Найстаріші сегменти понад це число видаляються
+};
+// За замовчуванням - усі записи; fromMs/toMs обмежують вікно, lastCount > 0 - лише останні N у ньому
+struct LogQuery {
+    std::size_t lastCount = 0;
+    std::int64_t fromMs = std::numeric_limits<std::int64_t>::min();
+    std::int64_t toMs = std::numeric_limits<std::int64_t>::max();
+};
+// Лог у форматі JSON Lines (logs.<N>.jsonl) з ротацією сегментів і розрідженим індексом logs.idx.
+// Запис не потокобезпечний (ним володіє один потік-записувач ChangeTracker); query лише читає
+// файли і може викликатися з будь-якого потоку. Помилки запису - у std::cerr, як і раніше.
+class LogStore {
+public:
+    explicit LogStore(fs::path directory, const LogRotationPolicy& policy = LogRotationPolicy());
+    ~LogStore();
+    LogStore(const LogStore&) = delete;
+    LogStore& operator=(const LogStore&) = delete;
+    void setPolicy(const LogRotationPolicy& policy);
+    // Додає запис у буфер; на диск - при flush()
+    void append(const LogEntry& entry);
+    bool flush();
+    std::size_t bufferedBytes() const { return m_segmentBuffer.size(); }
+    // Читає лише хвіст логу від найближчої точки індексу; записи - у хронологічному порядку
+    static std::vector<LogEntry> query(const fs::path& directory, const LogQuery& query);
+    static std::string formatRecord(const LogEntry& entry);
+    static bool parseRecord(std::string_view line, LogEntry& entry);
+private:
+    struct IndexPoint {
+        std::uint64_t seq = 0;     // Номер сегмента
+        std::uint64_t offset = 0;  // Зміщення рядка в сегменті
+        std::int64_t timeMs = 0;   // Час запису (не спадає від точки до точки)
+        std::uint64_t ordinal = 0; // Порядковий номер запису в усьому лозі
+    };
+    static std::vector<IndexPoint> readIndex(const fs::path& directory);
+    static std::string formatIndexPoint(const IndexPoint& point);
+    static std::uint64_t scanSegment(const fs::path& path, std::uint64_t offset,
+                                     const std::function<bool(std::uint64_t, const LogEntry&)>& visit);
+    bool open();
+    bool rewriteIndex();
+    void rotate();
+    void closeFiles();
+    fs::path m_directory;
+    LogRotationPolicy m_policy;
+    bool m_opened = false;
+    std::FILE* m_segmentFile = nullptr;
+    std::FILE* m_indexFile = nullptr;
+    std::vector<IndexPoint> m_points;
+    std::uint64_t m_seq = 1;
+    std::uint64_t m_segmentBytes = 0;   // Уже записано в активний сегмент
+    std::uint64_t m_segmentRecords = 0;
+    std::int64_t m_segmentFirstMs = 0;
+    std::uint64_t m_nextOrdinal = 0;
+    std::int64_t m_lastPointMs = 0;
+    std::string m_segmentBuffer;
+    std::string m_indexBuffer;
+};
+#endif // LOGSTORE_H
 #ifndef CHANGETRACKER_H
 #define CHANGETRACKER_H
-class ChangeTracker { public: void logAction(const std::string& functionName, bool success, const std::string& details = ""); };
+class ChangeTracker {
+public:
+    void logAction(const std::string& functionName, bool success, const std::string& details = "");
+    // Один запис на кожну зміну: "<файл> | <категорія>/<ключ>: '<старе>' -> '<нове>'"
+    void logChanges(const std::string& functionName, const fs::path& filePath, const SettingChangeSet& changes);
+    // Записи пишуться у "User Data/logs.<N>.jsonl" (LogStore) фоновим потоком пачками (раз на 200 мс
+    // або за накопиченням); flush() чекає, доки все зареєстроване до виклику потрапить у файл.
+    // Решта черги дописується при завершенні програми.
+    static void flush();
+    static void setRotationPolicy(const LogRotationPolicy& policy);
+    // Історія для перегляду в програмі (спершу flush, щоб включити щойно зареєстровані дії)
+    static std::vector<LogEntry> readHistory(const LogQuery& query);
+};
 #endif // CHANGETRACKER_H
 #ifndef CONFIGMANAGER_H
 #define CONFIGMANAGER_H
-class ConfigManager { private: FileValidator m_validator; fs::path getGameConfigPathInternal(); public: void changeCurrentConfig(const fs::path& sourceConfigPath); fs::path getCurrentGameConfigPath(); std::string viewCurrentGameConfigContent(); void uploadConfig(); };
+class ConfigManager {
+private:
+    FileValidator m_validator;
+    fs::path getGameConfigPathInternal();
+    void recordAppliedBase(const fs::path& sourceConfigPath);
+public:
+    void changeCurrentConfig(const fs::path& sourceConfigPath);
+    // Тристороннє злиття з поточним файлом гри (база - знімок останнього застосування, "User Data/applied-base.xml").
+    // Файлу гри немає - конфіг копіюється повністю, як у changeCurrentConfig. Помилки - std::runtime_error.
+    ConfigMergeResult mergeIntoCurrentConfig(const fs::path& sourceConfigPath,
+                                             ConfigMerge::ConflictPolicy policy = ConfigMerge::ConflictPolicy::THEIRS);
+    static fs::path appliedBasePath();
+    fs::path getCurrentGameConfigPath();
+    std::string viewCurrentGameConfigContent();
+    void uploadConfig();
+};
 #endif // CONFIGMANAGER_H
 #ifndef PROFILEMANAGER_H
 #define PROFILEMANAGER_H
@@ -3,6 +3,8 @@
 #include "helpdialog.h"        // <-- ВКЛЮЧЕНО helpdialog.h
 #include "statsdialog.h"
 #include "aichatdialog.h"
+#include "xmltreedialog.h"
+#include "xmltreemodel.h"
 
 // Включаємо необхідні заголовки Qt
 #include <QDateTime>
@@ -16,11 +18,16 @@
 #include <QFileDialog>
 #include <QMessageBox>
 #include <QScrollBar>
-#include <QTreeWidget>
-#include <QTreeWidgetItem>
+#include <QTreeView>
 #include <QHeaderView>
 #include <QStackedWidget>
 #include <QDebug>
+#include <QLabel>
+#include <QProgressBar>
+#include <QHash>
+#include <QStatusBar>
+#include <algorithm>
+#include <iterator>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -36,16 +43,21 @@ MainWindow::MainWindow(QWidget *parent)
 
     // Налаштовуємо з'єднання сигналів
     setupConnections();
+    setupTaskStatus();
 
     // Виконуємо початкові дії
     onCheckFoldersClicked();
     loadUsername();
+    startConfigWatcher();
 
     appendLog("Програма готова до роботи.");
 }
 
 MainWindow::~MainWindow()
 {
+    // Фонові потоки звертаються до this - зупиняються до руйнування членів
+    m_configWatcher.stop();
+    m_taskRunner.shutdown();
     appendLog("Завершення роботи програми...");
     m_logger.logAction("Application::Exit", true);
     delete ui;
@@ -83,6 +95,47 @@ void MainWindow::setupConnections()
     }
 }
 
+// Рядок стану фонових операцій: назва, прогрес і скасування (видимий, поки є незавершені завдання)
+void MainWindow::setupTaskStatus()
+{
+    m_taskLabel = new QLabel(this);
+    m_taskProgress = new QProgressBar(this);
+    m_taskProgress->setMaximumWidth(200);
+    m_taskProgress->setTextVisible(false);
+    m_cancelTasksButton = new QPushButton("Скасувати", this);
+    statusBar()->addPermanentWidget(m_taskLabel);
+    statusBar()->addPermanentWidget(m_taskProgress);
+    statusBar()->addPermanentWidget(m_cancelTasksButton);
+
+    auto setVisible = [this](bool visible) {
+        m_taskLabel->setVisible(visible);
+        m_taskProgress->setVisible(visible);
+        m_cancelTasksButton->setVisible(visible);
+    };
+    setVisible(false);
+
+    connect(m_cancelTasksButton, &QPushButton::clicked, this, [this] {
+        m_taskRunner.cancelAll();
+        appendLog("Скасування фонових операцій...");
+        m_logger.logAction("MainWindow::CancelTasks", true, std::to_string(m_taskRunner.activeCount()) + " active");
+    });
+    connect(&m_taskRunner, &TaskRunner::taskStarted, this, [this, setVisible](quint64, const QString& name) {
+        m_taskLabel->setText(name + "...");
+        m_taskProgress->setRange(0, 0); // Тривалість невідома, доки завдання не повідомить прогрес
+        setVisible(true);
+    });
+    connect(&m_taskRunner, &TaskRunner::taskProgress, this, [this](quint64, int percent, const QString& text) {
+        if (percent < 0) {
+            m_taskProgress->setRange(0, 0);
+        } else {
+            m_taskProgress->setRange(0, 100);
+            m_taskProgress->setValue(percent);
+        }
+        if (!text.isEmpty()) m_taskLabel->setText(text);
+    });
+    connect(&m_taskRunner, &TaskRunner::allTasksFinished, this, [setVisible] { setVisible(false); });
+}
+
 void MainWindow::onCheckFoldersClicked()
 {
     appendLog("Перевірка необхідних папок...");
@@ -102,56 +155,112 @@ void MainWindow::onCreateBackupClicked()
 {
     appendLog("Створення резервної копії...");
     m_logger.logAction("MainWindow::CreateBackup", true, "Starting backup process");
-    try {
-        fs::path backupPath = m_backupManager.createBackup(); // Метод логіки повертає шлях
-        QString filename = QString::fromStdWString(backupPath.filename().wstring());
-        QString msg = QString("Резервну копію успішно створено: %1").arg(filename);
-        appendLog(msg);
-        showMessage("Резервне копіювання", msg);
-        m_logger.logAction("BackupManager::createBackup", true, backupPath.filename().string());
-    } catch (const std::exception& e) {
-        QString errorMsg = QString("Помилка створення резервної копії: %1").arg(QString::fromStdString(e.what()));
+    // Копія й очищення - у фоні; операції з конфігом гри виконуються по черзі (ключ - його шлях)
+    m_taskRunner.run("Резервне копіювання", gameConfigPathOrEmpty(), [this](TaskRunner::Context& context) -> TaskRunner::Apply {
+        context.reportProgress(-1, "Створення копії");
+        const BackupEntry backup = m_backupManager.createBackup(); // Метод логіки повертає запис сховища
+
+        // Очищення старих копій за політикою зберігання; помилка тут не скасовує створену копію
+        context.reportProgress(-1, "Очищення старих копій");
+        RetentionReport report;
+        std::string cleanupError;
+        try {
+            report = m_backupManager.manageBackupSpace();
+        } catch (const std::exception& e) {
+            cleanupError = e.what();
+        }
+
+        return [this, backup, report, cleanupError] {
+            QString filename = QString::fromStdString(backup.name);
+            QString msg = QString("Резервну копію успішно створено: %1").arg(filename);
+            appendLog(msg);
+            m_logger.logAction("BackupManager::createBackup", true, backup.name + " (" + backup.hash.substr(0, 12) + ")");
+            if (!cleanupError.empty()) {
+                appendLog(QString("Помилка очищення старих резервних копій: %1").arg(QString::fromStdString(cleanupError)));
+                m_logger.logAction("BackupManager::manageBackupSpace", false, cleanupError);
+            } else {
+                if (report.removedEntries > 0) {
+                    appendLog(QString("Очищено старих резервних копій: %1 (об'єктів: %2, звільнено %3 КБ).")
+                                  .arg(report.removedEntries)
+                                  .arg(report.removedObjects)
+                                  .arg(static_cast<double>(report.reclaimedBytes) / 1024.0, 0, 'f', 1));
+                }
+                m_logger.logAction("BackupManager::manageBackupSpace", true,
+                                   "kept: " + std::to_string(report.keptEntries) + ", removed: " + std::to_string(report.removedEntries) +
+                                       ", reclaimed bytes: " + std::to_string(report.reclaimedBytes));
+            }
+            showMessage("Резервне копіювання", msg);
+        };
+    }, [this](const QString& error) {
+        QString errorMsg = QString("Помилка створення резервної копії: %1").arg(error);
         appendLog(errorMsg);
         showMessage("Помилка резервного копіювання", errorMsg, true);
-        m_logger.logAction("BackupManager::createBackup", false, e.what());
-    }
+        m_logger.logAction("BackupManager::createBackup", false, error.toStdString());
+    });
 }
 
 void MainWindow::onRestoreBackupClicked()
 {
-    QString backupFile = selectBackupFile(); // Вибираємо файл
-    if (backupFile.isEmpty()) {
+    BackupEntry backup;
+    QString backupFile;
+    if (!selectBackup(backup, backupFile)) { // Запис сховища або окремий файл
         appendLog("Відновлення з копії скасовано.");
         m_logger.logAction("MainWindow::RestoreBackup", false, "Cancelled by user (file selection)");
         return;
     }
 
+    if (backupFile.isEmpty()) {
+        QString name = QString::fromStdString(backup.name);
+        appendLog(QString("Відновлення конфігурації з резервної копії: %1").arg(name));
+        m_logger.logAction("MainWindow::RestoreBackup", true, "Attempting restore from store entry " + backup.name);
+        m_taskRunner.run("Відновлення з копії", gameConfigPathOrEmpty(), [this, backup, name](TaskRunner::Context& context) -> TaskRunner::Apply {
+            context.throwIfCancelled();
+            m_backupManager.restoreBackup(backup); // Перевірка вмісту виконується всередині
+            return [this, backup, name] {
+                QString msg = QString("Конфігурацію успішно відновлено з: %1").arg(name);
+                appendLog(msg);
+                showMessage("Відновлення завершено", msg);
+                m_logger.logAction("BackupManager::restoreBackup", true, backup.name + " (" + backup.hash.substr(0, 12) + ")");
+            };
+        }, [this](const QString& error) {
+            QString errorMsg = QString("Помилка відновлення з копії: %1").arg(error);
+            appendLog(errorMsg);
+            showMessage("Помилка відновлення", errorMsg, true);
+            m_logger.logAction("BackupManager::restoreBackup", false, error.toStdString());
+        });
+        return;
+    }
+
     fs::path backupPath = backupFile.toStdWString();
     QString filename = QFileInfo(backupFile).fileName();
     appendLog(QString("Відновлення конфігурації з файлу: %1").arg(filename));
     m_logger.logAction("MainWindow::RestoreBackup", true, "Attempting restore from " + filename.toStdString());
 
-    // Валідація файлу перед відновленням
-    if (!m_fileValidator.validateBeforeAction(backupPath, "Відновлення з копії")) {
-        appendLog("Перевірка перед відновленням не пройдена або скасована.");
-        m_logger.logAction("MainWindow::RestoreBackup", false, "Pre-restore validation failed or cancelled: " + filename.toStdString());
-        return;
-    }
-    appendLog("Перевірка файлу перед відновленням пройдена.");
-
-    // Виконуємо відновлення
-    try {
-        m_backupManager.restoreFromBackup(backupPath); // Викликаємо метод логіки
-        QString msg = QString("Конфігурацію успішно відновлено з: %1").arg(filename);
-        appendLog(msg);
-        showMessage("Відновлення завершено", msg);
-        m_logger.logAction("BackupManager::restoreFromBackup", true, filename.toStdString());
-    } catch (const std::exception& e) {
-        QString errorMsg = QString("Помилка відновлення з копії: %1").arg(QString::fromStdString(e.what()));
-        appendLog(errorMsg);
-        showMessage("Помилка відновлення", errorMsg, true);
-        m_logger.logAction("BackupManager::restoreFromBackup", false, e.what());
-    }
+    // Валідація файлу перед відновленням: розбір у фоні, підтвердження - у потоці GUI
+    validateThen(backupPath, "Відновлення з копії", false, [this, backupPath, filename](bool accepted) {
+        if (!accepted) {
+            appendLog("Перевірка перед відновленням не пройдена або скасована.");
+            m_logger.logAction("MainWindow::RestoreBackup", false, "Pre-restore validation failed or cancelled: " + filename.toStdString());
+            return;
+        }
+        appendLog("Перевірка файлу перед відновленням пройдена.");
+
+        m_taskRunner.run("Відновлення з копії", gameConfigPathOrEmpty(), [this, backupPath, filename](TaskRunner::Context& context) -> TaskRunner::Apply {
+            context.throwIfCancelled();
+            m_backupManager.restoreFromBackup(backupPath); // Викликаємо метод логіки
+            return [this, filename] {
+                QString msg = QString("Конфігурацію успішно відновлено з: %1").arg(filename);
+                appendLog(msg);
+                showMessage("Відновлення завершено", msg);
+                m_logger.logAction("BackupManager::restoreFromBackup", true, filename.toStdString());
+            };
+        }, [this](const QString& error) {
+            QString errorMsg = QString("Помилка відновлення з копії: %1").arg(error);
+            appendLog(errorMsg);
+            showMessage("Помилка відновлення", errorMsg, true);
+            m_logger.logAction("BackupManager::restoreFromBackup", false, error.toStdString());
+        });
+    });
 }
 
 void MainWindow::onSetUsernameClicked()
@@ -232,47 +341,77 @@ void MainWindow::onEditConfigClicked()
     appendLog("Спроба редагування файлу: " + filename);
     m_logger.logAction("MainWindow::EditConfig", true, "Attempting to edit " + filename.toStdString());
 
-    if (!m_fileValidator.validateBeforeAction(configPath, "Редагування конфігу", false)) {
-        appendLog("Перевірка файлу перед редагуванням не пройдена або скасована.");
-        m_logger.logAction("MainWindow::EditConfig", false, "Pre-edit validation failed or cancelled: " + filename.toStdString());
-        return;
-    }
-
-    try {
-        FilteredSettingsMap currentSettings = m_configEditor.getFilteredSettings(configPath);
-        if (currentSettings.empty()) {
-            showMessage("Редагування", "Не знайдено відомих налаштувань для редагування у файлі " + filename, true);
-            appendLog("Не знайдено відомих налаштувань для редагування у: " + filename);
-            m_logger.logAction("ConfigEditor::getFilteredSettings", false, "No known settings found for editing in " + filename.toStdString());
-            return;
+    // Валідація і розбір - одним фоновим завданням; діалог і підтвердження - у потоці GUI
+    m_taskRunner.run("Відкриття для редагування", configPath, [this, configPath, filename](TaskRunner::Context& context) -> TaskRunner::Apply {
+        context.reportProgress(-1, "Валідація");
+        const ValidationResult validation = m_fileValidator.validateFile(configPath);
+        FilteredSettingsMap currentSettings;
+        if (validation.isValid()) {
+            context.throwIfCancelled();
+            context.reportProgress(-1, "Читання налаштувань");
+            currentSettings = m_configEditor.getFilteredSettings(configPath);
         }
-
-        ConfigEditDialog editDialog(currentSettings, configPath, this);
-        if (editDialog.exec() == QDialog::Accepted) {
-            appendLog("Збереження змін після редагування...");
-            FilteredSettingsMap updatedSettings = editDialog.getUpdatedSettings();
-            try {
-                m_configEditor.saveFilteredSettings(configPath, updatedSettings);
-                appendLog("Зміни у файлі '" + filename + "' успішно збережено.");
-                showMessage("Редагування", "Зміни успішно збережено.");
-                m_logger.logAction("ConfigEditor::saveFilteredSettings", true, filename.toStdString());
-            } catch (const std::exception& saveError) {
-                QString errorMsg = QString("Помилка збереження змін у файл '%1': %2").arg(filename).arg(QString::fromStdString(saveError.what()));
-                appendLog(errorMsg);
-                showMessage("Помилка збереження", errorMsg, true);
-                m_logger.logAction("ConfigEditor::saveFilteredSettings", false, saveError.what());
+        return [this, configPath, filename, validation, currentSettings] {
+            if (!m_fileValidator.confirmBeforeAction(configPath, validation, "Редагування конфігу", false)) {
+                appendLog("Перевірка файлу перед редагуванням не пройдена або скасована.");
+                m_logger.logAction("MainWindow::EditConfig", false, "Pre-edit validation failed or cancelled: " + filename.toStdString());
+                return;
+            }
+            if (currentSettings.empty()) {
+                appendLog("Не знайдено відомих налаштувань для редагування у: " + filename);
+                m_logger.logAction("ConfigEditor::getFilteredSettings", false, "No known settings found for editing in " + filename.toStdString());
+                QMessageBox::StandardButton reply = QMessageBox::question(this, "Редагування",
+                    "Не знайдено відомих налаштувань для редагування у файлі " + filename +
+                    ".\nВідкрити весь XML у розширеному режимі?", QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
+                if (reply == QMessageBox::Yes) displayXmlTreeDialog(configPath, true);
+                return;
             }
-        } else {
-            appendLog("Редагування файлу '" + filename + "' скасовано користувачем.");
-            m_logger.logAction("MainWindow::EditConfig", false, "Cancelled by user in dialog: " + filename.toStdString());
-        }
 
-    } catch (const std::exception& e) {
-        QString errorMsg = QString("Помилка підготовки до редагування файлу '%1': %2").arg(filename).arg(QString::fromStdString(e.what()));
+            ConfigEditDialog editDialog(currentSettings, configPath, this);
+            const int result = editDialog.exec();
+            if (result == ConfigEditDialog::AdvancedModeRequested) {
+                displayXmlTreeDialog(configPath, true);
+                return;
+            }
+            if (result != QDialog::Accepted) {
+                appendLog("Редагування файлу '" + filename + "' скасовано користувачем.");
+                m_logger.logAction("MainWindow::EditConfig", false, "Cancelled by user in dialog: " + filename.toStdString());
+                return;
+            }
+            SettingChangeSet changes = editDialog.getChangedSettings();
+            if (changes.empty()) {
+                appendLog("Змін у файлі '" + filename + "' немає, збереження не потрібне.");
+                m_logger.logAction("ConfigEditor::saveSettingChanges", true, "No changes: " + filename.toStdString());
+                return;
+            }
+            appendLog(QString("Збереження змін після редагування (%1 знач.)...").arg(changes.size()));
+            saveConfigChanges(configPath, filename, changes);
+        };
+    }, [this, filename](const QString& error) {
+        QString errorMsg = QString("Помилка підготовки до редагування файлу '%1': %2").arg(filename).arg(error);
         appendLog(errorMsg);
         showMessage("Помилка редагування", errorMsg, true);
-        m_logger.logAction("MainWindow::EditConfig", false, e.what());
-    }
+        m_logger.logAction("MainWindow::EditConfig", false, error.toStdString());
+    });
+}
+
+void MainWindow::saveConfigChanges(const fs::path& configPath, const QString& filename, const SettingChangeSet& changes)
+{
+    m_taskRunner.run("Збереження змін", configPath, [this, configPath, filename, changes](TaskRunner::Context& context) -> TaskRunner::Apply {
+        context.throwIfCancelled();
+        const SettingChangeSet applied = m_configEditor.saveSettingChanges(configPath, changes);
+        return [this, configPath, filename, applied] {
+            appendLog(QString("Зміни у файлі '%1' успішно збережено (%2 знач.).").arg(filename).arg(applied.size()));
+            showMessage("Редагування", "Зміни успішно збережено.");
+            m_logger.logAction("ConfigEditor::saveSettingChanges", true, filename.toStdString() + ", changed: " + std::to_string(applied.size()));
+            m_logger.logChanges("ConfigEditor::saveSettingChanges", configPath, applied);
+        };
+    }, [this, filename](const QString& error) {
+        QString errorMsg = QString("Помилка збереження змін у файл '%1': %2").arg(filename).arg(error);
+        appendLog(errorMsg);
+        showMessage("Помилка збереження", errorMsg, true);
+        m_logger.logAction("ConfigEditor::saveSettingChanges", false, error.toStdString());
+    });
 }
 
 
@@ -290,25 +429,87 @@ void MainWindow::onChangeConfigClicked() // Застосовує конфіг к
     appendLog(QString("Спроба застосування конфігу: %1").arg(filename));
     m_logger.logAction("MainWindow::ChangeConfig", true, "Attempting to apply " + filename.toStdString());
 
-    if (!m_fileValidator.validateBeforeAction(sourcePath, "Застосування конфігу")) {
-        appendLog("Перевірка перед застосуванням не пройдена або скасована.");
-        m_logger.logAction("MainWindow::ChangeConfig", false, "Pre-apply validation failed or cancelled: " + filename.toStdString());
-        return;
-    }
-    appendLog("Перевірка файлу перед застосуванням пройдена.");
+    validateThen(sourcePath, "Застосування конфігу", false, [this, sourcePath, filename](bool accepted) {
+        if (!accepted) {
+            appendLog("Перевірка перед застосуванням не пройдена або скасована.");
+            m_logger.logAction("MainWindow::ChangeConfig", false, "Pre-apply validation failed or cancelled: " + filename.toStdString());
+            return;
+        }
+        appendLog("Перевірка файлу перед застосуванням пройдена.");
+        applyUserConfig(sourcePath, filename);
+    });
+}
 
+void MainWindow::applyUserConfig(const fs::path& sourcePath, const QString& filename)
+{
+    fs::path gameConfigPath;
     try {
-        m_configManager.changeCurrentConfig(sourcePath);
-        QString msg = QString("Конфіг '%1' успішно застосовано до гри.").arg(filename);
-        appendLog(msg);
-        showMessage("Застосування конфігу", msg);
-        m_logger.logAction("ConfigManager::changeCurrentConfig", true, filename.toStdString());
+        gameConfigPath = m_configManager.getCurrentGameConfigPath();
     } catch (const std::exception& e) {
         QString errorMsg = QString("Помилка застосування конфігу: %1").arg(QString::fromStdString(e.what()));
         appendLog(errorMsg);
         showMessage("Помилка застосування", errorMsg, true);
         m_logger.logAction("ConfigManager::changeCurrentConfig", false, e.what());
+        return;
+    }
+
+    // Злиття зберігає те, що гра записала після останнього застосування (прив'язки клавіш, дані входу тощо)
+    bool merge = false;
+    if (fs::exists(gameConfigPath)) {
+        QMessageBox modeBox(this);
+        modeBox.setWindowTitle("Застосування конфігу");
+        modeBox.setText("Застосувати лише налаштування програми і зберегти решту поточного конфігу гри?");
+        modeBox.setIcon(QMessageBox::Question);
+        QPushButton* mergeButton = modeBox.addButton("Злити", QMessageBox::AcceptRole);
+        QPushButton* replaceButton = modeBox.addButton("Замінити повністю", QMessageBox::DestructiveRole);
+        modeBox.addButton(QMessageBox::Cancel);
+        modeBox.setDefaultButton(mergeButton);
+        modeBox.exec();
+        if (modeBox.clickedButton() != mergeButton && modeBox.clickedButton() != replaceButton) {
+            appendLog("Застосування конфігу користувача скасовано.");
+            m_logger.logAction("MainWindow::ChangeConfig", false, "Cancelled by user (apply mode)");
+            return;
+        }
+        merge = modeBox.clickedButton() == mergeButton;
     }
+
+    const std::string action = merge ? "ConfigManager::mergeIntoCurrentConfig" : "ConfigManager::changeCurrentConfig";
+    m_taskRunner.run("Застосування конфігу", gameConfigPath,
+                     [this, sourcePath, filename, gameConfigPath, merge, action](TaskRunner::Context& context) -> TaskRunner::Apply {
+        context.throwIfCancelled();
+        if (!merge) {
+            m_configManager.changeCurrentConfig(sourcePath);
+            return [this, filename, action] {
+                QString msg = QString("Конфіг '%1' успішно застосовано до гри.").arg(filename);
+                appendLog(msg);
+                showMessage("Застосування конфігу", msg);
+                m_logger.logAction(action, true, filename.toStdString());
+            };
+        }
+        const ConfigMergeResult result = m_configManager.mergeIntoCurrentConfig(sourcePath);
+        return [this, filename, gameConfigPath, action, result] {
+            QString msg = QString("Конфіг '%1' злито з конфігом гри: застосовано %2, лишено значень гри %3, конфліктів %4.")
+                              .arg(filename)
+                              .arg(result.applied.size())
+                              .arg(result.kept.size())
+                              .arg(result.conflicts.size());
+            for (const SettingChange& conflict : result.conflicts) {
+                appendLog(QString("Конфлікт '%1': гра - %2, конфіг - %3 (застосовано значення конфігу)")
+                              .arg(QString::fromStdString(conflict.key))
+                              .arg(QString::fromStdString(conflict.oldValue))
+                              .arg(QString::fromStdString(conflict.newValue)));
+            }
+            m_logger.logChanges(action, gameConfigPath, result.applied);
+            appendLog(msg);
+            showMessage("Застосування конфігу", msg);
+            m_logger.logAction(action, true, filename.toStdString());
+        };
+    }, [this, action](const QString& error) {
+        QString errorMsg = QString("Помилка застосування конфігу: %1").arg(error);
+        appendLog(errorMsg);
+        showMessage("Помилка застосування", errorMsg, true);
+        m_logger.logAction(action, false, error.toStdString());
+    });
 }
 
 void MainWindow::onCheckCurrentConfigClicked() // Показує конфіг гри (відфільтровано)
@@ -334,29 +535,74 @@ void MainWindow::onCheckCurrentConfigClicked() // Показує конфіг г
 
 void MainWindow::onValidateConfigClicked()
 {
-    QString fileToValidate = selectFileToValidate();
-    if (fileToValidate.isEmpty()) {
+    QStringList filesToValidate = selectFilesToValidate();
+    if (filesToValidate.isEmpty()) {
         appendLog("Валідацію файлу скасовано.");
         m_logger.logAction("MainWindow::ValidateConfig", false, "Cancelled by user (file selection)");
         return;
     }
 
+    // Кілька файлів - пакетна валідація в пулі потоків з одним зведеним звітом
+    if (filesToValidate.size() > 1) {
+        appendLog(QString("--- Пакетна валідація: %1 файлів ---").arg(filesToValidate.size()));
+        m_logger.logAction("MainWindow::ValidateConfig", true, "Starting batch validation for " + std::to_string(filesToValidate.size()) + " files");
+
+        std::vector<fs::path> paths;
+        paths.reserve(filesToValidate.size());
+        for (const QString& file : filesToValidate) paths.push_back(file.toStdWString());
+
+        m_taskRunner.run("Пакетна валідація", fs::path(), [this, paths](TaskRunner::Context& context) -> TaskRunner::Apply {
+            // Частинами: між ними - прогрес і перевірка скасування (кожна частина - паралельно в пулі)
+            constexpr std::size_t kChunkSize = 64;
+            BatchValidationReport report;
+            report.results.reserve(paths.size());
+            for (std::size_t begin = 0; begin < paths.size(); begin += kChunkSize) {
+                context.throwIfCancelled();
+                context.reportProgress(static_cast<int>(begin * 100 / paths.size()),
+                                       QString("%1 з %2 файлів").arg(begin).arg(paths.size()));
+                const std::vector<fs::path> chunk(paths.begin() + begin, paths.begin() + std::min(paths.size(), begin + kChunkSize));
+                BatchValidationReport part = m_fileValidator.validateFiles(chunk);
+                std::move(part.results.begin(), part.results.end(), std::back_inserter(report.results));
+                report.validCount += part.validCount;
+                report.warningCount += part.warningCount;
+                report.invalidCount += part.invalidCount;
+                report.threadCount = part.threadCount;
+                report.elapsedSeconds += part.elapsedSeconds;
+            }
+            return [this, report] {
+                displayBatchValidationReport(report);
+                m_logger.logAction("FileValidator::validateFiles", report.invalidCount == 0,
+                                   std::to_string(report.results.size()) + " files, OK: " + std::to_string(report.validCount) +
+                                       ", warnings: " + std::to_string(report.warningCount) +
+                                       ", invalid: " + std::to_string(report.invalidCount));
+            };
+        }, [this](const QString& error) {
+            QString errorMsg = QString("Помилка під час пакетної валідації: %1").arg(error);
+            appendLog(errorMsg);
+            showMessage("Помилка валідації", errorMsg, true);
+            m_logger.logAction("FileValidator::validateFiles", false, error.toStdString());
+        });
+        return;
+    }
+
+    const QString& fileToValidate = filesToValidate.first();
     fs::path validatePath = fileToValidate.toStdWString();
     QString filename = QFileInfo(fileToValidate).fileName();
     appendLog(QString("--- Валідація файлу: %1 ---").arg(filename));
     m_logger.logAction("MainWindow::ValidateConfig", true, "Starting validation for " + filename.toStdString());
 
-    try {
-        ValidationResult result = m_fileValidator.validateFile(validatePath);
-        displayValidationResult(result, filename);
-        m_logger.logAction("FileValidator::validateFile", result.isValid(), filename.toStdString() + " - " + formatValidationSummary(result).toStdString());
-
-    } catch (const std::exception& e) {
-        QString errorMsg = QString("Помилка під час валідації файлу '%1': %2").arg(filename).arg(QString::fromStdString(e.what()));
+    m_taskRunner.run("Валідація", validatePath, [this, validatePath, filename](TaskRunner::Context&) -> TaskRunner::Apply {
+        const ValidationResult result = m_fileValidator.validateFile(validatePath);
+        return [this, result, filename] {
+            displayValidationResult(result, filename);
+            m_logger.logAction("FileValidator::validateFile", result.isValid(), filename.toStdString() + " - " + formatValidationSummary(result).toStdString());
+        };
+    }, [this, filename](const QString& error) {
+        QString errorMsg = QString("Помилка під час валідації файлу '%1': %2").arg(filename).arg(error);
         appendLog(errorMsg);
         showMessage("Помилка валідації", errorMsg, true);
-        m_logger.logAction("FileValidator::validateFile", false, e.what());
-    }
+        m_logger.logAction("FileValidator::validateFile", false, error.toStdString());
+    });
 }
 
 
@@ -453,140 +699,234 @@ void MainWindow::displaySettingsInTreeDialog(const fs::path& configPath, const s
     appendLog(QString("Спроба відображення відфільтрованих налаштувань: %1").arg(filename));
     m_logger.logAction(logActionName, true, "Attempting to display filtered " + filename.toStdString());
 
-    if (!m_fileValidator.validateBeforeAction(configPath, "Перегляд налаштувань", false)) {
-        appendLog("Перевірка файлу перед показом налаштувань не пройдена або скасована.");
-        m_logger.logAction(logActionName, false, "Pre-display validation failed or cancelled: " + filename.toStdString());
-        return;
-    }
+    // Валідація і розбір - у фоні; підтвердження і вікно - у потоці GUI
+    m_taskRunner.run("Перегляд налаштувань", configPath,
+                     [this, configPath, windowTitlePrefix, filename, logActionName](TaskRunner::Context& context) -> TaskRunner::Apply {
+        const ValidationResult validation = m_fileValidator.validateFile(configPath);
+        FilteredSettingsMap settings;
+        if (validation.isValid()) {
+            context.throwIfCancelled();
+            settings = m_configEditor.getFilteredSettings(configPath);
+        }
+        return [this, configPath, windowTitlePrefix, filename, logActionName, validation, settings] {
+            if (!m_fileValidator.confirmBeforeAction(configPath, validation, "Перегляд налаштувань", false)) {
+                appendLog("Перевірка файлу перед показом налаштувань не пройдена або скасована.");
+                m_logger.logAction(logActionName, false, "Pre-display validation failed or cancelled: " + filename.toStdString());
+                return;
+            }
+            if (settings.empty()) {
+                showMessage("Перегляд налаштувань", "Не знайдено відомих налаштувань у файлі " + filename, true);
+                appendLog("Не знайдено відомих налаштувань у файлі: " + filename);
+                m_logger.logAction("ConfigEditor::getFilteredSettings", false, "No known settings found in " + filename.toStdString());
+                return;
+            }
+            showSettingsTreeDialog(configPath, windowTitlePrefix, settings);
+            appendLog(QString("Відфільтровані налаштування з '%1' відображено.").arg(filename));
+            m_logger.logAction("ConfigEditor::getFilteredSettings", true, "Displayed filtered settings for " + filename.toStdString());
+        };
+    }, [this, filename](const QString& error) {
+        QString errorMsg = QString("Помилка під час отримання/відображення налаштувань з '%1': %2").arg(filename).arg(error);
+        appendLog(errorMsg);
+        showMessage("Помилка відображення налаштувань", errorMsg, true);
+        m_logger.logAction("ConfigEditor::getFilteredSettings", false, error.toStdString());
+    });
+}
 
-    try {
-        FilteredSettingsMap settings = m_configEditor.getFilteredSettings(configPath);
+void MainWindow::showSettingsTreeDialog(const fs::path& configPath, const std::string& windowTitlePrefix, const FilteredSettingsMap& settings)
+{
+    QDialog *dialog = new QDialog(this);
+    dialog->setAttribute(Qt::WA_DeleteOnClose);
+    dialog->setWindowTitle(QString::fromStdString(windowTitlePrefix) + QString::fromStdWString(configPath.filename().wstring()));
+    dialog->setMinimumSize(600, 500);
+
+    QVBoxLayout *layout = new QVBoxLayout(dialog);
+
+    // Модель належить вікну; рядки й текст створюються лише для видимої частини дерева
+    SettingsTreeModel *model = new SettingsTreeModel(false, dialog);
+    model->setSettings(settings);
+    QTreeView *treeView = new QTreeView(dialog);
+    treeView->setModel(model);
+    treeView->setUniformRowHeights(true);
+    treeView->header()->setStretchLastSection(true);
+    treeView->setAlternatingRowColors(true);
+    treeView->expandAll();
+    treeView->resizeColumnToContents(0);
+
+    // Вікно реєструється для оновлення при зміні файлу на диску (ConfigWatcher)
+    m_liveViews.erase(std::remove_if(m_liveViews.begin(), m_liveViews.end(),
+                                     [](const LiveSettingsView& v) { return v.model.isNull(); }),
+                      m_liveViews.end());
+    m_liveViews.push_back({fs::absolute(configPath).lexically_normal(), model});
+
+    layout->addWidget(treeView);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    QPushButton *xmlButton = new QPushButton("Весь файл (XML)", dialog);
+    connect(xmlButton, &QPushButton::clicked, this, [this, configPath] { displayXmlTreeDialog(configPath); });
+    buttonLayout->addWidget(xmlButton);
+    buttonLayout->addStretch();
+    QPushButton *closeButton = new QPushButton("Закрити", dialog);
+    connect(closeButton, &QPushButton::clicked, dialog, &QDialog::accept);
+    buttonLayout->addWidget(closeButton);
+    layout->addLayout(buttonLayout);
+
+    dialog->setLayout(layout);
+    dialog->show();
+}
 
-        if (settings.empty()) {
-            showMessage("Перегляд налаштувань", "Не знайдено відомих налаштувань у файлі " + filename, true);
-            appendLog("Не знайдено відомих налаштувань у файлі: " + filename);
-            m_logger.logAction("ConfigEditor::getFilteredSettings", false, "No known settings found in " + filename.toStdString());
-            return;
+// Усі елементи файлу, а не лише відомі налаштування (перегляд або розширений режим редагування)
+void MainWindow::displayXmlTreeDialog(const fs::path& configPath, bool editable)
+{
+    QString filename = QString::fromStdWString(configPath.filename().wstring());
+    appendLog(QString(editable ? "Розширений режим редагування: %1" : "Відкриття всього дерева XML: %1").arg(filename));
+
+    // Власний документ (не з DocumentCache): розширений режим змінює його значення під час редагування
+    m_taskRunner.run("Читання XML", configPath, [this, configPath, filename, editable](TaskRunner::Context&) -> TaskRunner::Apply {
+        std::shared_ptr<const ParsedDocument> parsed = DocumentCache::parseFile(configPath);
+        if (!parsed->ok) {
+            throw std::runtime_error("Помилка розбору XML: " + parsed->errorDescription + " (позиція " + std::to_string(parsed->errorOffset) + ")");
         }
-
-        QDialog *dialog = new QDialog(this);
-        dialog->setAttribute(Qt::WA_DeleteOnClose);
-        dialog->setWindowTitle(QString::fromStdString(windowTitlePrefix) + filename);
-        dialog->setMinimumSize(600, 500);
-
-        QVBoxLayout *layout = new QVBoxLayout(dialog);
-
-        QTreeWidget *treeWidget = new QTreeWidget(dialog);
-        treeWidget->setColumnCount(2);
-        treeWidget->setHeaderLabels(QStringList() << "Налаштування" << "Значення");
-        treeWidget->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents);
-        treeWidget->header()->setStretchLastSection(true);
-        treeWidget->setAlternatingRowColors(true);
-
-        std::map<std::string, std::string> nameMap;
-        nameMap["masterVolume"] = "Загальна гучність";
-        nameMap["volume_micVivox"] = "Гучність мікрофону (Vivox)";
-        nameMap["volume_vehicles"] = "Гучність: Техніка";
-        nameMap["volume_music"] = "Гучність: Музика";
-        nameMap["volume_effects"] = "Гучність: Ефекти";
-        nameMap["volume_ambient"] = "Гучність: Оточення";
-        nameMap["volume_gui"] = "Гучність: Інтерфейс";
-        nameMap["volume_voice"] = "Гучність: Голосові повідомлення";
-        nameMap["soundMode"] = "Режим звуку";
-        nameMap["graphicsSettingsVersion"] = "Версія налаштувань графіки";
-        nameMap["COLOR_GRADING_TECHNIQUE"] = "Техніка корекції кольору";
-        nameMap["CUSTOM_AA_MODE"] = "Режим згладжування";
-        nameMap["DECOR_LEVEL"] = "Якість декалей";
-        nameMap["EFFECTS_QUALITY"] = "Якість ефектів";
-        nameMap["FAR_PLANE"] = "Дальність промальовки";
-        nameMap["FLORA_QUALITY"] = "Якість трави";
-        nameMap["HAVOK_ENABLED"] = "Фізика руйнувань Havok";
-        nameMap["HAVOK_QUALITY"] = "Якість фізики Havok";
-        nameMap["LIGHTING_QUALITY"] = "Якість освітлення";
-        nameMap["MOTION_BLUR_QUALITY"] = "Якість розмиття в русі";
-        nameMap["OBJECT_LOD"] = "Деталізація об'єктів";
-        nameMap["POST_PROCESSING_QUALITY"] = "Якість постобробки";
-        nameMap["SEMITRANSPARENT_LEAVES_ENABLED"] = "Прозорість листя";
-        nameMap["SHADOWS_QUALITY"] = "Якість тіней";
-        nameMap["SNIPER_MODE_EFFECTS_QUALITY"] = "Якість ефектів (снайп. режим)";
-        nameMap["SNIPER_MODE_GRASS_ENABLED"] = "Трава в снайп. режимі";
-        nameMap["SNIPER_MODE_SWINGING_ENABLED"] = "Хитання камери (снайп. режим)";
-        nameMap["SPEEDTREE_QUALITY"] = "Якість дерев";
-        nameMap["TERRAIN_QUALITY"] = "Якість ландшафту";
-        nameMap["TERRAIN_TESSELLATION_ENABLED"] = "Теселяція ландшафту";
-        nameMap["TEXTURE_QUALITY"] = "Якість текстур";
-        nameMap["TRACK_PHYSICS_QUALITY"] = "Фізика гусениць";
-        nameMap["VEHICLE_DUST_ENABLED"] = "Пил з-під техніки";
-        nameMap["VEHICLE_TRACES_ENABLED"] = "Сліди техніки";
-        nameMap["WATER_QUALITY"] = "Якість води";
-        nameMap["colorGradingStrength"] = "Сила корекції кольору";
-        nameMap["brightnessDeferred"] = "Яскравість";
-        nameMap["contrastDeferred"] = "Контрастність";
-        nameMap["saturationDeferred"] = "Насиченість";
-        nameMap["windowMode"] = "Режим вікна";
-        nameMap["windowedWidth"] = "Ширина (вікно)";
-        nameMap["windowedHeight"] = "Висота (вікно)";
-        nameMap["fullscreenWidth"] = "Ширина (повний екран)";
-        nameMap["fullscreenHeight"] = "Висота (повний екран)";
-        nameMap["fullscreenRefresh"] = "Частота оновлення";
-        nameMap["aspectRatio"] = "Співвідношення сторін";
-        nameMap["gamma"] = "Гамма";
-        nameMap["tripleBuffering"] = "Потрійна буферизація";
-        std::map<std::string, std::string> modeNamesUKR = {
-            {"strategicMode", "Стратегічний"}, {"artyMode", "Арт-САУ"},
-            {"arcadeMode", "Аркадний"}, {"sniperMode", "Снайперський"},
-            {"freeVideoMode", "Вільна камера"}
+        std::shared_ptr<pugi::xml_document> doc = parsed->doc;
+        return [this, configPath, filename, editable, doc] {
+            XmlTreeDialog *dialog = new XmlTreeDialog(doc, (editable ? "Розширений режим: " : "XML: ") + filename, editable, this);
+            dialog->setAttribute(Qt::WA_DeleteOnClose);
+            if (editable) connectXmlEditor(dialog, configPath, filename);
+            dialog->show();
+            m_logger.logAction(editable ? "MainWindow::AdvancedEdit" : "MainWindow::DisplayXmlTree", true, filename.toStdString());
         };
-        for(const auto& modePair : modeNamesUKR) {
-            std::string modePrefix = modePair.second + ": ";
-            nameMap[modePair.first + "/horzInvert"] = modePrefix + "Інверсія по горизонталі";
-            nameMap[modePair.first + "/vertInvert"] = modePrefix + "Інверсія по вертикалі";
-            nameMap[modePair.first + "/keySensitivity"] = modePrefix + "Чутливість клавіатури";
-            nameMap[modePair.first + "/sensitivity"] = modePrefix + "Чутливість миші";
-            nameMap[modePair.first + "/scrollSensitivity"] = modePrefix + "Чутливість прокрутки";
-        }
+    }, [this, filename, editable](const QString& error) {
+        QString errorMsg = QString("Не вдалося показати XML файлу '%1': %2").arg(filename).arg(error);
+        appendLog(errorMsg);
+        showMessage("Помилка відображення XML", errorMsg, true);
+        m_logger.logAction(editable ? "MainWindow::AdvancedEdit" : "MainWindow::DisplayXmlTree", false, error.toStdString());
+    });
+}
 
-        QFont categoryFont = treeWidget->font();
-        categoryFont.setBold(true);
-        for (const auto& categoryPair : settings) {
-            QTreeWidgetItem *categoryItem = new QTreeWidgetItem(treeWidget);
-            categoryItem->setText(0, QString::fromStdString(categoryPair.first));
-            categoryItem->setFont(0, categoryFont);
-            categoryItem->setExpanded(true);
-
-            for (const auto& settingPair : categoryPair.second) {
-                std::string settingName = settingPair.first;
-                QString displayValue = QString::fromStdString(settingPair.second);
-                QString displayNameToShow = QString::fromStdString(settingName);
-
-                if (nameMap.count(settingName)) {
-                    displayNameToShow = QString::fromStdString(nameMap[settingName]);
-                }
+// Кожне значення, змінене в розширеному режимі, записується окремим завданням (завдання одного файлу
+// виконуються послідовно). Невдалий або скасований запис повертає в дереві попереднє значення.
+void MainWindow::connectXmlEditor(XmlTreeDialog* dialog, const fs::path& configPath, const QString& filename)
+{
+    XmlTreeModel *model = dialog->model();
+    auto editIds = std::make_shared<QHash<quint64, quint64>>(); // Завдання -> редагування моделі
+
+    connect(&m_taskRunner, &TaskRunner::taskFinished, model, [model, editIds](quint64 taskId, const QString&, bool succeeded) {
+        auto it = editIds->find(taskId);
+        if (it == editIds->end()) return;
+        model->finishEdit(it.value(), succeeded);
+        editIds->erase(it);
+    });
+    connect(model, &XmlTreeModel::valueEdited, this,
+            [this, configPath, filename, editIds](quint64 editId, const QString& nodePath, const QString& oldValue, const QString& newValue) {
+        const std::string path = nodePath.toStdString();
+        const std::string expected = oldValue.toStdString();
+        const std::string value = newValue.toStdString();
+        const quint64 taskId = m_taskRunner.run("Збереження вузла", configPath, [this, configPath, filename, path, expected, value](TaskRunner::Context& context) -> TaskRunner::Apply {
+            context.throwIfCancelled();
+            const SettingChange change = m_configEditor.saveNodeValue(configPath, path, expected, value);
+            return [this, configPath, filename, change] {
+                if (change.oldValue == change.newValue) return; // Значення у файлі вже таке
+                appendLog(QString("'%1': %2 = %3 (було %4)").arg(filename, QString::fromStdString(change.key),
+                                                                 QString::fromStdString(change.newValue), QString::fromStdString(change.oldValue)));
+                m_logger.logAction("ConfigEditor::saveNodeValue", true, filename.toStdString() + ", " + change.key);
+                m_logger.logChanges("ConfigEditor::saveNodeValue", configPath, {change});
+            };
+        }, [this, filename](const QString& error) {
+            QString errorMsg = QString("Не вдалося записати значення у файл '%1': %2").arg(filename).arg(error);
+            appendLog(errorMsg);
+            showMessage("Помилка збереження", errorMsg, true);
+            m_logger.logAction("ConfigEditor::saveNodeValue", false, error.toStdString());
+        });
+        editIds->insert(taskId, editId);
+    });
+}
 
-                QTreeWidgetItem *settingItem = new QTreeWidgetItem(categoryItem);
-                settingItem->setText(0, displayNameToShow);
-                settingItem->setText(1, displayValue);
-            }
-        }
+// Валідація у фоні; підтвердження (ValidationPrompt) і продовження - у потоці GUI
+void MainWindow::validateThen(const fs::path& filePath, const std::string& actionName, bool showSuccess,
+                              const std::function<void(bool accepted)>& next)
+{
+    m_taskRunner.run("Валідація", filePath, [this, filePath, actionName, showSuccess, next](TaskRunner::Context&) -> TaskRunner::Apply {
+        const ValidationResult result = m_fileValidator.validateFile(filePath);
+        return [this, filePath, actionName, showSuccess, next, result] {
+            next(m_fileValidator.confirmBeforeAction(filePath, result, actionName, showSuccess));
+        };
+    }, [this, next](const QString& error) {
+        appendLog(QString("Помилка валідації: %1").arg(error));
+        next(false);
+    });
+}
 
-        layout->addWidget(treeWidget);
+fs::path MainWindow::gameConfigPathOrEmpty()
+{
+    try {
+        return m_configManager.getCurrentGameConfigPath();
+    } catch (const std::exception&) {
+        return fs::path(); // Без APPDATA - завдання без черги; сама операція повідомить про помилку
+    }
+}
 
-        QPushButton *closeButton = new QPushButton("Закрити", dialog);
-        connect(closeButton, &QPushButton::clicked, dialog, &QDialog::accept);
-        layout->addWidget(closeButton);
+// --- Стеження за змінами конфігів на диску ---
+void MainWindow::startConfigWatcher()
+{
+    try {
+        m_configWatcher.addFile(m_configManager.getCurrentGameConfigPath());
+    } catch (const std::exception& e) {
+        appendLog(QString("Стеження за конфігом гри недоступне: %1").arg(QString::fromStdString(e.what())));
+    }
+    m_configWatcher.addDirectory("User Configs");
+    m_configWatcher.addDirectory("Saved Configs");
+    try {
+        m_configWatcher.start([this](const std::vector<fs::path>& changedFiles) {
+            // Потік спостерігача: обробка - у потоці GUI
+            QMetaObject::invokeMethod(this, [this, changedFiles] { onConfigFilesChanged(changedFiles); }, Qt::QueuedConnection);
+        });
+    } catch (const std::exception& e) {
+        appendLog(QString("Стеження за змінами конфігів вимкнено: %1").arg(QString::fromStdString(e.what())));
+        m_logger.logAction("ConfigWatcher::start", false, e.what());
+    }
+}
 
-        dialog->setLayout(layout);
-        dialog->show();
+void MainWindow::onConfigFilesChanged(const std::vector<fs::path>& changedFiles)
+{
+    m_liveViews.erase(std::remove_if(m_liveViews.begin(), m_liveViews.end(),
+                                     [](const LiveSettingsView& v) { return v.model.isNull(); }),
+                      m_liveViews.end());
+    fs::path gameConfigPath;
+    try {
+        gameConfigPath = fs::absolute(m_configManager.getCurrentGameConfigPath()).lexically_normal();
+    } catch (const std::exception&) {
+        // Без APPDATA конфіг гри не відстежується
+    }
 
-        appendLog(QString("Відфільтровані налаштування з '%1' відображено.").arg(filename));
-        m_logger.logAction("ConfigEditor::getFilteredSettings", true, "Displayed filtered settings for " + filename.toStdString());
+    for (const fs::path& path : changedFiles) {
+        if (path == gameConfigPath) appendLog("Конфіг гри (preferences.xml) змінено на диску.");
+        const bool shown = std::any_of(m_liveViews.begin(), m_liveViews.end(),
+                                       [&](const LiveSettingsView& v) { return v.path == path; });
+        if (!shown) continue;
+
+        // Розбір - у фоновому потоці; у потоці GUI лише порівняння і оновлення змінених рядків
+        m_taskRunner.run("Оновлення перегляду", path, [this, path](TaskRunner::Context&) -> TaskRunner::Apply {
+            FilteredSettingsMap settings = m_configEditor.getFilteredSettings(path);
+            return [this, path, settings] { applyReloadedSettings(path, settings); };
+        }, [this, path](const QString& error) {
+            appendLog(QString("Не вдалося перечитати '%1': %2").arg(QString::fromStdWString(path.filename().wstring())).arg(error));
+        });
+    }
+}
 
-    } catch (const std::exception& e) {
-        QString errorMsg = QString("Помилка під час отримання/відображення налаштувань з '%1': %2")
-                               .arg(filename).arg(QString::fromStdString(e.what()));
-        appendLog(errorMsg);
-        showMessage("Помилка відображення налаштувань", errorMsg, true);
-        m_logger.logAction("ConfigEditor::getFilteredSettings", false, e.what());
+void MainWindow::applyReloadedSettings(const fs::path& path, const FilteredSettingsMap& settings)
+{
+    const QString filename = QString::fromStdWString(path.filename().wstring());
+    for (LiveSettingsView& view : m_liveViews) {
+        if (view.path != path || view.model.isNull()) continue;
+        const SettingChangeSet changes = ConfigEditor::diffSettings(view.model->settings(), settings);
+        // Той самий набір ключів у тому самому порядку - модель оновлює лише змінені рядки
+        if (!view.model->updateValues(settings)) {
+            view.model->setSettings(settings);
+            appendLog(QString("Файл '%1' змінено на диску: перелік налаштувань оновлено повністю.").arg(filename));
+            continue;
+        }
+        if (changes.empty()) continue;
+        appendLog(QString("Файл '%1' змінено на диску: оновлено налаштувань - %2.").arg(filename).arg(changes.size()));
     }
 }
 
@@ -601,6 +941,43 @@ QString MainWindow::selectBackupFile()
                                         "XML files (*.xml)");
 }
 
+// Список копій зі сховища (найновіші зверху) і пункт для вибору окремого файлу.
+// Повертає false при скасуванні; для окремого файлу заповнюється backupFile.
+bool MainWindow::selectBackup(BackupEntry& backup, QString& backupFile)
+{
+    std::vector<BackupEntry> backups;
+    try {
+        backups = m_backupManager.listBackups();
+    } catch (const std::exception& e) {
+        appendLog(QString("Не вдалося прочитати індекс резервних копій: %1").arg(QString::fromStdString(e.what())));
+        m_logger.logAction("BackupManager::listBackups", false, e.what());
+    }
+    if (backups.empty()) {
+        backupFile = selectBackupFile();
+        return !backupFile.isEmpty();
+    }
+
+    QStringList items;
+    for (auto it = backups.rbegin(); it != backups.rend(); ++it) {
+        items << QString("%1 - %2 (%3 КБ)")
+                     .arg(QDateTime::fromSecsSinceEpoch(it->timestamp).toString("yyyy-MM-dd hh:mm:ss"))
+                     .arg(QString::fromStdString(it->name))
+                     .arg(static_cast<double>(it->size) / 1024.0, 0, 'f', 1);
+    }
+    const QString otherFileItem = "Інший файл...";
+    items << otherFileItem;
+
+    bool ok = false;
+    QString choice = QInputDialog::getItem(this, "Відновлення з копії", "Виберіть резервну копію:", items, 0, false, &ok);
+    if (!ok) return false;
+    if (choice == otherFileItem) {
+        backupFile = selectBackupFile();
+        return !backupFile.isEmpty();
+    }
+    backup = backups[backups.size() - 1 - static_cast<std::size_t>(items.indexOf(choice))];
+    return true;
+}
+
 QString MainWindow::selectUserConfigFile()
 {
     fs::path userDir = "User Configs";
@@ -611,12 +988,12 @@ QString MainWindow::selectUserConfigFile()
                                         "XML files (*.xml)");
 }
 
-QString MainWindow::selectFileToValidate()
+QStringList MainWindow::selectFilesToValidate()
 {
-    return QFileDialog::getOpenFileName(this,
-                                        "Виберіть файл для валідації",
-                                        ".", // Поточна директорія як початкова
-                                        "XML files (*.xml);;All files (*)");
+    return QFileDialog::getOpenFileNames(this,
+                                         "Виберіть файл(и) для валідації",
+                                         ".", // Поточна директорія як початкова
+                                         "XML files (*.xml);;All files (*)");
 }
 
 // Допоміжні функції для відображення результатів валідації (без змін)
@@ -660,3 +1037,43 @@ void MainWindow::displayValidationResult(const ValidationResult& result, const Q
     if (!result.isWellFormed) msgBox.setIcon(QMessageBox::Critical);
     msgBox.exec();
 }
+
+void MainWindow::displayBatchValidationReport(const BatchValidationReport& report)
+{
+    const double filesPerSecond = report.elapsedSeconds > 0.0 ? report.results.size() / report.elapsedSeconds : 0.0;
+    QString details = QString("Перевірено файлів: %1 (потоків: %2, %3 с, %4 файлів/с)\n"
+                              "OK: %5\nЗ попередженнями: %6\nНекоректні: %7\n")
+                          .arg(report.results.size())
+                          .arg(report.threadCount)
+                          .arg(report.elapsedSeconds, 0, 'f', 3)
+                          .arg(filesPerSecond, 0, 'f', 0)
+                          .arg(report.validCount)
+                          .arg(report.warningCount)
+                          .arg(report.invalidCount);
+
+    // Деталізуємо лише проблемні файли, щоб звіт лишався читабельним для великих тек
+    int shown = 0;
+    const int maxShown = 10;
+    for (const auto& entry : report.results) {
+        if (!entry.second.isValid() || entry.second.hasWarnings()) {
+            if (shown == 0) details += "\nПроблемні файли:\n";
+            if (++shown > maxShown) {
+                details += "- ...\n";
+                break;
+            }
+            details += QString("- %1: %2\n")
+                           .arg(QString::fromStdWString(entry.first.filename().wstring()))
+                           .arg(formatValidationSummary(entry.second));
+        }
+    }
+    appendLog(QString("Пакетна валідація завершена. OK: %1, з попередженнями: %2, некоректні: %3.")
+                  .arg(report.validCount).arg(report.warningCount).arg(report.invalidCount));
+
+    QMessageBox msgBox;
+    msgBox.setWindowTitle("Результат пакетної валідації");
+    msgBox.setText(details);
+    msgBox.setTextInteractionFlags(Qt::TextSelectableByMouse);
+    msgBox.setIcon(report.invalidCount > 0 ? QMessageBox::Critical
+                   : (report.warningCount > 0 ? QMessageBox::Warning : QMessageBox::Information));
+    msgBox.exec();
+}
@@ -2,6 +2,9 @@
 #define MAINWINDOW_H
 
 #include <QMainWindow>
+#include <QPointer>
+#include "taskrunner.h"
+#include "settingstreemodel.h"
 #include "configeditdialog.h"
 // НЕ включаємо helpdialog.h тут, щоб уникнути потенційних циклічних залежностей,lol
 // включив його в mainwindow.cpp
@@ -18,17 +21,27 @@ class QVBoxLayout;
 class QPlainTextEdit;
 class QPushButton;
 class QFontDatabase;
-class QTreeWidget;
-class QTreeWidgetItem;
+class QTreeView;
 class QHeaderView;
+class QLabel;
+class QProgressBar;
 class QStackedWidget;
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
+class XmlTreeDialog;
 
 #include "main.h"
 #include <filesystem>
 namespace fs = std::filesystem;
 
+// Підтвердження валідації через QMessageBox (FileValidatorDialogs.cpp); встановлюється в main()
+class MessageBoxValidationPrompt : public ValidationPrompt {
+public:
+    bool confirmWarnings(const fs::path& filePath, const std::string& actionName, const std::string& summary) override;
+    void reportSuccess(const fs::path& filePath, const std::string& actionName) override;
+    void reportFailure(const fs::path& filePath, const std::string& actionName, const std::string& error) override;
+};
+
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
@@ -66,6 +79,27 @@ private:
     FileValidator m_fileValidator;
     ProfileManager m_profileManager;
 
+    // Стеження за конфігом гри і папками конфігів: відкриті вікна перегляду оновлюються без повторного відкриття
+    struct LiveSettingsView {
+        fs::path path; // Абсолютний, як у подіях ConfigWatcher
+        QPointer<SettingsTreeModel> model; // Належить вікну перегляду; містить останній показаний стан
+    };
+    ConfigWatcher m_configWatcher;
+    std::vector<LiveSettingsView> m_liveViews;
+
+    // Фонові операції з файлами (розбір, валідація, копіювання, запис); по черзі для одного файлу
+    TaskRunner m_taskRunner;
+    QLabel *m_taskLabel = nullptr;
+    QProgressBar *m_taskProgress = nullptr;
+    QPushButton *m_cancelTasksButton = nullptr;
+    void setupTaskStatus();
+    // Валідація у фоні, потім підтвердження через ValidationPrompt; next(true) - можна продовжувати
+    void validateThen(const fs::path& filePath, const std::string& actionName, bool showSuccess,
+                      const std::function<void(bool accepted)>& next);
+    fs::path gameConfigPathOrEmpty();
+    void applyUserConfig(const fs::path& sourcePath, const QString& filename);
+    void saveConfigChanges(const fs::path& configPath, const QString& filename, const SettingChangeSet& changes);
+
     // Допоміжні функції UI
     void showMessage(const QString& title, const QString& text, bool isWarning = false);
     void appendLog(const QString& message);
@@ -75,15 +109,26 @@ private:
 
     // Допоміжні функції для вибору файлів
     QString selectBackupFile();
+    bool selectBackup(BackupEntry& backup, QString& backupFile);
     QString selectUserConfigFile();
-    QString selectFileToValidate();
+    QStringList selectFilesToValidate();
 
     // Допоміжні функції для відображення результатів валідації
     void displayValidationResult(const ValidationResult& result, const QString& filename);
     QString formatValidationSummary(const ValidationResult& result);
+    void displayBatchValidationReport(const BatchValidationReport& report);
 
     // Функція для відображення налаштувань
     void displaySettingsInTreeDialog(const fs::path& configPath, const std::string& windowTitlePrefix);
+    void showSettingsTreeDialog(const fs::path& configPath, const std::string& windowTitlePrefix, const FilteredSettingsMap& settings);
+    // editable - розширений режим: редагування всього документа з записом кожного зміненого вузла
+    void displayXmlTreeDialog(const fs::path& configPath, bool editable = false);
+    void connectXmlEditor(XmlTreeDialog* dialog, const fs::path& configPath, const QString& filename);
+
+    // Зміни файлів на диску (ConfigWatcher)
+    void startConfigWatcher();
+    void onConfigFilesChanged(const std::vector<fs::path>& changedFiles);
+    void applyReloadedSettings(const fs::path& path, const FilteredSettingsMap& settings);
 
 };
 #endif // MAINWINDOW_H
@@ -1,5 +1,5 @@
 #include "settingdelegate.h"
-#include "main.h" // Для SettingRule
+#include "main.h" // Для SettingRule та SettingSchema
 
 #include <QLineEdit>
 #include <QSpinBox>
@@ -10,12 +10,9 @@
 #include <string>
 #include <QLocale> // Для QLocale::c() та системної локалі
 
-SettingDelegate::SettingDelegate(const SettingRulesMap* rules, QObject *parent)
-    : QStyledItemDelegate(parent), m_rules(rules)
+SettingDelegate::SettingDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
 {
-    if (!m_rules) {
-        qWarning() << "SettingDelegate: Warning - Rules map provided is null!";
-    }
 }
 
 // --- Створення редактора ---
@@ -23,7 +20,7 @@ QWidget *SettingDelegate::createEditor(QWidget *parent, const QStyleOptionViewIt
                                        const QModelIndex &index) const
 {
     Q_UNUSED(option);
-    if (index.column() != 1 || !m_rules) { return nullptr; }
+    if (index.column() != 1) { return nullptr; }
 
     QString settingNameQ = index.siblingAtColumn(0).data(Qt::UserRole).toString();
     if (settingNameQ.isEmpty()) {
@@ -33,9 +30,8 @@ QWidget *SettingDelegate::createEditor(QWidget *parent, const QStyleOptionViewIt
     std::string settingName = settingNameQ.toStdString();
 
     SettingRule rule;
-    auto it = m_rules->find(settingName);
-    if (it != m_rules->end()) {
-        rule = it->second;
+    if (const SettingRule* schemaRule = SettingSchema::rule(settingName)) {
+        rule = *schemaRule;
     } else {
         qWarning() << "SettingDelegate::createEditor: No rule found for setting" << settingNameQ << ". Treating as STRING.";
         rule.type = SettingType::STRING;
@@ -138,7 +134,7 @@ void SettingDelegate::setModelData(QWidget *editor, QAbstractItemModel *model, c
     QString settingNameQ = index.siblingAtColumn(0).data(Qt::UserRole).toString();
     std::string settingName = settingNameQ.toStdString();
     SettingRule rule;
-    if(m_rules){ auto it = m_rules->find(settingName); if(it != m_rules->end()) rule = it->second; }
+    if (const SettingRule* schemaRule = SettingSchema::rule(settingName)) rule = *schemaRule;
 
 
     if (QComboBox *comboBox = qobject_cast<QComboBox*>(editor)) {
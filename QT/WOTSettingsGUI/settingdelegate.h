@@ -2,11 +2,8 @@
 #define SETTINGDELEGATE_H
 
 #include <QStyledItemDelegate>
-#include <map>
 #include <string>
-#include "main.h" // Для SettingRule
-
-using SettingRulesMap = std::map<std::string, SettingRule>;
+#include "main.h" // Для SettingRule та SettingSchema
 
 QT_BEGIN_NAMESPACE
 class QWidget;
@@ -21,7 +18,8 @@ class SettingDelegate : public QStyledItemDelegate
     Q_OBJECT
 
 public:
-    explicit SettingDelegate(const SettingRulesMap* rules, QObject *parent = nullptr);
+    // Правила редакторів беруться зі спільної SettingSchema
+    explicit SettingDelegate(QObject *parent = nullptr);
 
     QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &option,
                           const QModelIndex &index) const override;
@@ -33,9 +31,6 @@ public:
 
     void updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option,
                               const QModelIndex &index) const override;
-
-private:
-    const SettingRulesMap* m_rules;
 };
 
 #endif // SETTINGDELEGATE_H
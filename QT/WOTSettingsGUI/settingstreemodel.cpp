@@ -0,0 +1,190 @@
+#include "settingstreemodel.h"
+#include <QBrush>
+#include <QFont>
+#include <algorithm>
+
+// internalId: 0 - рядок категорії, n > 0 - налаштування категорії n - 1
+
+SettingsTreeModel::SettingsTreeModel(bool editable, QObject *parent)
+    : QAbstractItemModel(parent), m_editable(editable)
+{
+}
+
+void SettingsTreeModel::setSettings(const FilteredSettingsMap& settings)
+{
+    TraceScope trace("SettingsTreeModel::setSettings");
+    beginResetModel();
+    m_settings = settings;
+    m_categories.clear();
+    m_categories.reserve(m_settings.size());
+    for (Category& category : m_settings) m_categories.push_back(&category);
+    m_invalid.clear();
+    endResetModel();
+}
+
+bool SettingsTreeModel::updateValues(const FilteredSettingsMap& settings)
+{
+    const bool sameLayout = std::equal(m_settings.begin(), m_settings.end(), settings.begin(), settings.end(),
+                                       [](const Category& a, const Category& b) {
+        return a.first == b.first &&
+               std::equal(a.second.begin(), a.second.end(), b.second.begin(), b.second.end(),
+                          [](const Setting& x, const Setting& y) { return x.first == y.first; });
+    });
+    if (!sameLayout) return false;
+
+    auto incoming = settings.begin();
+    for (int categoryRow = 0; categoryRow < static_cast<int>(m_categories.size()); ++categoryRow, ++incoming) {
+        std::vector<Setting>& rows = m_categories[categoryRow]->second;
+        for (std::size_t row = 0; row < rows.size(); ++row) {
+            const std::string& newValue = incoming->second[row].second;
+            if (rows[row].second == newValue) continue;
+            rows[row].second = newValue;
+            const QModelIndex changed = createIndex(static_cast<int>(row), 1, quintptr(categoryRow + 1));
+            emit dataChanged(changed, changed);
+        }
+    }
+    return true;
+}
+
+const SettingsTreeModel::Setting& SettingsTreeModel::setting(const QModelIndex& index) const
+{
+    return m_categories[index.internalId() - 1]->second[index.row()];
+}
+
+const std::string& SettingsTreeModel::key(const QModelIndex& index) const
+{
+    return setting(index).first;
+}
+
+const std::string& SettingsTreeModel::value(const QModelIndex& index) const
+{
+    return setting(index).second;
+}
+
+void SettingsTreeModel::setInvalid(const QModelIndex& index, bool invalid)
+{
+    if (!isSetting(index)) return;
+    const std::pair<int, int> position(static_cast<int>(index.internalId() - 1), index.row());
+    const bool changed = invalid ? m_invalid.insert(position).second : m_invalid.erase(position) > 0;
+    if (changed) {
+        const QModelIndex valueIndex = index.siblingAtColumn(1);
+        emit dataChanged(valueIndex, valueIndex, {Qt::BackgroundRole});
+    }
+}
+
+bool SettingsTreeModel::isEditableSetting(const std::string& key) const
+{
+    if (!m_editable) return false;
+    const SettingRule* rule = SettingSchema::rule(key);
+    return !rule || rule->type != SettingType::NON_EDITABLE;
+}
+
+QModelIndex SettingsTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (row < 0 || column < 0 || column >= 2) return QModelIndex();
+    if (!parent.isValid()) {
+        return row < static_cast<int>(m_categories.size()) ? createIndex(row, column, quintptr(0)) : QModelIndex();
+    }
+    if (isSetting(parent) || parent.column() != 0) return QModelIndex();
+    if (row >= static_cast<int>(m_categories[parent.row()]->second.size())) return QModelIndex();
+    return createIndex(row, column, quintptr(parent.row() + 1));
+}
+
+QModelIndex SettingsTreeModel::parent(const QModelIndex &index) const
+{
+    if (!isSetting(index)) return QModelIndex();
+    return createIndex(static_cast<int>(index.internalId() - 1), 0, quintptr(0));
+}
+
+int SettingsTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid()) return static_cast<int>(m_categories.size());
+    if (isSetting(parent) || parent.column() != 0) return 0;
+    return static_cast<int>(m_categories[parent.row()]->second.size());
+}
+
+int SettingsTreeModel::columnCount(const QModelIndex &) const
+{
+    return 2;
+}
+
+QVariant SettingsTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+
+    if (!isSetting(index)) {
+        if (index.column() != 0) return QVariant();
+        if (role == Qt::DisplayRole) return QString::fromStdString(m_categories[index.row()]->first);
+        if (role == Qt::FontRole) {
+            QFont categoryFont;
+            categoryFont.setBold(true);
+            return categoryFont;
+        }
+        return QVariant();
+    }
+
+    const Setting& item = setting(index);
+    if (index.column() == 0) {
+        if (role == Qt::UserRole) return QString::fromStdString(item.first);
+        if (role == Qt::DisplayRole) {
+            // Назви ті самі, що й у редакторі (спільна SettingSchema)
+            const char* schemaName = SettingSchema::displayName(item.first);
+            return schemaName ? QString::fromUtf8(schemaName) : QString::fromStdString(item.first);
+        }
+        return QVariant();
+    }
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return QString::fromStdString(item.second);
+    case Qt::ForegroundRole:
+        if (m_editable && !isEditableSetting(item.first)) return QBrush(Qt::gray);
+        return QVariant();
+    case Qt::BackgroundRole:
+        if (m_invalid.count({static_cast<int>(index.internalId() - 1), index.row()})) return QBrush(Qt::red);
+        return QVariant();
+    case Qt::ToolTipRole:
+        if (!m_editable) return QVariant();
+        return valueToolTip(SettingSchema::rule(item.first));
+    default:
+        return QVariant();
+    }
+}
+
+QString SettingsTreeModel::valueToolTip(const SettingRule* rule)
+{
+    if (!rule) return QString("Рядкове значення (правило не визначено)");
+    switch (rule->type) {
+    case SettingType::NON_EDITABLE: return QString("Це значення не редагується");
+    case SettingType::INT: return QString("Ціле число від %1 до %2").arg(static_cast<int>(rule->minValue)).arg(static_cast<int>(rule->maxValue));
+    case SettingType::FLOAT: return QString("Число від %L1 до %L2 (%3 зн.)").arg(rule->minValue, 0, 'f', rule->decimals).arg(rule->maxValue, 0, 'f', rule->decimals).arg(rule->decimals);
+    case SettingType::BOOL_TF: return QString("Виберіть true або false");
+    case SettingType::BOOL_01: return QString("Виберіть 1 (увімк.) або 0 (вимк.)");
+    default: return QString("Рядкове значення");
+    }
+}
+
+bool SettingsTreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != Qt::EditRole || !isSetting(index) || index.column() != 1) return false;
+    Setting& item = m_categories[index.internalId() - 1]->second[index.row()];
+    if (!isEditableSetting(item.first)) return false;
+    item.second = value.toString().toStdString();
+    emit dataChanged(index, index);
+    return true;
+}
+
+Qt::ItemFlags SettingsTreeModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    Qt::ItemFlags result = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (isSetting(index) && index.column() == 1 && isEditableSetting(setting(index).first)) result |= Qt::ItemIsEditable;
+    return result;
+}
+
+QVariant SettingsTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+    return section == 0 ? QString("Налаштування") : QString("Значення");
+}
@@ -0,0 +1,60 @@
+#ifndef SETTINGSTREEMODEL_H
+#define SETTINGSTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "main.h" // Для FilteredSettingsMap і SettingSchema
+
+// Модель "категорія -> налаштування" над FilteredSettingsMap для QTreeView (перегляд і редактор).
+// Елементи не створюються: рядок - це пара (категорія, номер), закодована в internalId індексу,
+// а текст, назви і підказки зі SettingSchema перетворюються в QString лише для видимих рядків.
+// Колонка 0: назва (Qt::UserRole - ключ налаштування для SettingDelegate), колонка 1: значення.
+class SettingsTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    // editable - значення з правилом, відмінним від NON_EDITABLE, редагуються в колонці 1
+    explicit SettingsTreeModel(bool editable, QObject *parent = nullptr);
+
+    void setSettings(const FilteredSettingsMap& settings); // Повна перебудова (reset)
+    // Ті самі категорії й ключі в тому самому порядку: оновлює лише змінені значення (dataChanged
+    // для їхніх рядків) і повертає true. Інакше нічого не змінює і повертає false.
+    bool updateValues(const FilteredSettingsMap& settings);
+    const FilteredSettingsMap& settings() const { return m_settings; }
+
+    bool isSetting(const QModelIndex& index) const { return index.isValid() && index.internalId() != 0; }
+    const std::string& key(const QModelIndex& index) const;   // Лише для рядків налаштувань
+    const std::string& value(const QModelIndex& index) const;
+    // Підсвічування неприпустимого значення (фінальна перевірка редактора)
+    void setInvalid(const QModelIndex& index, bool invalid);
+    // Підказка до значення за правилом (nullptr - правила немає); спільна з XmlTreeModel
+    static QString valueToolTip(const SettingRule* rule);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &index) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    using Category = FilteredSettingsMap::value_type;
+    using Setting = std::pair<std::string, std::string>;
+
+    const Setting& setting(const QModelIndex& index) const;
+    bool isEditableSetting(const std::string& key) const;
+
+    bool m_editable;
+    FilteredSettingsMap m_settings;
+    std::vector<Category*> m_categories; // Рядок верхнього рівня -> категорія (вузли std::map стабільні)
+    std::set<std::pair<int, int>> m_invalid; // (категорія, рядок)
+};
+
+#endif // SETTINGSTREEMODEL_H
@@ -0,0 +1,120 @@
+#include "taskrunner.h"
+#include <QMetaObject>
+#include <exception>
+#include <utility>
+
+struct TaskRunner::Task {
+    quint64 id = 0;
+    QString name;
+    QString key; // Нормалізований шлях файлу; порожній - завдання без черги
+    Work work;
+    ErrorHandler onError;
+    std::shared_ptr<std::atomic<bool>> cancelled = std::make_shared<std::atomic<bool>>(false);
+};
+
+void TaskRunner::Context::reportProgress(int percent, const QString& text) const
+{
+    TaskRunner* runner = m_runner;
+    const quint64 id = m_id;
+    QMetaObject::invokeMethod(runner, [runner, id, percent, text] {
+        if (runner->m_tasks.contains(id)) emit runner->taskProgress(id, percent, text);
+    }, Qt::QueuedConnection);
+}
+
+TaskRunner::TaskRunner(QObject *parent)
+    : QObject(parent)
+{
+}
+
+TaskRunner::~TaskRunner()
+{
+    shutdown();
+}
+
+quint64 TaskRunner::run(const QString& name, const fs::path& file, Work work, ErrorHandler onError)
+{
+    auto task = std::make_shared<Task>();
+    task->id = m_nextId++;
+    task->name = name;
+    if (!file.empty()) task->key = QString::fromStdWString(fs::absolute(file).lexically_normal().wstring());
+    task->work = std::move(work);
+    task->onError = std::move(onError);
+    m_tasks.insert(task->id, task);
+
+    if (task->key.isEmpty()) {
+        startTask(task);
+    } else {
+        std::deque<std::shared_ptr<Task>>& queue = m_queues[task->key];
+        queue.push_back(task);
+        if (queue.size() == 1) startTask(task); // Інакше стартує, коли завершиться попереднє з цим файлом
+    }
+    return task->id;
+}
+
+void TaskRunner::startTask(const std::shared_ptr<Task>& task)
+{
+    emit taskStarted(task->id, task->name);
+    m_pool.start([this, task] {
+        Context context;
+        context.m_runner = this;
+        context.m_id = task->id;
+        context.m_cancelled = task->cancelled;
+        Apply apply;
+        QString error;
+        bool cancelled = task->cancelled->load();
+        if (!cancelled) {
+            try {
+                apply = task->work(context);
+            } catch (const Cancelled&) {
+                cancelled = true;
+            } catch (const std::exception& e) {
+                error = QString::fromStdString(e.what());
+            } catch (...) {
+                error = "Невідома помилка фонового завдання.";
+            }
+        }
+        QMetaObject::invokeMethod(this, [this, task, apply, error, cancelled] { finishTask(task, apply, error, cancelled); },
+                                  Qt::QueuedConnection);
+    });
+}
+
+void TaskRunner::finishTask(const std::shared_ptr<Task>& task, const Apply& apply, const QString& error, bool cancelled)
+{
+    m_tasks.remove(task->id);
+    // Завдання завершується до застосування результату: воно може показати діалог або запустити наступне завдання
+    if (!task->key.isEmpty()) {
+        auto queue = m_queues.find(task->key);
+        if (queue != m_queues.end()) {
+            queue->pop_front();
+            if (queue->empty()) m_queues.erase(queue);
+            else startTask(queue->front());
+        }
+    }
+
+    emit taskFinished(task->id, task->name, !cancelled && error.isEmpty());
+    if (m_tasks.isEmpty()) emit allTasksFinished();
+
+    if (cancelled) return; // Результат скасованого завдання відкидається
+    if (!error.isEmpty()) {
+        if (task->onError) task->onError(error);
+    } else if (apply) {
+        apply();
+    }
+}
+
+void TaskRunner::cancel(quint64 id)
+{
+    auto it = m_tasks.find(id);
+    if (it != m_tasks.end()) (*it)->cancelled->store(true);
+}
+
+void TaskRunner::cancelAll()
+{
+    for (const std::shared_ptr<Task>& task : std::as_const(m_tasks)) task->cancelled->store(true);
+}
+
+void TaskRunner::shutdown()
+{
+    cancelAll();
+    m_pool.waitForDone();
+}
@@ -0,0 +1,72 @@
+#ifndef TASKRUNNER_H
+#define TASKRUNNER_H
+
+#include <QObject>
+#include <QHash>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include "main.h"
+
+// Фонові завдання вікон: виклики бекенду (розбір, валідація, копіювання, запис) виконуються в пулі
+// потоків, а їхній результат застосовується в потоці GUI. Завдання з однаковим файлом виконуються
+// строго по черзі в порядку запуску, з різними - паралельно. Скасування кооперативне: завдання
+// викликає throwIfCancelled() між кроками (до запису - щоб не лишити файл напівзміненим). Завдання,
+// скасоване до старту або на такій перевірці, не застосовує результату; завершене - застосовує.
+class TaskRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Cancelled {}; // Кидає throwIfCancelled()
+
+    // Доступ завдання до стану з фонового потоку
+    class Context {
+    public:
+        bool isCancelled() const { return m_cancelled->load(); }
+        void throwIfCancelled() const { if (isCancelled()) throw Cancelled(); }
+        // percent - 0..100 або -1 (тривалість невідома); надходить сигналом taskProgress у потоці GUI
+        void reportProgress(int percent, const QString& text = QString()) const;
+    private:
+        friend class TaskRunner;
+        TaskRunner* m_runner = nullptr;
+        quint64 m_id = 0;
+        std::shared_ptr<std::atomic<bool>> m_cancelled;
+    };
+    using Apply = std::function<void()>;          // Виконується в потоці GUI (може бути порожньою)
+    using Work = std::function<Apply(Context&)>;  // Виконується у фоновому потоці; винятки - помилка завдання
+    using ErrorHandler = std::function<void(const QString& error)>;
+
+    explicit TaskRunner(QObject *parent = nullptr);
+    ~TaskRunner() override;
+
+    // file - файл, який завдання читає або змінює (порожній - без черги). Повертає id завдання.
+    quint64 run(const QString& name, const fs::path& file, Work work, ErrorHandler onError = nullptr);
+    void cancel(quint64 id);
+    void cancelAll();
+    // Скасовує все і чекає завершення фонових викликів (перед руйнуванням того, до чого вони звертаються)
+    void shutdown();
+    int activeCount() const { return static_cast<int>(m_tasks.size()); }
+
+signals:
+    void taskStarted(quint64 id, const QString& name);
+    void taskProgress(quint64 id, int percent, const QString& text);
+    void taskFinished(quint64 id, const QString& name, bool succeeded); // Також для скасованих (succeeded = false)
+    void allTasksFinished();
+
+private:
+    struct Task;
+    void startTask(const std::shared_ptr<Task>& task);
+    void finishTask(const std::shared_ptr<Task>& task, const Apply& apply, const QString& error, bool cancelled);
+
+    QThreadPool m_pool;
+    QHash<QString, std::deque<std::shared_ptr<Task>>> m_queues; // Файл -> черга (перше завдання виконується)
+    QHash<quint64, std::shared_ptr<Task>> m_tasks;               // Заплановані й виконувані
+    quint64 m_nextId = 1;
+};
+
+#endif // TASKRUNNER_H
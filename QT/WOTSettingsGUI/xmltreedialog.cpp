@@ -0,0 +1,67 @@
+#include "xmltreedialog.h"
+#include "xmltreemodel.h"
+#include "settingdelegate.h"
+
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QTreeView>
+#include <QVBoxLayout>
+
+XmlTreeDialog::XmlTreeDialog(std::shared_ptr<pugi::xml_document> doc, const QString& title, bool editable,
+                             QWidget *parent)
+    : QDialog(parent)
+{
+    setWindowTitle(title);
+    setMinimumSize(700, 550);
+    QVBoxLayout *layout = new QVBoxLayout(this);
+
+    m_model = new XmlTreeModel(std::move(doc), this);
+    m_model->setEditable(editable);
+    m_model->fetchMore(QModelIndex()); // <root>
+
+    // Однакова висота рядків: прокрутка і розгортання не вимірюють рядки поза екраном
+    m_view = new QTreeView(this);
+    m_view->setModel(m_model);
+    m_view->setUniformRowHeights(true);
+    m_view->header()->setStretchLastSection(true);
+    m_view->setAlternatingRowColors(true);
+    m_view->setColumnWidth(0, 300);
+    m_view->expand(m_model->index(0, 0));
+    connect(m_view->verticalScrollBar(), &QScrollBar::valueChanged, this, &XmlTreeDialog::fetchVisible);
+    connect(m_view, &QTreeView::expanded, this, &XmlTreeDialog::fetchVisible);
+    layout->addWidget(m_view);
+
+    if (editable) {
+        m_view->setItemDelegateForColumn(1, new SettingDelegate(this));
+        m_view->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
+        connect(m_model, &XmlTreeModel::editRejected, this, [this](const QString& error) {
+            QMessageBox::warning(this, "Неприпустиме значення", error);
+        });
+        QLabel *hint = new QLabel("Кожне змінене значення одразу записується у файл (лише цей вузол). "
+                                  "Значення з правилами перевіряються так само, як у редакторі; "
+                                  "курсивом позначено значення, що ще записуються.", this);
+        hint->setWordWrap(true);
+        layout->addWidget(hint);
+    }
+
+    QPushButton *closeButton = new QPushButton("Закрити", this);
+    connect(closeButton, &QPushButton::clicked, this, &QDialog::accept);
+    layout->addWidget(closeButton);
+}
+
+void XmlTreeDialog::fetchVisible()
+{
+    QModelIndex index = m_view->indexAt(QPoint(0, m_view->viewport()->height() - 1));
+    // Порцію потребує найближчий предок, у якого видимий рядок - останній завантажений
+    for (; index.isValid(); index = index.parent()) {
+        const QModelIndex parent = index.parent();
+        if (index.row() < m_model->rowCount(parent) - 1) return; // Далі ще є завантажені рядки
+        if (m_model->canFetchMore(parent)) {
+            m_model->fetchMore(parent);
+            return;
+        }
+    }
+}
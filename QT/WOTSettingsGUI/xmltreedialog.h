@@ -0,0 +1,36 @@
+#ifndef XMLTREEDIALOG_H
+#define XMLTREEDIALOG_H
+
+#include <QDialog>
+#include <memory>
+
+namespace pugi { class xml_document; }
+
+QT_BEGIN_NAMESPACE
+class QTreeView;
+QT_END_NAMESPACE
+class XmlTreeModel;
+
+// Вікно з усім деревом XML файлу (XmlTreeModel). Документ належить вікну.
+// editable - розширений режим: значення елементів редагуються (SettingDelegate), а запис
+// кожного зміненого вузла у файл виконує власник за сигналом моделі valueEdited.
+class XmlTreeDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+    XmlTreeDialog(std::shared_ptr<pugi::xml_document> doc, const QString& title, bool editable = false,
+                  QWidget *parent = nullptr);
+
+    XmlTreeModel* model() const { return m_model; }
+
+private:
+    // QTreeView сам довантажує лише верхній рівень; для вкладених вузлів наступна порція
+    // дочірніх елементів запитується, коли прокрутка доходить до останнього завантаженого
+    void fetchVisible();
+
+    XmlTreeModel *m_model;
+    QTreeView *m_view;
+};
+
+#endif // XMLTREEDIALOG_H
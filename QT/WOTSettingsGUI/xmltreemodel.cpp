@@ -0,0 +1,217 @@
+#include "xmltreemodel.h"
+#include "settingstreemodel.h"
+#include <QFont>
+#include <QString>
+#include <string_view>
+
+namespace {
+
+constexpr int kFetchBatch = 256; // Дочірніх елементів за один fetchMore
+
+QString trimmedText(const char* text) {
+    const std::string_view v = XmlUtil::trimmed(text);
+    return QString::fromUtf8(v.data(), static_cast<int>(v.size()));
+}
+
+}
+
+XmlTreeModel::XmlTreeModel(std::shared_ptr<pugi::xml_document> doc, QObject *parent)
+    : QAbstractItemModel(parent), m_doc(std::move(doc)), m_root(std::make_unique<Item>())
+{
+    m_root->node = *m_doc;
+    m_root->next = XmlUtil::firstElement(m_root->node);
+}
+
+XmlTreeModel::~XmlTreeModel() = default;
+
+XmlTreeModel::Item* XmlTreeModel::item(const QModelIndex& index) const
+{
+    return index.isValid() ? static_cast<Item*>(index.internalPointer()) : m_root.get();
+}
+
+pugi::xml_node XmlTreeModel::node(const QModelIndex& index) const
+{
+    return item(index)->node;
+}
+
+QModelIndex XmlTreeModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (column < 0 || column >= 2 || (parent.isValid() && parent.column() != 0)) return QModelIndex();
+    const Item* parentItem = item(parent);
+    if (row < 0 || row >= static_cast<int>(parentItem->children.size())) return QModelIndex();
+    return createIndex(row, column, parentItem->children[row].get());
+}
+
+QModelIndex XmlTreeModel::parent(const QModelIndex &index) const
+{
+    if (!index.isValid()) return QModelIndex();
+    Item* parentItem = item(index)->parent;
+    if (!parentItem || parentItem == m_root.get()) return QModelIndex();
+    return createIndex(parentItem->row, 0, parentItem);
+}
+
+int XmlTreeModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() && parent.column() != 0) return 0;
+    return static_cast<int>(item(parent)->children.size()); // Лише вже додані fetchMore
+}
+
+int XmlTreeModel::columnCount(const QModelIndex &) const
+{
+    return 2;
+}
+
+bool XmlTreeModel::hasChildren(const QModelIndex &parent) const
+{
+    if (parent.isValid() && parent.column() != 0) return false;
+    const Item* parentItem = item(parent);
+    return !parentItem->children.empty() || parentItem->next;
+}
+
+bool XmlTreeModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid() && parent.column() != 0) return false;
+    return static_cast<bool>(item(parent)->next);
+}
+
+void XmlTreeModel::fetchMore(const QModelIndex &parent)
+{
+    Item* parentItem = item(parent);
+    if (!parentItem->next) return;
+
+    std::vector<pugi::xml_node> batch;
+    batch.reserve(kFetchBatch);
+    pugi::xml_node next = parentItem->next;
+    for (; next && static_cast<int>(batch.size()) < kFetchBatch; next = XmlUtil::nextElement(next)) batch.push_back(next);
+
+    const int first = static_cast<int>(parentItem->children.size());
+    beginInsertRows(parent, first, first + static_cast<int>(batch.size()) - 1);
+    parentItem->children.reserve(parentItem->children.size() + batch.size());
+    for (const pugi::xml_node& child : batch) {
+        auto childItem = std::make_unique<Item>();
+        childItem->node = child;
+        childItem->parent = parentItem;
+        childItem->row = static_cast<int>(parentItem->children.size());
+        childItem->next = XmlUtil::firstElement(child);
+        parentItem->children.push_back(std::move(childItem));
+    }
+    parentItem->next = next;
+    endInsertRows();
+}
+
+const SettingSpec* XmlTreeModel::spec(const Item* current) const
+{
+    if (!current->specResolved) {
+        current->spec = ConfigEditor::nodeSpec(current->node, current->key);
+        current->specResolved = true;
+    }
+    return current->spec;
+}
+
+QVariant XmlTreeModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid()) return QVariant();
+    const Item* current = item(index);
+    if (index.column() == 0) {
+        switch (role) {
+        case Qt::DisplayRole: return QString::fromUtf8(current->node.name());
+        case Qt::ToolTipRole: return QString::fromStdString(ConfigDiff::nodePath(current->node));
+        case Qt::UserRole:
+            // Ключ правила для SettingDelegate; без правила - шлях, який не збігається з жодним ключем
+            if (!isValue(current)) return QVariant();
+            return QString::fromStdString(spec(current) ? current->key : ConfigDiff::nodePath(current->node));
+        default: return QVariant();
+        }
+    }
+
+    // Текст вузла (перший PCDATA/CDATA); вузли-секції значення не мають
+    if (!isValue(current)) return QVariant();
+    switch (role) {
+    case Qt::DisplayRole:
+    case Qt::EditRole:
+        return trimmedText(current->node.child_value());
+    case Qt::FontRole:
+        if (current->pendingEdit) {
+            QFont pendingFont;
+            pendingFont.setItalic(true); // Ще записується у файл
+            return pendingFont;
+        }
+        return QVariant();
+    case Qt::ToolTipRole: {
+        if (!m_editable) return trimmedText(current->node.child_value());
+        const SettingSpec* rule = spec(current);
+        if (!rule) return SettingsTreeModel::valueToolTip(nullptr);
+        const SettingRule settingRule = (rule->type == SettingType::INT || rule->type == SettingType::FLOAT)
+                                            ? SettingRule(rule->type, rule->minValue, rule->maxValue, rule->decimals)
+                                            : SettingRule(rule->type);
+        return SettingsTreeModel::valueToolTip(&settingRule);
+    }
+    default:
+        return QVariant();
+    }
+}
+
+bool XmlTreeModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (role != Qt::EditRole || !(flags(index) & Qt::ItemIsEditable)) return false;
+    Item* current = item(index);
+    const std::string newValue = value.toString().toStdString();
+    std::string oldValue(XmlUtil::trimmed(current->node.child_value()));
+    if (newValue == oldValue) return true;
+
+    std::string error;
+    if (!ConfigEditor::checkNodeValue(current->node, newValue, error)) {
+        emit editRejected(QString::fromStdString(error));
+        return false;
+    }
+    // Шлях - до зміни: для <label> запису він містить саму мітку (entry[LABEL]/label), а файл ще має стару
+    const QString nodePath = QString::fromStdString(ConfigDiff::nodePath(current->node));
+    if (!current->node.text().set(newValue.c_str())) return false;
+
+    const quint64 editId = m_nextEditId++;
+    current->pendingEdit = editId;
+    m_pendingEdits[editId] = PendingEdit{current, oldValue};
+    emit dataChanged(index, index);
+    emit valueEdited(editId, nodePath, QString::fromStdString(oldValue), QString::fromStdString(newValue));
+    return true;
+}
+
+void XmlTreeModel::finishEdit(quint64 editId, bool saved)
+{
+    auto it = m_pendingEdits.find(editId);
+    if (it == m_pendingEdits.end()) return;
+    const PendingEdit edit = std::move(it->second);
+    m_pendingEdits.erase(it);
+    Item* current = edit.item;
+
+    if (current->pendingEdit == editId) {
+        current->pendingEdit = 0;
+        if (!saved) current->node.text().set(edit.oldValue.c_str());
+    } else if (!saved) {
+        // Наступне редагування цього елемента спиралося на незаписане значення: його основа - значення з файлу
+        auto next = m_pendingEdits.end();
+        for (auto other = m_pendingEdits.begin(); other != m_pendingEdits.end(); ++other) {
+            if (other->second.item == current && other->first > editId && (next == m_pendingEdits.end() || other->first < next->first)) next = other;
+        }
+        if (next != m_pendingEdits.end()) next->second.oldValue = edit.oldValue;
+    }
+    emit dataChanged(createIndex(current->row, 0, current), createIndex(current->row, 1, current));
+}
+
+Qt::ItemFlags XmlTreeModel::flags(const QModelIndex &index) const
+{
+    if (!index.isValid()) return Qt::NoItemFlags;
+    Qt::ItemFlags result = Qt::ItemIsEnabled | Qt::ItemIsSelectable;
+    if (m_editable && index.column() == 1) {
+        const Item* current = item(index);
+        const SettingSpec* rule = isValue(current) ? spec(current) : nullptr;
+        if (isValue(current) && (!rule || rule->type != SettingType::NON_EDITABLE)) result |= Qt::ItemIsEditable;
+    }
+    return result;
+}
+
+QVariant XmlTreeModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+    return section == 0 ? QString("Вузол") : QString("Значення");
+}
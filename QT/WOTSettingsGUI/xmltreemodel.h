@@ -0,0 +1,77 @@
+#ifndef XMLTREEMODEL_H
+#define XMLTREEMODEL_H
+
+#include <QAbstractItemModel>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "main.h" // Для SettingSpec і ConfigEditor
+#include "pugixml/pugixml.hpp"
+
+// Дерево всіх елементів розібраного документа для QTreeView (колонки: тег, текст значення).
+// Рядки створюються ліниво: дочірні елементи вузла додаються порціями через fetchMore, коли
+// вузол розгортають або прокручують до кінця, тож розгортання і прокрутка не обходять решту
+// документа. Рядки тримають вузли pugixml, тому документ належить моделі (спільно з власником).
+// У режимі редагування змінюються тексти елементів без дочірніх елементів: значення перевіряється
+// правилом SettingSchema (ConfigEditor::checkNodeValue), якщо воно є, і записується в документ моделі;
+// запис у файл - справа власника (сигнал valueEdited, результат - finishEdit).
+class XmlTreeModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    explicit XmlTreeModel(std::shared_ptr<pugi::xml_document> doc, QObject *parent = nullptr);
+    ~XmlTreeModel() override;
+
+    pugi::xml_node node(const QModelIndex& index) const; // Документ для недійсного індексу
+    void setEditable(bool editable) { m_editable = editable; }
+    // Результат запису редагування editId у файл; невдале повертає попереднє значення елемента
+    void finishEdit(quint64 editId, bool saved);
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &index) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+signals:
+    // Значення вже змінено в документі моделі; nodePath - шлях ConfigDiff::nodePath для запису у файл
+    void valueEdited(quint64 editId, const QString& nodePath, const QString& oldValue, const QString& newValue);
+    void editRejected(const QString& error); // Значення не пройшло перевірку правила
+
+private:
+    struct Item {
+        pugi::xml_node node;
+        Item *parent = nullptr;
+        int row = 0;
+        pugi::xml_node next; // Наступний елемент для fetchMore (порожній - усі дочірні вже додано)
+        std::vector<std::unique_ptr<Item>> children;
+        quint64 pendingEdit = 0; // Останнє ще не записане редагування
+        mutable bool specResolved = false; // Правило шукається при першому зверненні
+        mutable const SettingSpec* spec = nullptr;
+        mutable std::string key;
+    };
+    struct PendingEdit {
+        Item *item = nullptr;
+        std::string oldValue; // Значення у файлі, на яке спирається редагування
+    };
+    Item* item(const QModelIndex& index) const;
+    static bool isValue(const Item* current) { return current->children.empty() && !current->next; }
+    const SettingSpec* spec(const Item* current) const;
+
+    std::shared_ptr<pugi::xml_document> m_doc;
+    std::unique_ptr<Item> m_root; // Вузол документа (не показується)
+    bool m_editable = false;
+    quint64 m_nextEditId = 1;
+    std::unordered_map<quint64, PendingEdit> m_pendingEdits;
+};
+
+#endif // XMLTREEMODEL_H